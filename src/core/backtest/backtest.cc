@@ -0,0 +1,238 @@
+/**
+ * @file backtest.cc
+ * @license This file is licensed under the GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007. You may obtain a copy of this license at https://www.gnu.org/licenses/gpl-3.0.en.html.
+ * @author Tushar Chaurasia (Dark-CodeX)
+ */
+
+#include "./backtest.hh"
+
+namespace core::backtest
+{
+    namespace
+    {
+        void log_trade(trade_log &log, const std::size_t &bar, const strategy::signal &type, const double &price, const double &qty, const double &comm, const double &balance, const double &pnl)
+        {
+            log.bar.emplace_back(bar);
+            log.type.emplace_back(type);
+            log.price.emplace_back(price);
+            log.qty.emplace_back(qty);
+            log.comm.emplace_back(comm);
+            log.balance.emplace_back(balance);
+            log.pnl.emplace_back(pnl);
+        }
+    }
+
+    result run(std::span<const double> closes, std::span<const strategy::signal> signals, const double &initial_capital, const double &allocation_fraction, const double &commission)
+    {
+        if (signals.size() < closes.size())
+            return {};
+
+        result res;
+        res.equity.resize(closes.size());
+
+        double cash = initial_capital;
+        // quantity of shares currently held (start with zero)
+        double position = 0.0;
+        double entry_price = std::numeric_limits<double>::quiet_NaN();
+
+        for (std::size_t i = 0; i < closes.size(); i++)
+        {
+            const double curr_price = closes[i];
+            const double equity = cash + (position * curr_price);
+            res.equity[i] = equity;
+
+            // BUY: only if no open position
+            if (signals[i] == strategy::signal::BUY && position == 0)
+            {
+                double max_amt = equity * allocation_fraction;
+                double qty = curr_price > 0 ? max_amt / curr_price : 0;
+                double cost = qty * curr_price;
+                double comm_cost = cost * commission;
+
+                if (cash >= (cost + comm_cost) && qty > 0)
+                {
+                    cash -= (cost + comm_cost);
+                    position = qty;
+                    entry_price = curr_price;
+                    log_trade(res.trades, i, strategy::signal::BUY, curr_price, qty, comm_cost, cash, std::numeric_limits<double>::quiet_NaN());
+                }
+            }
+            // SELL: only if position > 0
+            else if (signals[i] == strategy::signal::SELL && position > 0)
+            {
+                double revenue = position * curr_price;
+                double comm_cost = revenue * commission;
+                cash += (revenue - comm_cost);
+
+                double pnl = (curr_price - entry_price) * position - comm_cost;
+                log_trade(res.trades, i, strategy::signal::SELL, curr_price, position, comm_cost, cash, pnl);
+
+                position = 0.0;
+                entry_price = std::numeric_limits<double>::quiet_NaN();
+            }
+        }
+
+        return res;
+    }
+
+    namespace
+    {
+        // days per year the Sharpe and Sortino ratios are scaled by
+        constexpr double ANNUAL = 252.0;
+
+        /**
+         * Running sums of bar returns. Returns are shifted by a reference return before they are squared, so the
+         * variance does not cancel out when the mean is large next to the spread.
+         */
+        struct moments
+        {
+            double shift = 0.0;
+            double sum = 0.0, shifted = 0.0, squares = 0.0, downside = 0.0;
+
+            void add(const double &r)
+            {
+                const double d = r - shift;
+                sum += r;
+                shifted += d;
+                squares += d * d;
+                downside += r < 0 ? r * r : 0.0;
+            }
+
+            void remove(const double &r)
+            {
+                const double d = r - shift;
+                sum -= r;
+                shifted -= d;
+                squares -= d * d;
+                downside -= r < 0 ? r * r : 0.0;
+            }
+
+            // annualized sample standard deviation, NaN below two returns
+            double volatility(const std::size_t &count) const
+            {
+                if (count < 2)
+                    return std::numeric_limits<double>::quiet_NaN();
+                const double var = std::max(0.0, (squares - shifted * shifted / count) / (count - 1));
+                return std::sqrt(var * ANNUAL);
+            }
+
+            double sharpe(const std::size_t &count) const
+            {
+                const double sd = volatility(count);
+                return sd != 0 ? sum / count / sd * ANNUAL : 0.0;
+            }
+
+            double sortino(const std::size_t &count) const
+            {
+                const double dd = std::sqrt(std::max(0.0, downside) / count * ANNUAL);
+                return dd != 0 ? sum / count / dd * ANNUAL : 0.0;
+            }
+        };
+
+        double bar_return(std::span<const double> equity, const std::size_t &i)
+        {
+            return equity[i] / equity[i - 1] - 1;
+        }
+    }
+
+    metrics summarize(const result &res)
+    {
+        return summarize(res.equity, res.trades.pnl);
+    }
+
+    metrics summarize(std::span<const double> equity, std::span<const double> pnl)
+    {
+        metrics m;
+        if (equity.empty())
+            return m;
+
+        const double initial = equity.front();
+        m.final_equity = equity.back();
+        m.total_return = (m.final_equity - initial) / initial * 100;
+
+        // bar returns (pandas pct_change), their moments and the running drawdown in one pass
+        const std::size_t count = equity.size() - 1;
+        moments r;
+        r.shift = count ? bar_return(equity, 1) : 0.0;
+        double peak = initial, drawdown = 0.0;
+        std::size_t under = 0;
+        for (std::size_t i = 1; i < equity.size(); i++)
+        {
+            r.add(bar_return(equity, i));
+            under = equity[i] >= peak ? 0 : under + 1;
+            m.max_drawdown_duration = std::max(m.max_drawdown_duration, under);
+            peak = std::max(peak, equity[i]);
+            drawdown = std::min(drawdown, (equity[i] - peak) / peak);
+        }
+        m.max_drawdown = drawdown * 100;
+        // NaN below two returns (one for Sortino), like pandas
+        m.sharpe = r.sharpe(count);
+        m.sortino = r.sortino(count);
+
+        std::size_t wins = 0, closed = 0;
+        double profit = 0.0, loss = 0.0;
+        for (const double &p : pnl)
+        {
+            if (std::isnan(p))
+                continue;
+            closed++;
+            wins += p > 0;
+            profit += p > 0 ? p : 0.0;
+            loss -= p < 0 ? p : 0.0;
+        }
+        m.win_rate = closed ? (double)wins / closed * 100 : 0.0;
+        m.profit_factor = loss != 0 ? profit / loss : profit > 0 ? std::numeric_limits<double>::infinity() : 0.0;
+        return m;
+    }
+
+    curves equity_curves(std::span<const double> equity)
+    {
+        curves c;
+        c.returns.resize(equity.size());
+        c.peak.resize(equity.size());
+        c.drawdown.resize(equity.size());
+        double peak = std::numeric_limits<double>::lowest();
+        for (std::size_t i = 0; i < equity.size(); i++)
+        {
+            c.returns[i] = i ? bar_return(equity, i) : std::numeric_limits<double>::quiet_NaN();
+            peak = std::max(peak, equity[i]);
+            c.peak[i] = peak;
+            c.drawdown[i] = (equity[i] - peak) / peak;
+        }
+        return c;
+    }
+
+    rolling_metrics rolling(std::span<const double> equity, const std::size_t &window)
+    {
+        rolling_metrics out;
+        out.sharpe.assign(equity.size(), std::numeric_limits<double>::quiet_NaN());
+        out.sortino.assign(equity.size(), std::numeric_limits<double>::quiet_NaN());
+        out.volatility.assign(equity.size(), std::numeric_limits<double>::quiet_NaN());
+        if (window < 2 || equity.size() <= window)
+            return out;
+
+        moments r;
+        r.shift = bar_return(equity, 1);
+        for (std::size_t i = 1; i < equity.size(); i++)
+        {
+            r.add(bar_return(equity, i));
+            if (i > window)
+                r.remove(bar_return(equity, i - window));
+            if (i < window)
+                continue;
+            // summed afresh once per window, the rounding of the subtractions does not build up
+            if (i % window == 0)
+            {
+                moments fresh;
+                fresh.shift = r.shift;
+                for (std::size_t j = i - window + 1; j <= i; j++)
+                    fresh.add(bar_return(equity, j));
+                r = fresh;
+            }
+            out.sharpe[i] = r.sharpe(window);
+            out.sortino[i] = r.sortino(window);
+            out.volatility[i] = r.volatility(window);
+        }
+        return out;
+    }
+}
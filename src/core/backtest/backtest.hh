@@ -0,0 +1,136 @@
+/**
+ * @file backtest.hh
+ * @license This file is licensed under the GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007. You may obtain a copy of this license at https://www.gnu.org/licenses/gpl-3.0.en.html.
+ * @author Tushar Chaurasia (Dark-CodeX)
+ */
+
+#ifndef QUANTZ_BACKTEST_HH
+#define QUANTZ_BACKTEST_HH
+
+#include <vector>
+#include <span>
+#include <cmath>
+#include <limits>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+#include "../strategy/strategy.hh"
+
+namespace core::backtest
+{
+    /**
+     * @brief Trade log stored column-wise, one entry per executed order
+     */
+    struct trade_log
+    {
+        std::vector<std::size_t> bar;
+        // signal::BUY or signal::SELL
+        std::vector<strategy::signal> type;
+        std::vector<double> price;
+        std::vector<double> qty;
+        std::vector<double> comm;
+        std::vector<double> balance;
+        // realized profit of a SELL, NaN for a BUY
+        std::vector<double> pnl;
+    };
+
+    struct result
+    {
+        // equity per bar, marked to the close before the bar's signal is acted upon
+        std::vector<double> equity;
+        trade_log trades;
+    };
+
+    /**
+     * @brief Performance figures of a run, the ones `calculate_metrics` reports (unrounded)
+     */
+    struct metrics
+    {
+        // percent
+        double total_return = std::numeric_limits<double>::quiet_NaN();
+        // annualized (252 bars) mean / sample standard deviation of the bar returns, 0 if they are constant
+        double sharpe = std::numeric_limits<double>::quiet_NaN();
+        // annualized mean / downside deviation (root mean square of the negative returns), 0 without losing bars
+        double sortino = std::numeric_limits<double>::quiet_NaN();
+        // percent, <= 0
+        double max_drawdown = std::numeric_limits<double>::quiet_NaN();
+        // longest run of bars spent below an earlier peak
+        std::size_t max_drawdown_duration = 0;
+        // percent of closed trades with a positive PnL, 0 without closed trades
+        double win_rate = 0.0;
+        // gross profit / gross loss of the closed trades, infinite without losing trades, 0 without winning ones
+        double profit_factor = 0.0;
+        double final_equity = std::numeric_limits<double>::quiet_NaN();
+    };
+
+    /**
+     * @brief Per-bar columns of an equity curve, the ones `calculate_metrics` adds to its frame
+     */
+    struct curves
+    {
+        // pct_change, NaN for the first bar
+        std::vector<double> returns;
+        // running maximum
+        std::vector<double> peak;
+        // (equity - peak) / peak, <= 0
+        std::vector<double> drawdown;
+    };
+
+    /**
+     * @brief Risk figures over a trailing window of bar returns, NaN until the window is full
+     */
+    struct rolling_metrics
+    {
+        std::vector<double> sharpe;
+        std::vector<double> sortino;
+        // annualized sample standard deviation
+        std::vector<double> volatility;
+    };
+
+    /**
+     * @brief Runs the long-only Buy/Sell position state machine over every bar
+     *
+     * @param closes Closing prices, orders are filled at the bar's close
+     * @param signals Signal per bar
+     * @param initial_capital Starting cash
+     * @param allocation_fraction Fraction of current equity allocated on each entry (0.1 -> 10%)
+     * @param commission Fraction of trade value taken as commission
+     * @return Equity curve and trade log, empty if `signals` is shorter than `closes`
+     */
+    result run(std::span<const double> closes, std::span<const strategy::signal> signals, const double &initial_capital, const double &allocation_fraction, const double &commission);
+
+    /**
+     * @brief Computes the metrics of a run exactly like `calculate_metrics` in backtest.py
+     *
+     * @param res Result of `run`
+     * @return Metrics, NaN figures for an empty equity curve
+     */
+    metrics summarize(const result &res);
+
+    /**
+     * @brief Computes the metrics of an equity curve and a trade log in one pass over each
+     *
+     * @param equity Equity per bar
+     * @param pnl Realized profit per trade, NaN entries (entries of a position) are skipped
+     * @return Metrics, NaN figures for an empty equity curve
+     */
+    metrics summarize(std::span<const double> equity, std::span<const double> pnl);
+
+    /**
+     * @brief Bar returns, running peak and drawdown of an equity curve, in one pass
+     */
+    curves equity_curves(std::span<const double> equity);
+
+    /**
+     * @brief Sharpe, Sortino and volatility of the last `window` bar returns at every bar, from running sums
+     *
+     * @param equity Equity per bar
+     * @param window Number of returns per window, e.g. 252 for a trailing year of daily bars
+     * @return Columns as long as `equity`, bar i covers the returns of bars i - window + 1 to i; NaN before
+     * bar `window` and everywhere for windows shorter than 2
+     */
+    rolling_metrics rolling(std::span<const double> equity, const std::size_t &window);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,140 @@
+/**
+ * @file unit_test.cc
+ * @license This file is licensed under the GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007. You may obtain a copy of this license at https://www.gnu.org/licenses/gpl-3.0.en.html.
+ * @author Tushar Chaurasia (Dark-CodeX)
+ */
+
+#include <cassert>
+#include <cstdio>
+#include "./backtest.hh"
+
+namespace
+{
+    using namespace core;
+
+    // the pandas passes `calculate_metrics` in backtest.py made before it called into quantzlib: pct_change,
+    // mean and sample std of the returns, cummax drawdown, closed-trade win rate
+    backtest::metrics pandas_metrics(std::span<const double> equity, std::span<const double> pnl)
+    {
+        backtest::metrics m;
+        const double initial = equity.front();
+        m.final_equity = equity.back();
+        m.total_return = (m.final_equity - initial) / initial * 100;
+
+        std::vector<double> returns;
+        for (std::size_t i = 1; i < equity.size(); i++)
+            returns.emplace_back(equity[i] / equity[i - 1] - 1);
+        double mean = 0.0, var = 0.0, downside = 0.0;
+        for (const double &r : returns)
+            mean += r;
+        mean /= (double)returns.size();
+        for (const double &r : returns)
+        {
+            var += (r - mean) * (r - mean);
+            downside += r < 0 ? r * r : 0.0;
+        }
+        const double sd = returns.size() < 2 ? std::numeric_limits<double>::quiet_NaN() : std::sqrt(var / (double)(returns.size() - 1));
+        m.sharpe = sd != 0 ? mean / sd * std::sqrt(252.0) : 0.0;
+        downside = std::sqrt(downside / (double)returns.size());
+        m.sortino = downside != 0 ? mean / downside * std::sqrt(252.0) : 0.0;
+
+        double peak = equity.front(), drawdown = 0.0;
+        std::size_t under = 0;
+        m.max_drawdown_duration = 0;
+        for (const double &e : equity)
+        {
+            peak = std::max(peak, e);
+            drawdown = std::min(drawdown, (e - peak) / peak);
+            under = e < peak ? under + 1 : 0;
+            m.max_drawdown_duration = std::max(m.max_drawdown_duration, under);
+        }
+        m.max_drawdown = drawdown * 100;
+
+        std::size_t wins = 0, closed = 0;
+        double profit = 0.0, loss = 0.0;
+        for (const double &p : pnl)
+        {
+            if (std::isnan(p))
+                continue;
+            closed++;
+            wins += p > 0;
+            (p > 0 ? profit : loss) += std::abs(p);
+        }
+        m.win_rate = closed ? (double)wins / (double)closed * 100 : 0.0;
+        m.profit_factor = loss != 0 ? profit / loss : profit > 0 ? std::numeric_limits<double>::infinity() : 0.0;
+        return m;
+    }
+
+    bool close_to(const double &a, const double &b, const double &tolerance)
+    {
+        return a == b || (std::isnan(a) && std::isnan(b)) || std::abs(a - b) <= tolerance * std::max(1.0, std::abs(b));
+    }
+
+    void same_metrics(const backtest::metrics &got, const backtest::metrics &want)
+    {
+        // the one-pass moments agree with the two-pass ones to a few ulps of the ratios
+        assert(close_to(got.total_return, want.total_return, 1e-12) && close_to(got.final_equity, want.final_equity, 0.0));
+        assert(close_to(got.sharpe, want.sharpe, 1e-12) && close_to(got.sortino, want.sortino, 1e-12));
+        assert(close_to(got.max_drawdown, want.max_drawdown, 1e-12) && got.max_drawdown_duration == want.max_drawdown_duration);
+        assert(close_to(got.win_rate, want.win_rate, 1e-12) && close_to(got.profit_factor, want.profit_factor, 1e-12));
+    }
+}
+
+int main()
+{
+    // a wandering price, entries every 40 bars held for 15
+    const std::size_t len = 3000;
+    std::vector<double> closes(len);
+    std::vector<strategy::signal> signals(len, strategy::signal::NONE);
+    double p = 100.0;
+    for (std::size_t i = 0; i < len; i++)
+    {
+        p *= 1.0 + 0.01 * std::sin(0.37 * (double)i) + 0.002 * std::cos(1.91 * (double)i);
+        closes[i] = p;
+        signals[i] = i % 40 == 3 ? strategy::signal::BUY : i % 40 == 18 ? strategy::signal::SELL
+                                                                         : strategy::signal::NONE;
+    }
+
+    const backtest::result res = backtest::run(closes, signals, 10000.0, 0.5, 0.001);
+    assert(res.equity.size() == len && !res.trades.pnl.empty());
+    // equity marked to the close before the bar's order
+    assert(res.equity.front() == 10000.0);
+    same_metrics(backtest::summarize(res), pandas_metrics(res.equity, res.trades.pnl));
+
+    // a flat curve: zero Sharpe and Sortino, no drawdown, no trades
+    const std::vector<double> flat(100, 5000.0), none;
+    same_metrics(backtest::summarize(flat, none), pandas_metrics(flat, none));
+    // one bar has no returns (NaN Sharpe), two bars one; no bars at all give NaN figures
+    for (const std::size_t &bars : {1, 2})
+        same_metrics(backtest::summarize(std::span<const double>(res.equity).first(bars), none), pandas_metrics(std::span<const double>(res.equity).first(bars), none));
+    assert(std::isnan(backtest::summarize(none, none).sharpe));
+
+    // the chart columns are the pandas pct_change, cummax and drawdown
+    const backtest::curves c = backtest::equity_curves(res.equity);
+    assert(c.returns.size() == len && std::isnan(c.returns[0]));
+    double peak = res.equity[0];
+    for (std::size_t i = 0; i < len; i++)
+    {
+        peak = std::max(peak, res.equity[i]);
+        assert(i == 0 || c.returns[i] == res.equity[i] / res.equity[i - 1] - 1);
+        assert(c.peak[i] == peak && c.drawdown[i] == (res.equity[i] - peak) / peak);
+    }
+
+    // every trailing window is the metrics of its own slice of the curve
+    const std::size_t window = 60;
+    const backtest::rolling_metrics r = backtest::rolling(res.equity, window);
+    assert(r.sharpe.size() == len);
+    for (std::size_t i = 0; i < len; i++)
+    {
+        if (i < window)
+        {
+            assert(std::isnan(r.sharpe[i]) && std::isnan(r.sortino[i]) && std::isnan(r.volatility[i]));
+            continue;
+        }
+        const backtest::metrics m = pandas_metrics(std::span<const double>(res.equity).subspan(i - window, window + 1), none);
+        assert(close_to(r.sharpe[i], m.sharpe, 1e-12) && close_to(r.sortino[i], m.sortino, 1e-12));
+    }
+    printf("backtest metrics match the pandas calculate_metrics\n");
+
+    return 0;
+}
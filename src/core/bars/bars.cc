@@ -0,0 +1,170 @@
+/**
+ * @file bars.cc
+ * @license This file is licensed under the GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007. You may obtain a copy of this license at https://www.gnu.org/licenses/gpl-3.0.en.html.
+ * @author Tushar Chaurasia (Dark-CodeX)
+ */
+
+#include "./bars.hh"
+
+namespace core::bars
+{
+    namespace
+    {
+        // start of the interval holding `time`, rounded down for negative timestamps too
+        std::int64_t interval_start(const std::int64_t &time, const std::int64_t &interval)
+        {
+            if (interval <= 0)
+                return time;
+            std::int64_t q = time / interval;
+            if (time % interval < 0)
+                q--;
+            return q * interval;
+        }
+    }
+
+    bool resolve_rule(std::string_view name, rule &out)
+    {
+        static constexpr std::string_view names[] = {"time", "tick", "volume", "dollar"};
+        for (std::size_t i = 0; i < std::size(names); i++)
+        {
+            if (name == names[i])
+            {
+                out = (rule)i;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void table::reserve(const std::size_t &bars)
+    {
+        time.reserve(bars);
+        open.reserve(bars);
+        high.reserve(bars);
+        low.reserve(bars);
+        close.reserve(bars);
+        volume.reserve(bars);
+        vwap.reserve(bars);
+        ticks.reserve(bars);
+    }
+
+    void table::push(const bar &b)
+    {
+        time.emplace_back(b.time);
+        open.emplace_back(b.open);
+        high.emplace_back(b.high);
+        low.emplace_back(b.low);
+        close.emplace_back(b.close);
+        volume.emplace_back(b.volume);
+        // a bar of zero-size prints has no volume to weight by, its vwap is the close
+        vwap.emplace_back(b.volume != 0 ? b.dollars / b.volume : b.close);
+        ticks.emplace_back(b.ticks);
+    }
+
+    aggregator::aggregator(const rule &by, const double &threshold)
+        : by(by), threshold(threshold), interval(by != rule::TIME || !(threshold >= 1) ? 0 : threshold < 9.2e18 ? (std::int64_t)threshold
+                                                                                                                : std::numeric_limits<std::int64_t>::max()) {}
+
+    bool aggregator::update(const std::int64_t &time, const double &price, const double &size)
+    {
+        if (!std::isfinite(price) || !std::isfinite(size))
+            return false;
+
+        bool closed_before = false;
+        if (by == rule::TIME)
+        {
+            const std::int64_t start = interval_start(time, interval);
+            if (current.ticks != 0 && start > current.time)
+            {
+                close();
+                closed_before = true;
+            }
+            if (current.ticks == 0)
+                current.time = start;
+        }
+        else if (current.ticks == 0)
+            current.time = time;
+
+        if (current.ticks == 0)
+            current.open = current.high = current.low = price;
+        current.high = std::max(current.high, price);
+        current.low = std::min(current.low, price);
+        current.close = price;
+        current.volume += size;
+        current.dollars += price * size;
+        current.ticks++;
+
+        switch (by)
+        {
+        case rule::TICK:
+            if ((double)current.ticks >= threshold)
+                break;
+            return false;
+        case rule::VOLUME:
+            if (current.volume >= threshold)
+                break;
+            return false;
+        case rule::DOLLAR:
+            if (current.dollars >= threshold)
+                break;
+            return false;
+        default:
+            return closed_before;
+        }
+        close();
+        return true;
+    }
+
+    std::size_t aggregator::update(std::span<const std::int64_t> times, std::span<const double> prices, std::span<const double> sizes)
+    {
+        const std::size_t len = std::min({times.size(), prices.size(), sizes.size()});
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < len; i++)
+            count += update(times[i], prices[i], sizes[i]);
+        return count;
+    }
+
+    bool aggregator::flush()
+    {
+        if (current.ticks == 0)
+            return false;
+        close();
+        return true;
+    }
+
+    void aggregator::subscribe(std::function<void(const bar &)> consumer)
+    {
+        consumers.emplace_back(std::move(consumer));
+    }
+
+    table aggregator::take()
+    {
+        table out = std::move(closed);
+        closed = table();
+        return out;
+    }
+
+    void aggregator::close()
+    {
+        // reset first, a consumer that throws must not leave the closed bar open
+        const bar done = current;
+        current = bar();
+        closed.push(done);
+        for (const std::function<void(const bar &)> &consumer : consumers)
+            consumer(done);
+    }
+
+    table aggregate(std::span<const std::int64_t> times, std::span<const double> prices, std::span<const double> sizes, const rule &by, const double &threshold, const bool &flush)
+    {
+        if (times.size() != prices.size() || times.size() != sizes.size())
+            return {};
+
+        aggregator agg(by, threshold);
+        if (by == rule::TICK && threshold >= 1)
+            agg.reserve((std::size_t)(times.size() / threshold) + 1);
+        agg.update(times, prices, sizes);
+        if (flush)
+            agg.flush();
+        return agg.take();
+    }
+}
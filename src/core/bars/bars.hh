@@ -0,0 +1,160 @@
+/**
+ * @file bars.hh
+ * @license This file is licensed under the GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007. You may obtain a copy of this license at https://www.gnu.org/licenses/gpl-3.0.en.html.
+ * @author Tushar Chaurasia (Dark-CodeX)
+ */
+
+#ifndef QUANTZ_BARS_HH
+#define QUANTZ_BARS_HH
+
+#include <vector>
+#include <span>
+#include <string_view>
+#include <functional>
+#include <cmath>
+#include <limits>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+/**
+ * Trade prints (timestamp, price, size) aggregated into OHLCV bars. A bar closes on one of four rules:
+ *
+ *     TIME    the tick falls in a later interval, intervals are aligned to multiples of `threshold`
+ *     TICK    `threshold` ticks were added
+ *     VOLUME  the summed size reached `threshold`
+ *     DOLLAR  the summed price x size reached `threshold`
+ *
+ * A tick is never split, the one that crosses a volume or dollar threshold belongs to the bar it closes.
+ * Closed bars are appended to contiguous columns (what the batch indicators take) and handed to every
+ * subscriber, so the same aggregator serves a whole file at once or a live feed tick by tick.
+ */
+namespace core::bars
+{
+    enum class rule : std::uint8_t
+    {
+        TIME,
+        TICK,
+        VOLUME,
+        DOLLAR
+    };
+
+    /**
+     * @brief Maps a rule name ("time", "tick", "volume", "dollar") to its rule
+     *
+     * @return false for any other name
+     */
+    bool resolve_rule(std::string_view name, rule &out);
+
+    struct bar
+    {
+        // timestamp of the interval start (TIME) or of the first tick, in the unit of the ticks
+        std::int64_t time = 0;
+        double open = 0.0, high = 0.0, low = 0.0, close = 0.0, volume = 0.0;
+        // summed price x size, vwap = dollars / volume
+        double dollars = 0.0;
+        std::size_t ticks = 0;
+    };
+
+    /**
+     * @brief Bars as columns, row i of every column is bar i
+     */
+    struct table
+    {
+        std::vector<std::int64_t> time;
+        std::vector<double> open, high, low, close, volume, vwap;
+        std::vector<std::uint64_t> ticks;
+
+        std::size_t size() const { return time.size(); }
+        void reserve(const std::size_t &bars);
+        void push(const bar &b);
+    };
+
+    class aggregator
+    {
+    public:
+        /**
+         * @brief Empty aggregator
+         *
+         * @param by Rule closing a bar
+         * @param threshold Interval length in timestamp units (TIME), ticks (TICK), size (VOLUME) or
+         * price x size (DOLLAR) per bar; a threshold that is not positive gives one bar per tick (per
+         * timestamp for TIME). TIME intervals are whole units, the fraction is dropped, so one below 1
+         * (e.g. under 1 ns for nanosecond ticks) also gives one bar per timestamp, and NaN does too; one past
+         * the int64 range is capped to it
+         */
+        aggregator(const rule &by, const double &threshold);
+
+        /**
+         * @brief Adds one tick, in time order (a late tick joins the open bar); a tick with a NaN or
+         * infinite price or size is ignored
+         *
+         * @return Whether a bar was closed (before the tick for TIME, by the tick otherwise)
+         */
+        bool update(const std::int64_t &time, const double &price, const double &size);
+
+        /**
+         * @brief Adds many ticks
+         *
+         * @return Number of bars closed
+         */
+        std::size_t update(std::span<const std::int64_t> times, std::span<const double> prices, std::span<const double> sizes);
+
+        /**
+         * @brief Closes the bar in progress, e.g. at the end of a file or a session
+         *
+         * @return false if no tick was added since the last bar
+         */
+        bool flush();
+
+        /**
+         * @brief Calls `consumer` with every bar closed from now on, after it was appended to `bars()`
+         */
+        void subscribe(std::function<void(const bar &)> consumer);
+
+        /**
+         * @brief Reserves room for `bars` closed bars
+         */
+        void reserve(const std::size_t &bars) { closed.reserve(bars); }
+
+        /**
+         * @brief Bar in progress, `ticks` is 0 if there is none
+         */
+        const bar &partial() const { return current; }
+
+        /**
+         * @brief Closed bars, oldest first
+         */
+        const table &bars() const { return closed; }
+
+        /**
+         * @brief Hands the closed bars over and starts a new table, the bar in progress stays
+         */
+        table take();
+
+    private:
+        rule by;
+        double threshold;
+        std::int64_t interval;
+        bar current;
+        table closed;
+        std::vector<std::function<void(const bar &)>> consumers;
+
+        void close();
+    };
+
+    /**
+     * @brief Aggregates a whole tick history
+     *
+     * @param times Timestamps, ascending
+     * @param prices Trade prices
+     * @param sizes Trade sizes
+     * @param by Rule closing a bar
+     * @param threshold See `aggregator`
+     * @param flush Keep the last, incomplete bar
+     * @return Bars, empty if the columns have different lengths
+     */
+    table aggregate(std::span<const std::int64_t> times, std::span<const double> prices, std::span<const double> sizes, const rule &by, const double &threshold, const bool &flush = true);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,82 @@
+/**
+ * @file unit_test.cc
+ * @license This file is licensed under the GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007. You may obtain a copy of this license at https://www.gnu.org/licenses/gpl-3.0.en.html.
+ * @author Tushar Chaurasia (Dark-CodeX)
+ */
+
+#include <cassert>
+#include <cstdio>
+#include "./bars.hh"
+
+int main()
+{
+    using namespace core::bars;
+
+    // nanosecond trade prints a few ms apart, with repeated timestamps and a NaN print
+    std::vector<std::int64_t> times(20000);
+    std::vector<double> prices(times.size()), sizes(times.size());
+    std::int64_t t = 1700000000LL * 1000000000LL;
+    double p = 100.0;
+    for (std::size_t i = 0; i < times.size(); i++)
+    {
+        t += (std::int64_t)(i % 7) * 3000000LL;
+        p *= 1.0 + 0.001 * std::sin(0.37 * (double)i);
+        times[i] = t;
+        prices[i] = p;
+        sizes[i] = (double)(1 + (i * 13) % 50);
+    }
+    prices[777] = std::numeric_limits<double>::quiet_NaN();
+
+    struct
+    {
+        rule by;
+        double threshold;
+    } cases[] = {{rule::TIME, 1e9}, {rule::TIME, 0.5}, {rule::TICK, 100}, {rule::VOLUME, 2500}, {rule::DOLLAR, 250000}, {rule::TICK, 0}};
+
+    // the batch form gives the bars the aggregator closes tick by tick (and hands its subscribers)
+    for (const auto &c : cases)
+    {
+        const table batch = aggregate(times, prices, sizes, c.by, c.threshold);
+
+        aggregator live(c.by, c.threshold);
+        std::vector<bar> handed;
+        live.subscribe([&](const bar &b)
+                       { handed.emplace_back(b); });
+        std::size_t closed = 0;
+        for (std::size_t i = 0; i < times.size(); i++)
+            closed += live.update(times[i], prices[i], sizes[i]);
+        closed += live.flush();
+        const table &incremental = live.bars();
+
+        assert(closed == batch.size() && incremental.size() == batch.size() && handed.size() == batch.size());
+        std::uint64_t ticks = 0;
+        for (std::size_t i = 0; i < batch.size(); i++)
+        {
+            assert(incremental.time[i] == batch.time[i] && handed[i].time == batch.time[i]);
+            assert(incremental.open[i] == batch.open[i] && handed[i].open == batch.open[i]);
+            assert(incremental.high[i] == batch.high[i] && handed[i].high == batch.high[i]);
+            assert(incremental.low[i] == batch.low[i] && handed[i].low == batch.low[i]);
+            assert(incremental.close[i] == batch.close[i] && handed[i].close == batch.close[i]);
+            assert(incremental.volume[i] == batch.volume[i] && handed[i].volume == batch.volume[i]);
+            assert(incremental.vwap[i] == batch.vwap[i]);
+            assert(incremental.ticks[i] == batch.ticks[i] && handed[i].ticks == batch.ticks[i]);
+            ticks += batch.ticks[i];
+        }
+        // every finite print lands in exactly one bar
+        assert(ticks == times.size() - 1);
+    }
+
+    // a TIME interval under one unit is cut to 0: one bar per distinct timestamp
+    const table sub = aggregate(times, prices, sizes, rule::TIME, 0.5);
+    std::size_t distinct = 1;
+    for (std::size_t i = 1; i < times.size(); i++)
+        distinct += times[i] != times[i - 1];
+    assert(sub.size() == distinct);
+    // a NaN interval does the same, one past the int64 range puts every non-negative timestamp in one bar
+    assert(aggregate(times, prices, sizes, rule::TIME, std::numeric_limits<double>::quiet_NaN()).size() == distinct);
+    const table whole = aggregate(times, prices, sizes, rule::TIME, 1e30);
+    assert(whole.size() == 1 && whole.time[0] == 0 && whole.ticks[0] == times.size() - 1);
+    printf("batch and incremental bars match for every rule\n");
+
+    return 0;
+}
@@ -0,0 +1,481 @@
+/**
+ * @file benchmark.cc
+ * @license This file is licensed under the GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007. You may obtain a copy of this license at https://www.gnu.org/licenses/gpl-3.0.en.html.
+ * @author Tushar Chaurasia (Dark-CodeX)
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <random>
+#include <string>
+#include <vector>
+#include <functional>
+
+#include "../indicators/indicators.hh"
+#include "../indicators/scan.hh"
+#include "../simd_math/parallel.hh"
+
+/*
+ * Throughput of every simd_math reduction (on each SIMD level the CPU supports, against a scalar reference),
+ * of the multi-threaded reductions on arrays larger than a slice (against one thread) and of every batch indicator, over column sizes from L1-resident up to `--max-bytes` (default 1 GiB of
+ * doubles). Results go out as JSON (stdout or `--out`), progress to stderr. The largest size needs about
+ * 12x `--max-bytes` of RAM: six double columns, their float32 copies and a 3 x N BollingerBands result.
+ *
+ *   benchmark [--max-bytes N] [--min-time SECONDS] [--out PATH]
+ */
+
+namespace
+{
+    // bars per column: 8 KiB (L1), 64 KiB (L2), 512 KiB, 4 MiB (L3), 32 MiB, 256 MiB, 1 GiB of doubles
+    constexpr std::size_t SIZES[] = {1ul << 10, 1ul << 13, 1ul << 16, 1ul << 19, 1ul << 22, 1ul << 25, 1ul << 27};
+    constexpr std::size_t PERIODS[] = {5, 20, 200};
+
+    volatile double sink;
+
+    struct options
+    {
+        std::size_t max_bytes = 1ul << 30;
+        double min_time = 0.2;
+        const char *out = nullptr;
+    };
+
+    struct columns
+    {
+        std::vector<double> prices, highs, lows, volumes, returns, returns2;
+        std::vector<float> pricesf, highsf, lowsf, volumesf, returnsf, returns2f;
+    };
+
+    // random walk OHLCV and gross returns near 1, so products stay finite for a while
+    columns generate(const std::size_t &len)
+    {
+        columns c;
+        std::mt19937_64 rng(42);
+        std::normal_distribution<double> noise(0.0, 1.0);
+        c.prices.resize(len);
+        c.highs.resize(len);
+        c.lows.resize(len);
+        c.volumes.resize(len);
+        c.returns.resize(len);
+        c.returns2.resize(len);
+        double price = 100.0;
+        for (std::size_t i = 0; i < len; i++)
+        {
+            price = std::max(1.0, price + noise(rng));
+            c.prices[i] = price;
+            c.highs[i] = price + std::abs(noise(rng));
+            c.lows[i] = price - std::abs(noise(rng));
+            c.volumes[i] = 1000.0 + (rng() % 1000);
+            c.returns[i] = 1.0 + 1e-3 * noise(rng);
+            c.returns2[i] = 1.0 + 1e-3 * noise(rng);
+        }
+        c.pricesf.assign(c.prices.begin(), c.prices.end());
+        c.highsf.assign(c.highs.begin(), c.highs.end());
+        c.lowsf.assign(c.lows.begin(), c.lows.end());
+        c.volumesf.assign(c.volumes.begin(), c.volumes.end());
+        c.returnsf.assign(c.returns.begin(), c.returns.end());
+        c.returns2f.assign(c.returns2.begin(), c.returns2.end());
+        return c;
+    }
+
+    // fastest of the runs, repeated until `min_time` has been spent (at least once)
+    double best_seconds(const std::function<void()> &run, const double &min_time)
+    {
+        double best = std::numeric_limits<double>::infinity(), total = 0.0;
+        for (std::size_t reps = 0; reps == 0 || total < min_time; reps++)
+        {
+            auto start = std::chrono::steady_clock::now();
+            run();
+            double took = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            best = std::min(best, took);
+            total += took;
+        }
+        return best;
+    }
+
+    // scalar references, kept out of the auto-vectorizer so they measure one lane
+    template <typename T>
+    __attribute__((optimize("no-tree-vectorize"))) double scalar_sum(const T *vec, const std::size_t len)
+    {
+        double sum = 0.0;
+        for (std::size_t i = 0; i < len; i++)
+            sum += vec[i];
+        return sum;
+    }
+
+    template <typename T>
+    double scalar_mean(const T *vec, const std::size_t len)
+    {
+        return scalar_sum(vec, len) / len;
+    }
+
+    template <typename T>
+    __attribute__((optimize("no-tree-vectorize"))) double scalar_multiply(const T *vec, const std::size_t len)
+    {
+        double prod = 1.0;
+        for (std::size_t i = 0; i < len; i++)
+            prod *= vec[i];
+        return prod;
+    }
+
+    template <typename T>
+    __attribute__((optimize("no-tree-vectorize"))) double scalar_variance(const T *vec, const std::size_t len)
+    {
+        double sum = 0.0, sqsum = 0.0;
+        for (std::size_t i = 0; i < len; i++)
+        {
+            sum += vec[i];
+            sqsum += (double)vec[i] * vec[i];
+        }
+        double mean = sum / len;
+        return sqsum / len - mean * mean;
+    }
+
+    template <typename T>
+    double scalar_std_deviation(const T *vec, const std::size_t len)
+    {
+        return std::sqrt(scalar_variance(vec, len));
+    }
+
+    template <typename T>
+    __attribute__((optimize("no-tree-vectorize"))) double scalar_dot_product(const T *vec1, const T *vec2, const std::size_t len)
+    {
+        double sum = 0.0;
+        for (std::size_t i = 0; i < len; i++)
+            sum += (double)vec1[i] * vec2[i];
+        return sum;
+    }
+
+    double relative_error(const double &a, const double &b)
+    {
+        if (a == b)
+            return 0.0;
+        return std::abs(a - b) / std::max(std::abs(a), std::abs(b));
+    }
+
+    struct reduction
+    {
+        const char *name;
+        // element arrays read per call
+        std::size_t inputs;
+        std::function<double(const columns &, std::size_t)> simd, scalar;
+    };
+
+    std::vector<reduction> reductions(const bool &f32)
+    {
+        if (f32)
+            return {
+                {"vector_sum", 1, [](const columns &c, std::size_t n)
+                 { return vector_sumf(c.returnsf.data(), n); }, [](const columns &c, std::size_t n)
+                 { return scalar_sum(c.returnsf.data(), n); }},
+                {"vector_mean", 1, [](const columns &c, std::size_t n)
+                 { return vector_meanf(c.returnsf.data(), n); }, [](const columns &c, std::size_t n)
+                 { return scalar_mean(c.returnsf.data(), n); }},
+                {"vector_multiply", 1, [](const columns &c, std::size_t n)
+                 { return vector_multiplyf(c.returnsf.data(), n); }, [](const columns &c, std::size_t n)
+                 { return scalar_multiply(c.returnsf.data(), n); }},
+                {"vector_variance", 1, [](const columns &c, std::size_t n)
+                 { return vector_variancef(c.returnsf.data(), n); }, [](const columns &c, std::size_t n)
+                 { return scalar_variance(c.returnsf.data(), n); }},
+                {"vector_std_deviation", 1, [](const columns &c, std::size_t n)
+                 { return vector_std_deviationf(c.returnsf.data(), n); }, [](const columns &c, std::size_t n)
+                 { return scalar_std_deviation(c.returnsf.data(), n); }},
+                {"vector_dot_product", 2, [](const columns &c, std::size_t n)
+                 { return vector_dot_productf(c.returnsf.data(), c.returns2f.data(), n); }, [](const columns &c, std::size_t n)
+                 { return scalar_dot_product(c.returnsf.data(), c.returns2f.data(), n); }},
+            };
+        return {
+            {"vector_sum", 1, [](const columns &c, std::size_t n)
+             { return vector_sum(c.returns.data(), n); }, [](const columns &c, std::size_t n)
+             { return scalar_sum(c.returns.data(), n); }},
+            {"vector_mean", 1, [](const columns &c, std::size_t n)
+             { return vector_mean(c.returns.data(), n); }, [](const columns &c, std::size_t n)
+             { return scalar_mean(c.returns.data(), n); }},
+            {"vector_multiply", 1, [](const columns &c, std::size_t n)
+             { return vector_multiply(c.returns.data(), n); }, [](const columns &c, std::size_t n)
+             { return scalar_multiply(c.returns.data(), n); }},
+            {"vector_variance", 1, [](const columns &c, std::size_t n)
+             { return vector_variance(c.returns.data(), n); }, [](const columns &c, std::size_t n)
+             { return scalar_variance(c.returns.data(), n); }},
+            {"vector_std_deviation", 1, [](const columns &c, std::size_t n)
+             { return vector_std_deviation(c.returns.data(), n); }, [](const columns &c, std::size_t n)
+             { return scalar_std_deviation(c.returns.data(), n); }},
+            {"vector_dot_product", 2, [](const columns &c, std::size_t n)
+             { return vector_dot_product(c.returns.data(), c.returns2.data(), n); }, [](const columns &c, std::size_t n)
+             { return scalar_dot_product(c.returns.data(), c.returns2.data(), n); }},
+        };
+    }
+
+    struct parallel_reduction
+    {
+        const char *name;
+        std::size_t inputs;
+        std::function<double(const columns &, std::size_t, std::size_t)> run;
+    };
+
+    std::vector<parallel_reduction> parallel_reductions()
+    {
+        namespace parallel = core::simd_math::parallel;
+        auto returns = [](const columns &c, std::size_t n)
+        { return std::span<const double>(c.returns.data(), n); };
+        return {
+            {"vector_sum", 1, [=](const columns &c, std::size_t n, std::size_t threads)
+             { return parallel::sum(returns(c, n), threads); }},
+            {"vector_multiply", 1, [=](const columns &c, std::size_t n, std::size_t threads)
+             { return parallel::multiply(returns(c, n), threads); }},
+            {"vector_variance", 1, [=](const columns &c, std::size_t n, std::size_t threads)
+             { return parallel::variance(returns(c, n), threads); }},
+            {"vector_dot_product", 2, [=](const columns &c, std::size_t n, std::size_t threads)
+             { return parallel::dot_product(returns(c, n), std::span<const double>(c.returns2.data(), n), threads); }},
+        };
+    }
+
+    struct indicator
+    {
+        const char *name;
+        // element arrays read, and elements written per bar
+        std::size_t inputs, outputs;
+        std::function<std::size_t(const columns &, std::size_t, std::size_t)> run;
+    };
+
+    // every batch indicator, returning the result size so nothing is optimized away
+    template <typename T>
+    std::vector<indicator> indicators()
+    {
+        using namespace core::indicators;
+        constexpr bool f32 = std::is_same_v<T, float>;
+        auto col = [](const std::vector<double> &d, const std::vector<float> &f, std::size_t n)
+        {
+            if constexpr (f32)
+                return std::span<const float>(f.data(), n);
+            else
+                return std::span<const double>(d.data(), n);
+        };
+        std::vector<indicator> all = {
+            {"SMA", 1, 1, [col](const columns &c, std::size_t n, std::size_t p)
+             { return SMA(col(c.prices, c.pricesf, n), p).size(); }},
+            {"EMA", 1, 1, [col](const columns &c, std::size_t n, std::size_t p)
+             { return EMA(col(c.prices, c.pricesf, n), p).size(); }},
+            {"WMA", 1, 1, [col](const columns &c, std::size_t n, std::size_t p)
+             { return WMA(col(c.prices, c.pricesf, n), "linear", p).size(); }},
+            {"VWMA", 2, 1, [col](const columns &c, std::size_t n, std::size_t p)
+             { return VWMA(col(c.prices, c.pricesf, n), col(c.volumes, c.volumesf, n), p).size(); }},
+            // slow period twice the fast one
+            {"MACD", 1, 1, [col](const columns &c, std::size_t n, std::size_t p)
+             { return MACD(col(c.prices, c.pricesf, n), p, 2 * p).size(); }},
+            {"RSI", 1, 1, [col](const columns &c, std::size_t n, std::size_t p)
+             { return RSI(col(c.prices, c.pricesf, n), p).size(); }},
+            // blocked parallel scans on every worker of the shared pool
+            {"EMA_scan", 1, 1, [col](const columns &c, std::size_t n, std::size_t p)
+             { return scan::EMA(col(c.prices, c.pricesf, n), p, 0).size(); }},
+            {"RSI_scan", 1, 1, [col](const columns &c, std::size_t n, std::size_t p)
+             { return scan::RSI(col(c.prices, c.pricesf, n), p, 0).size(); }},
+            {"BollingerBands", 1, 3, [col](const columns &c, std::size_t n, std::size_t p)
+             { return BollingerBands(col(c.prices, c.pricesf, n), p, 2.0).size(); }},
+            {"ATR", 3, 1, [col](const columns &c, std::size_t n, std::size_t p)
+             { return ATR(col(c.highs, c.highsf, n), col(c.lows, c.lowsf, n), col(c.prices, c.pricesf, n), p).size(); }},
+            {"Momentum", 1, 1, [col](const columns &c, std::size_t n, std::size_t p)
+             { return Momentum(col(c.prices, c.pricesf, n), p).size(); }},
+            {"Donchian", 2, 3, [col](const columns &c, std::size_t n, std::size_t p)
+             { return Donchian(col(c.highs, c.highsf, n), col(c.lows, c.lowsf, n), p).size(); }},
+            {"Stochastic", 3, 2, [col](const columns &c, std::size_t n, std::size_t p)
+             { return Stochastic(col(c.highs, c.highsf, n), col(c.lows, c.lowsf, n), col(c.prices, c.pricesf, n), p, 3).size(); }},
+            {"WilliamsR", 3, 1, [col](const columns &c, std::size_t n, std::size_t p)
+             { return WilliamsR(col(c.highs, c.highsf, n), col(c.lows, c.lowsf, n), col(c.prices, c.pricesf, n), p).size(); }},
+            {"Aroon", 2, 2, [col](const columns &c, std::size_t n, std::size_t p)
+             { return Aroon(col(c.highs, c.highsf, n), col(c.lows, c.lowsf, n), p).size(); }},
+        };
+        if constexpr (!f32)
+        {
+            // one row per swept period, PERIODS[0] .. the benchmarked period
+            auto sweep = [](std::size_t p)
+            {
+                std::vector<std::size_t> periods;
+                for (std::size_t q : PERIODS)
+                {
+                    if (q <= p)
+                        periods.emplace_back(q);
+                }
+                return periods;
+            };
+            all.push_back({"SMA_multi", 1, 0, [sweep](const columns &c, std::size_t n, std::size_t p)
+                           { return SMA_multi(std::span<const double>(c.prices.data(), n), sweep(p)).size(); }});
+            all.push_back({"EMA_multi", 1, 0, [sweep](const columns &c, std::size_t n, std::size_t p)
+                           { return EMA_multi(std::span<const double>(c.prices.data(), n), sweep(p)).size(); }});
+            all.push_back({"RSI_multi", 1, 0, [sweep](const columns &c, std::size_t n, std::size_t p)
+                           { return RSI_multi(std::span<const double>(c.prices.data(), n), sweep(p)).size(); }});
+        }
+        return all;
+    }
+
+    bool parse(int argc, char **argv, options &opts)
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            if (std::strcmp(argv[i], "--max-bytes") == 0 && i + 1 < argc)
+                opts.max_bytes = std::strtoull(argv[++i], nullptr, 10);
+            else if (std::strcmp(argv[i], "--min-time") == 0 && i + 1 < argc)
+                opts.min_time = std::strtod(argv[++i], nullptr);
+            else if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc)
+                opts.out = argv[++i];
+            else
+                return false;
+        }
+        return true;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    options opts;
+    if (!parse(argc, argv, opts))
+    {
+        std::fprintf(stderr, "usage: %s [--max-bytes N] [--min-time SECONDS] [--out PATH]\n", argv[0]);
+        return 1;
+    }
+
+    std::size_t largest = 0;
+    for (std::size_t len : SIZES)
+    {
+        if (len * sizeof(double) <= opts.max_bytes)
+            largest = len;
+    }
+    if (largest == 0)
+    {
+        std::fprintf(stderr, "--max-bytes is below the smallest size (%zu bytes)\n", SIZES[0] * sizeof(double));
+        return 1;
+    }
+
+    std::fprintf(stderr, "generating %zu bars\n", largest);
+    const columns data = generate(largest);
+
+    const char *widest = simd_mode();
+    std::vector<int> modes;
+    for (int bits : {512, 256, 128})
+    {
+        if (simd_select(bits) == 0)
+            modes.emplace_back(bits);
+    }
+
+    std::string json = "{\n  \"simd_mode\": \"" + std::string(widest) + "\",\n  \"supported_modes\": [";
+    for (std::size_t m = 0; m < modes.size(); m++)
+        json += (m ? ", \"" : "\"") + std::to_string(modes[m]) + "\"";
+    json += "],\n  \"timestamp\": " + std::to_string((long long)std::time(nullptr)) + ",\n  \"compiler\": \"" __VERSION__ "\",\n";
+    json += "  \"min_time\": " + std::to_string(opts.min_time) + ",\n  \"reductions\": [";
+
+    char line[512];
+    bool first = true;
+    for (const int &bits : modes)
+    {
+        simd_select(bits);
+        for (bool f32 : {false, true})
+        {
+            const std::size_t width = f32 ? sizeof(float) : sizeof(double);
+            for (const reduction &r : reductions(f32))
+            {
+                for (std::size_t len : SIZES)
+                {
+                    if (len > largest)
+                        break;
+                    double simd_value = 0.0, scalar_value = 0.0;
+                    double simd = best_seconds([&]
+                                               { sink = simd_value = r.simd(data, len); }, opts.min_time);
+                    double scalar = best_seconds([&]
+                                                 { sink = scalar_value = r.scalar(data, len); }, opts.min_time);
+                    const double bytes = (double)r.inputs * len * width;
+                    std::snprintf(line, sizeof(line),
+                                  "%s\n    {\"function\": \"%s\", \"dtype\": \"%s\", \"mode\": \"%s\", \"elements\": %zu, \"bytes\": %.0f, "
+                                  "\"ns_per_element\": %.4f, \"gb_per_s\": %.3f, \"scalar_ns_per_element\": %.4f, \"speedup\": %.3f, \"relative_error\": %.3e}",
+                                  first ? "" : ",", r.name, f32 ? "float32" : "float64", simd_mode(), len, bytes,
+                                  simd * 1e9 / len, bytes / simd / 1e9, scalar * 1e9 / len, scalar / simd, relative_error(simd_value, scalar_value));
+                    json += line;
+                    first = false;
+                    std::fprintf(stderr, "%-22s %s %s-bit %10zu: %8.4f ns/elem %8.3f GB/s (scalar %.4f ns/elem)\n",
+                                 r.name, f32 ? "f32" : "f64", simd_mode(), len, simd * 1e9 / len, bytes / simd / 1e9, scalar * 1e9 / len);
+                }
+            }
+        }
+    }
+
+    // the multi-threaded reductions and the indicators run on the widest kernels, like the library does
+    simd_select(std::atoi(widest));
+    const std::size_t threads = core::thread_pool::shared().size() + 1;
+    json += "\n  ],\n  \"parallel_reductions\": [";
+    first = true;
+    for (const parallel_reduction &r : parallel_reductions())
+    {
+        for (std::size_t len : SIZES)
+        {
+            if (len > largest)
+                break;
+            if (len <= SIMD_SLICE)
+                continue;
+            double single = best_seconds([&]
+                                         { sink = r.run(data, len, 1); }, opts.min_time);
+            double multi = best_seconds([&]
+                                        { sink = r.run(data, len, threads); }, opts.min_time);
+            const double bytes = (double)r.inputs * len * sizeof(double);
+            std::snprintf(line, sizeof(line),
+                          "%s\n    {\"function\": \"%s\", \"dtype\": \"float64\", \"mode\": \"%s\", \"threads\": %zu, \"elements\": %zu, \"bytes\": %.0f, "
+                          "\"ns_per_element\": %.4f, \"gb_per_s\": %.3f, \"single_gb_per_s\": %.3f, \"speedup\": %.3f}",
+                          first ? "" : ",", r.name, simd_mode(), threads, len, bytes,
+                          multi * 1e9 / len, bytes / multi / 1e9, bytes / single / 1e9, single / multi);
+            json += line;
+            first = false;
+            std::fprintf(stderr, "%-22s f64 %zu threads %10zu: %8.3f GB/s (one thread %.3f GB/s)\n",
+                         r.name, threads, len, bytes / multi / 1e9, bytes / single / 1e9);
+        }
+    }
+
+    json += "\n  ],\n  \"indicators\": [";
+    first = true;
+    auto bench_indicators = [&](const std::vector<indicator> &all, const bool &f32)
+    {
+        const std::size_t width = f32 ? sizeof(float) : sizeof(double);
+        for (const indicator &ind : all)
+        {
+            for (std::size_t period : PERIODS)
+            {
+                for (std::size_t len : SIZES)
+                {
+                    if (len > largest)
+                        break;
+                    std::size_t written = 0;
+                    double took = best_seconds([&]
+                                               { written = ind.run(data, len, period); }, opts.min_time);
+                    // sweeps write one row per period, taken from the result size
+                    const double bytes = ((double)ind.inputs * len + (ind.outputs ? ind.outputs * len : written)) * width;
+                    std::snprintf(line, sizeof(line),
+                                  "%s\n    {\"function\": \"%s\", \"dtype\": \"%s\", \"mode\": \"%s\", \"period\": %zu, \"elements\": %zu, \"bytes\": %.0f, "
+                                  "\"ns_per_element\": %.4f, \"gb_per_s\": %.3f}",
+                                  first ? "" : ",", ind.name, f32 ? "float32" : "float64", simd_mode(), period, len, bytes,
+                                  took * 1e9 / len, bytes / took / 1e9);
+                    json += line;
+                    first = false;
+                    std::fprintf(stderr, "%-15s %s n=%-4zu %10zu: %8.4f ns/elem %8.3f GB/s\n",
+                                 ind.name, f32 ? "f32" : "f64", period, len, took * 1e9 / len, bytes / took / 1e9);
+                }
+            }
+        }
+    };
+    bench_indicators(indicators<double>(), false);
+    bench_indicators(indicators<float>(), true);
+    json += "\n  ]\n}\n";
+
+    if (!opts.out)
+    {
+        std::fputs(json.c_str(), stdout);
+        return 0;
+    }
+    FILE *file = std::fopen(opts.out, "w");
+    if (!file)
+    {
+        std::fprintf(stderr, "cannot write %s\n", opts.out);
+        return 1;
+    }
+    std::fputs(json.c_str(), file);
+    std::fclose(file);
+    return 0;
+}
@@ -0,0 +1,289 @@
+/**
+ * @file cache.cc
+ * @license This file is licensed under the GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007. You may obtain a copy of this license at https://www.gnu.org/licenses/gpl-3.0.en.html.
+ * @author Tushar Chaurasia (Dark-CodeX)
+ */
+
+#include "./cache.hh"
+
+namespace core::indicators
+{
+    result_cache::result_cache(const std::size_t &budget) : budget(budget) {}
+
+    std::shared_ptr<const std::vector<double>> result_cache::get(const std::string &dataset, const std::uint64_t &version, const universe::spec &sp, const std::string &source, const universe::series &data)
+    {
+        const key k{dataset, sp.indicator, sp.n, sp.slow, std::bit_cast<std::uint64_t>(sp.k), sp.weights, source};
+        const std::size_t rows = data.prices.size();
+
+        std::unique_lock<std::mutex> guard(lock);
+        for (auto running = pending.find(k); running != pending.end(); running = pending.find(k))
+        {
+            // the key is being computed or extended, its result is waited for without the lock
+            const bool same = running->second.version == version && running->second.rows == rows;
+            const std::shared_future<std::shared_ptr<const std::vector<double>>> result = running->second.result;
+            guard.unlock();
+            result.wait();
+            if (same)
+            {
+                std::shared_ptr<const std::vector<double>> res = result.get();
+                guard.lock();
+                counters.hits++;
+                return res;
+            }
+            guard.lock();
+        }
+
+        entry work;
+        bool extending = false;
+        auto it = index.find(k);
+        if (it != index.end())
+        {
+            entry &e = *it->second;
+            if (e.version == version && e.rows == rows)
+            {
+                counters.hits++;
+                lru.splice(lru.begin(), lru, it->second);
+                return e.values;
+            }
+            // taken out of the cache: it is extended without the lock, or it holds another version of the data
+            // and can never be used again
+            extending = e.version != version && rows >= e.rows && !e.values->empty() && descends(dataset, version, e.version);
+            if (extending)
+                work = std::move(e);
+            used -= e.bytes;
+            lru.erase(it->second);
+            index.erase(it);
+        }
+
+        std::promise<std::shared_ptr<const std::vector<double>>> done;
+        pending.emplace(k, flight{version, rows, done.get_future().share()});
+        guard.unlock();
+
+        bool extended = false;
+        try
+        {
+            extended = extending && extend(work, sp, data);
+            if (extended)
+                work.version = version;
+            else
+                work = entry{k, version, rows, std::make_shared<std::vector<double>>(universe::compute(data, sp)), std::monostate{}, 0};
+        }
+        catch (...)
+        {
+            guard.lock();
+            pending.erase(k);
+            done.set_exception(std::current_exception());
+            throw;
+        }
+
+        guard.lock();
+        pending.erase(k);
+        if (extended)
+            counters.extensions++;
+        else
+            counters.misses++;
+        // the caller keeps the result even if it alone is over the budget
+        std::shared_ptr<const std::vector<double>> res = work.values;
+        lru.push_front(std::move(work));
+        index[k] = lru.begin();
+        account(lru.front());
+        evict();
+        done.set_value(res);
+        return res;
+    }
+
+    void result_cache::appended(const std::string &dataset, const std::uint64_t &from, const std::uint64_t &to)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if (from != to)
+            parents[{dataset, to}] = from;
+    }
+
+    void result_cache::set_budget(const std::size_t &budget)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        this->budget = budget;
+        evict();
+    }
+
+    void result_cache::clear()
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        lru.clear();
+        index.clear();
+        parents.clear();
+        used = 0;
+    }
+
+    result_cache::stats result_cache::statistics() const
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stats s = counters;
+        s.entries = lru.size();
+        s.bytes = used;
+        return s;
+    }
+
+    bool result_cache::descends(const std::string &dataset, std::uint64_t version, const std::uint64_t &ancestor) const
+    {
+        // bounded, a cycle in the declared history cannot hang the lookup
+        for (std::size_t steps = 0; steps <= parents.size(); steps++)
+        {
+            auto it = parents.find({dataset, version});
+            if (it == parents.end())
+                return false;
+            version = it->second;
+            if (version == ancestor)
+                return true;
+        }
+        return false;
+    }
+
+    bool result_cache::extend(entry &e, const universe::spec &sp, const universe::series &data) const
+    {
+        const std::size_t rows = data.prices.size();
+        if (sp.indicator == universe::kind::VWMA && data.volumes.size() < rows)
+            return false;
+        const bool ranges = sp.indicator == universe::kind::ATR || sp.indicator == universe::kind::DONCHIAN || sp.indicator == universe::kind::STOCHASTIC ||
+                            sp.indicator == universe::kind::WILLIAMS_R || sp.indicator == universe::kind::AROON;
+        if (ranges && (data.highs.size() < rows || data.lows.size() < rows))
+            return false;
+
+        const bool created = std::holds_alternative<std::monostate>(e.live);
+        if (created)
+        {
+            switch (sp.indicator)
+            {
+            case universe::kind::SMA:
+                e.live.emplace<stream::SMA>(sp.n);
+                break;
+            case universe::kind::EMA:
+                e.live.emplace<stream::EMA>(sp.n);
+                break;
+            case universe::kind::MACD:
+                e.live.emplace<stream::MACD>(sp.n, sp.slow);
+                break;
+            case universe::kind::RSI:
+                e.live.emplace<stream::RSI>(sp.n);
+                break;
+            case universe::kind::BOLLINGER_BANDS:
+                e.live.emplace<stream::BollingerBands>(sp.n, sp.k);
+                break;
+            case universe::kind::VWMA:
+                e.live.emplace<stream::VWMA>(sp.n);
+                break;
+            case universe::kind::ATR:
+                e.live.emplace<stream::ATR>(sp.n);
+                break;
+            case universe::kind::MOMENTUM:
+                e.live.emplace<stream::Momentum>(sp.n);
+                break;
+            case universe::kind::DONCHIAN:
+                e.live.emplace<stream::Donchian>(sp.n);
+                break;
+            case universe::kind::STOCHASTIC:
+                e.live.emplace<stream::Stochastic>(sp.n, sp.slow);
+                break;
+            case universe::kind::WILLIAMS_R:
+                e.live.emplace<stream::WilliamsR>(sp.n);
+                break;
+            case universe::kind::AROON:
+                e.live.emplace<stream::Aroon>(sp.n);
+                break;
+            default:
+                // no streaming form (WMA), recomputed instead
+                return false;
+            }
+        }
+
+        // feeds bars [from, to) to the streaming indicator, `emit` sees it after each one
+        auto feed = [&](auto &ind, const std::size_t &from, const std::size_t &to, auto emit)
+        {
+            using T = std::decay_t<decltype(ind)>;
+            for (std::size_t i = from; i < to; i++)
+            {
+                if constexpr (std::is_same_v<T, stream::VWMA>)
+                    ind.update(data.prices[i], data.volumes[i]);
+                else if constexpr (std::is_same_v<T, stream::ATR> || std::is_same_v<T, stream::Stochastic> || std::is_same_v<T, stream::WilliamsR>)
+                    ind.update(data.highs[i], data.lows[i], data.prices[i]);
+                else if constexpr (std::is_same_v<T, stream::Donchian> || std::is_same_v<T, stream::Aroon>)
+                    ind.update(data.highs[i], data.lows[i]);
+                else
+                    ind.update(data.prices[i]);
+                emit(ind);
+            }
+        };
+
+        // a new streaming indicator first replays the cached bars once
+        if (created)
+        {
+            std::visit([&](auto &ind)
+                       {
+                           using T = std::decay_t<decltype(ind)>;
+                           if constexpr (!std::is_same_v<T, std::monostate>)
+                               feed(ind, 0, e.rows, [](const T &) {}); },
+                       e.live);
+        }
+
+        std::visit([&](auto &ind)
+                   {
+                       using T = std::decay_t<decltype(ind)>;
+                       // rows of the result, as `universe::rows`
+                       constexpr std::size_t R = std::is_same_v<T, stream::BollingerBands> || std::is_same_v<T, stream::Donchian> ? 3
+                                                 : std::is_same_v<T, stream::Stochastic> || std::is_same_v<T, stream::Aroon> ? 2 : 1;
+                       if constexpr (R > 1)
+                       {
+                           // R x N rows shift with N, so the rows are rebuilt
+                           auto next = std::make_shared<std::vector<double>>(R * rows);
+                           for (std::size_t r = 0; r < R; r++)
+                               std::copy_n(e.values->data() + r * e.rows, e.rows, next->data() + r * rows);
+                           std::size_t i = e.rows;
+                           feed(ind, e.rows, rows, [&](const T &s)
+                                {
+                                    (*next)[i] = s.value();
+                                    if constexpr (std::is_same_v<T, stream::Stochastic>)
+                                        (*next)[rows + i] = s.d();
+                                    else if constexpr (std::is_same_v<T, stream::Aroon>)
+                                        (*next)[rows + i] = s.down();
+                                    else
+                                    {
+                                        (*next)[rows + i] = s.upper();
+                                        (*next)[2 * rows + i] = s.lower();
+                                    }
+                                    i++; });
+                           e.values = std::move(next);
+                       }
+                       else if constexpr (!std::is_same_v<T, std::monostate>)
+                       {
+                           // appended in place unless a caller still holds the current vector
+                           if (e.values.use_count() > 1)
+                               e.values = std::make_shared<std::vector<double>>(*e.values);
+                           feed(ind, e.rows, rows, [&](const T &s)
+                                { e.values->push_back(s.value()); });
+                       } },
+                   e.live);
+        e.rows = rows;
+        return true;
+    }
+
+    void result_cache::account(entry &e)
+    {
+        used -= e.bytes;
+        // the series plus the streaming windows (at most a few copies of the period)
+        e.bytes = sizeof(entry) + e.values->capacity() * sizeof(double);
+        if (!std::holds_alternative<std::monostate>(e.live))
+            e.bytes += 4 * (MAX_2(std::get<2>(e.k), std::get<3>(e.k)) + 1) * sizeof(double);
+        used += e.bytes;
+    }
+
+    void result_cache::evict()
+    {
+        while (used > budget && !lru.empty())
+        {
+            used -= lru.back().bytes;
+            index.erase(lru.back().k);
+            lru.pop_back();
+            counters.evictions++;
+        }
+    }
+}
@@ -0,0 +1,121 @@
+/**
+ * @file cache.hh
+ * @license This file is licensed under the GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007. You may obtain a copy of this license at https://www.gnu.org/licenses/gpl-3.0.en.html.
+ * @author Tushar Chaurasia (Dark-CodeX)
+ */
+
+#ifndef QUANTZ_INDICATOR_CACHE_HH
+#define QUANTZ_INDICATOR_CACHE_HH
+
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <future>
+#include <tuple>
+#include <variant>
+#include <optional>
+#include <bit>
+
+#include "./universe.hh"
+#include "./stream.hh"
+
+namespace core::indicators
+{
+    /**
+     * @brief Indicator results keyed by (dataset, version, indicator, parameters, source column)
+     *
+     * Entries are evicted least recently used first once their size exceeds the memory budget. When a
+     * dataset is declared to have only grown (`appended`), a cached series is extended with the streaming
+     * indicators over the new bars instead of being recomputed; the streaming and batch indicators are
+     * bit-identical, so an extended series equals a fresh computation. The cache is looked up under a lock,
+     * the computation or extension of a series runs outside it; concurrent lookups of a key being computed wait
+     * for that one computation.
+     */
+    class result_cache
+    {
+    public:
+        struct stats
+        {
+            std::size_t hits = 0;
+            std::size_t misses = 0;
+            // lookups served by extending an older version over the appended bars
+            std::size_t extensions = 0;
+            std::size_t evictions = 0;
+            std::size_t entries = 0;
+            std::size_t bytes = 0;
+        };
+
+        /**
+         * @param budget Memory budget of the cached series in bytes
+         */
+        explicit result_cache(const std::size_t &budget);
+
+        /**
+         * @brief Returns the indicator of `data`, from the cache when possible
+         *
+         * @param dataset Dataset name
+         * @param version Version of the dataset that `data` holds
+         * @param sp Indicator and parameters
+         * @param source Name of the column in `data.prices` ("close", "open", ...)
+         * @param data Columns of the dataset at `version`
+         * @return Same result as `universe::compute(data, sp)`, shared with the cache
+         */
+        std::shared_ptr<const std::vector<double>> get(const std::string &dataset, const std::uint64_t &version, const universe::spec &sp, const std::string &source, const universe::series &data);
+
+        /**
+         * @brief Declares that version `to` of `dataset` is version `from` with bars appended (no bar changed)
+         */
+        void appended(const std::string &dataset, const std::uint64_t &from, const std::uint64_t &to);
+
+        /**
+         * @brief Changes the budget, evicting as needed
+         */
+        void set_budget(const std::size_t &budget);
+
+        void clear();
+        stats statistics() const;
+
+    private:
+        using state = std::variant<std::monostate, stream::SMA, stream::EMA, stream::MACD, stream::RSI, stream::BollingerBands, stream::VWMA, stream::ATR, stream::Momentum,
+                                   stream::Donchian, stream::Stochastic, stream::WilliamsR, stream::Aroon>;
+        using key = std::tuple<std::string, universe::kind, std::size_t, std::size_t, std::uint64_t, std::string, std::string>;
+
+        struct entry
+        {
+            key k;
+            std::uint64_t version = 0;
+            // bars the result covers
+            std::size_t rows = 0;
+            std::shared_ptr<std::vector<double>> values;
+            // streaming indicator positioned after `rows` bars, created on the first extension
+            state live;
+            std::size_t bytes = 0;
+        };
+
+        // a series being computed or extended, for the version and length it will cover
+        struct flight
+        {
+            std::uint64_t version = 0;
+            std::size_t rows = 0;
+            std::shared_future<std::shared_ptr<const std::vector<double>>> result;
+        };
+
+        mutable std::mutex lock;
+        std::size_t budget, used = 0;
+        std::list<entry> lru;
+        std::map<key, std::list<entry>::iterator> index;
+        // (dataset, version) -> version it was appended from
+        std::map<std::pair<std::string, std::uint64_t>, std::uint64_t> parents;
+        std::map<key, flight> pending;
+        stats counters;
+
+        bool descends(const std::string &dataset, std::uint64_t version, const std::uint64_t &ancestor) const;
+        // touches only `e`, runs without the lock
+        bool extend(entry &e, const universe::spec &sp, const universe::series &data) const;
+        void account(entry &e);
+        void evict();
+    };
+}
+
+#endif
\ No newline at end of file
@@ -8,253 +8,1445 @@
 
 namespace core::indicators
 {
-    std::vector<double> WEIGHTS(const char *__Type, const std::size_t &n)
+    namespace
     {
-        if (n == 0 || !__Type)
-            return {};
-        std::vector<double> res(n, std::numeric_limits<double>::quiet_NaN());
-        if (std::strcmp(__Type, "linear") == 0)
+        // slides between two exact recomputations, the O(n) anchor every 8 windows stays amortized O(1)
+        std::size_t reanchor_interval(const std::size_t &n)
         {
-            for (std::size_t i = 1; i < n + 1; i++)
-                res[i - 1] = i;
+            return 8 * n;
         }
-        else if (std::strcmp(__Type, "normalized linear") == 0)
+
+        double mean_of(const double *values, const std::size_t &n)
         {
-            for (std::size_t i = 1; i < n + 1; i++)
-                res[i - 1] = (double)i / (double)n;
+            return vector_mean(values, n);
+        }
+
+        double mean_of(const float *values, const std::size_t &n)
+        {
+            return vector_meanf(values, n);
         }
-        else if (std::strcmp(__Type, "harmonic") == 0)
+
+        bool vwma_finite(const double &price, const double &volume)
         {
-            for (std::size_t i = 1; i < n + 1; i++)
-                res[i - 1] = 1.0 / (double)i;
+            return std::isfinite(volume) && std::isfinite(price * volume);
         }
-        else if (std::strcmp(__Type, "triangular") == 0)
+
+        // periods swept side by side, one AVX-512 register (two AVX2, four SSE2) of doubles
+        constexpr std::size_t LANES = 8;
+        // bars per sweep block, the lane-major block buffer stays in L1
+        constexpr std::size_t SWEEP_BLOCK = 256;
+
+        // valid rows (1 <= period <= `max`) ordered by period, so the lanes of a group start close together
+        std::vector<std::size_t> sweep_order(std::span<const std::size_t> periods, const std::size_t &max)
         {
-            std::size_t mid = (n + 1) / 2;
-            if (n % 2 == 0)
+            std::vector<std::size_t> order;
+            for (std::size_t r = 0; r < periods.size(); r++)
             {
-                for (std::size_t i = 1; i <= mid; ++i)
-                    res[i - 1] = (double)i;
+                if (periods[r] != 0 && periods[r] <= max)
+                    order.emplace_back(r);
+            }
+            std::stable_sort(order.begin(), order.end(), [&](const std::size_t &a, const std::size_t &b)
+                             { return periods[a] < periods[b]; });
+            return order;
+        }
 
-                for (std::size_t i = mid; i >= 1; --i)
-                    res[n - (mid - i) - 1] = (double)i;
+        // copies lane `l` of a [SWEEP_BLOCK][LANES] block into its row
+        void sweep_scatter(const double *block, const std::size_t *rows, const std::size_t &used, const std::size_t &m, double *res, const std::size_t &len, const std::size_t &base)
+        {
+            for (std::size_t l = 0; l < used; l++)
+            {
+                double *row = res + rows[l] * len + base;
+                for (std::size_t j = 0; j < m; j++)
+                    row[j] = block[j * LANES + l];
             }
-            else
+        }
+
+        // one lane group, lowered by each clone to its widest registers
+        typedef double lanes_pd __attribute__((vector_size(LANES * sizeof(double))));
+        typedef std::int64_t lanes_pi __attribute__((vector_size(LANES * sizeof(std::int64_t))));
+
+        // EMA recurrence of LANES periods over bars [base, base + m); a lane is NaN until its seed bar `start`.
+        // No FMA contraction in the clones, the rows must round exactly like `EMA` and `RSI`
+        __attribute__((target_clones("avx512f", "avx2", "default"), optimize("fp-contract=off"))) void ema_lanes(const double *__restrict prices, const std::size_t base, const std::size_t m, const lanes_pd &alpha, const lanes_pd &beta, const lanes_pi &start, const lanes_pd &seed, lanes_pd &state, lanes_pd *__restrict block)
+        {
+            lanes_pd s = state;
+            for (std::size_t j = 0; j < m; j++)
             {
-                for (std::size_t i = 1; i <= mid; ++i)
-                    res[i - 1] = (double)i;
+                lanes_pd next = alpha * prices[j] + beta * s;
+                s = (start == (std::int64_t)(base + j)) ? seed : next;
+                block[j] = s;
+            }
+            state = s;
+        }
 
-                for (std::size_t i = mid - 1; i >= 1; --i)
-                    res[n - (mid - i) - 1] = (double)i;
+        // Wilder smoothing and RSI of LANES periods over bars [base, base + m), same arithmetic as `RSI`
+        __attribute__((target_clones("avx512f", "avx2", "default"), optimize("fp-contract=off"))) void rsi_lanes(const double *__restrict gains, const double *__restrict losses, const std::size_t base, const std::size_t m, const lanes_pd &nm1, const lanes_pd &nd, const lanes_pi &start, const lanes_pd &seed_gains, const lanes_pd &seed_losses, lanes_pd &mean_gains, lanes_pd &mean_losses, lanes_pd *__restrict block)
+        {
+            const lanes_pd inf = lanes_pd{} + std::numeric_limits<double>::infinity();
+            lanes_pd mg = mean_gains, ml = mean_losses;
+            for (std::size_t j = 0; j < m; j++)
+            {
+                lanes_pi seeding = start == (std::int64_t)(base + j);
+                mg = seeding ? seed_gains : (mg * nm1 + gains[j]) / nd;
+                ml = seeding ? seed_losses : (ml * nm1 + losses[j]) / nd;
+                lanes_pd rs = (ml == 0) ? inf : mg / ml;
+                block[j] = 100.0 - (100.0 / (1 + rs));
             }
+            mean_gains = mg;
+            mean_losses = ml;
         }
-        else if (std::strcmp(__Type, "quadratic") == 0)
+
+        // Neumaier compensated `sum += x`, the running total is `sum + c`
+        void compensated_add(double &sum, double &c, const double &x)
         {
-            for (std::size_t i = 1; i < n + 1; i++)
-                res[i - 1] = i * i;
+            double t = sum + x;
+            if (std::abs(sum) >= std::abs(x))
+                c += (sum - t) + x;
+            else
+                c += (x - t) + sum;
+            sum = t;
         }
-        else if (std::strcmp(__Type, "cubic") == 0)
+    }
+
+    rolling_variance::rolling_variance(const std::size_t &n) : n(n), reanchor(reanchor_interval(n)) {}
+
+    template <typename T>
+    double rolling_variance::slide(const T *window, const double &out)
+    {
+        if (slides++ % reanchor == 0)
         {
-            for (std::size_t i = 1; i < n + 1; i++)
-                res[i - 1] = i * i * i;
+            // two-pass
+            mean = mean_of(window, n);
+            m2 = 0.0;
+            for (std::size_t j = 0; j < n; j++)
+                m2 += (window[j] - mean) * (window[j] - mean);
         }
-        else if (std::strcmp(__Type, "root") == 0)
+        else
         {
-            for (std::size_t i = 1; i < n + 1; i++)
-                res[i - 1] = std::sqrt(i);
+            const double in = window[n - 1];
+            const double next = mean + (in - out) / n;
+            m2 += (in - out) * ((in - next) + (out - mean));
+            mean = next;
         }
-        return res;
+        return MAX_2(m2, 0.0) / n;
     }
 
-    std::vector<double> SMA(const std::vector<double> &prices, const std::size_t &n)
+    double rolling_variance::update(const double *window, const double &out)
     {
-        if (n == 0 || prices.size() < n)
-            return {};
+        return slide(window, out);
+    }
+
+    double rolling_variance::update(const float *window, const float &out)
+    {
+        return slide(window, out);
+    }
 
-        std::vector<double> sma;
-        sma.reserve(prices.size());
+    rolling_vwma::rolling_vwma(const std::size_t &n) : n(n), reanchor(reanchor_interval(n)) {}
 
-        double wsum = 0.0;
-        for (std::size_t i = 0; i < prices.size(); i++)
+    template <typename T>
+    void rolling_vwma::anchor(const T *prices, const T *volumes)
+    {
+        pv_sum = vl_sum = pv_c = vl_c = 0.0;
+        zeros = non_finite = 0;
+        for (std::size_t j = 0; j < n; j++)
         {
-            wsum += prices[i];
+            pv_sum += (double)prices[j] * volumes[j];
+            vl_sum += volumes[j];
+            zeros += volumes[j] == 0.0;
+            non_finite += !vwma_finite(prices[j], volumes[j]);
+        }
+    }
 
-            if (i >= n)
-                wsum -= prices[i - n];
+    template <typename T>
+    double rolling_vwma::slide(const T *prices, const T *volumes, const double &out_price, const double &out_volume)
+    {
+        if (slides++ % reanchor == 0)
+        {
+            anchor(prices, volumes);
+        }
+        else
+        {
+            const double in_price = prices[n - 1], in_volume = volumes[n - 1];
+            zeros += (in_volume == 0.0) - (out_volume == 0.0);
+            const bool was_poisoned = non_finite != 0;
+            non_finite += !vwma_finite(in_price, in_volume);
+            non_finite -= !vwma_finite(out_price, out_volume);
 
-            if (i < n - 1)
-                sma.emplace_back(std::numeric_limits<double>::quiet_NaN());
+            if (was_poisoned && non_finite == 0)
+            {
+                // the running sums are NaN/inf, rebuild them now that the window is clean again
+                anchor(prices, volumes);
+            }
             else
-                sma.emplace_back(wsum / n);
+            {
+                compensated_add(pv_sum, pv_c, in_price * in_volume);
+                compensated_add(pv_sum, pv_c, -(out_price * out_volume));
+                compensated_add(vl_sum, vl_c, in_volume);
+                compensated_add(vl_sum, vl_c, -out_volume);
+            }
         }
 
-        return sma;
+        const double vl = vl_sum + vl_c;
+        if (non_finite != 0 || zeros == n || vl == 0.0)
+            return std::numeric_limits<double>::quiet_NaN();
+        return (pv_sum + pv_c) / vl;
     }
 
-    std::vector<double> EMA(const std::vector<double> &prices, const std::size_t &n)
+    double rolling_vwma::update(const double *prices, const double *volumes, const double &out_price, const double &out_volume)
     {
-        if (n == 0 || prices.size() < n)
-            return {};
-        std::vector<double> ema(prices.size(), std::numeric_limits<double>::quiet_NaN());
+        return slide(prices, volumes, out_price, out_volume);
+    }
 
-        double alpha = 2.00 / (n + 1.00);
-        double ema_prev = vector_mean(prices.data(), n);
-        ema[n - 1] = ema_prev;
+    double rolling_vwma::update(const float *prices, const float *volumes, const float &out_price, const float &out_volume)
+    {
+        return slide(prices, volumes, out_price, out_volume);
+    }
 
-        for (size_t i = n; i < prices.size(); i++)
+    rolling_extreme::rolling_extreme(const std::size_t &n, const bool &maximum)
+        : n(n), mask(std::bit_ceil(std::max<std::size_t>(n, 1)) - 1), maximum(maximum), ring(mask + 1) {}
+
+    double rolling_extreme::update(const double &value)
+    {
+        const std::size_t bar = bars++;
+        if (n == 0)
+            return value;
+
+        // the front leaves first, the deque then never holds more than n - 1 candidates before the push
+        if (size != 0 && ring[head].bar + n <= bar)
+        {
+            head = (head + 1) & mask;
+            size--;
+        }
+        if (std::isnan(value))
+            nan_end = bar + n;
+        else
         {
-            double ema_curr = alpha * prices[i] + (1 - alpha) * ema_prev;
-            ema[i] = ema_curr;
-            ema_prev = ema_curr;
+            while (size != 0)
+            {
+                const double back = ring[(head + size - 1) & mask].value;
+                if (maximum ? back > value : back < value)
+                    break;
+                size--;
+            }
+            ring[(head + size) & mask] = {bar, value};
+            size++;
         }
+        return this->value();
+    }
 
-        return ema;
+    double rolling_extreme::value() const
+    {
+        if (size == 0 || bars <= nan_end)
+            return std::numeric_limits<double>::quiet_NaN();
+        return ring[head].value;
     }
 
-    std::vector<double> WMA(const std::vector<double> &prices, const char *weights, const std::size_t &n)
+    std::span<double> arena::take(const std::size_t &n)
     {
-        if (n == 0 || prices.size() < n)
-            return {};
+        for (; block < blocks.size(); block++, used = 0)
+        {
+            if (sizes[block] - used >= n)
+            {
+                std::span<double> out(blocks[block].get() + used, n);
+                used += n;
+                return out;
+            }
+        }
+        // at least doubles the capacity, a growing run settles after a few blocks
+        const std::size_t size = std::max({n, MIN_BLOCK, capacity()});
+        blocks.emplace_back(std::make_unique_for_overwrite<double[]>(size));
+        sizes.emplace_back(size);
+        block = blocks.size() - 1;
+        used = n;
+        return std::span<double>(blocks[block].get(), n);
+    }
+
+    std::size_t arena::capacity() const
+    {
+        return std::accumulate(sizes.begin(), sizes.end(), std::size_t(0));
+    }
+
+    void arena::release()
+    {
+        blocks.clear();
+        sizes.clear();
+        block = used = 0;
+    }
 
-        std::vector<double> wma(prices.size(), std::numeric_limits<double>::quiet_NaN());
-        std::vector<double> w = WEIGHTS(weights, n);
-        double w_sum = vector_sum(w.data(), n);
+    arena &arena::local()
+    {
+        thread_local arena scratch;
+        return scratch;
+    }
 
-        for (std::size_t i = n - 1; i < prices.size(); i++)
+    weighting resolve_weighting(const char *__Type)
+    {
+        static constexpr std::pair<const char *, weighting> NAMES[] = {
+            {"linear", weighting::LINEAR},
+            {"normalized linear", weighting::NORMALIZED_LINEAR},
+            {"harmonic", weighting::HARMONIC},
+            {"triangular", weighting::TRIANGULAR},
+            {"quadratic", weighting::QUADRATIC},
+            {"cubic", weighting::CUBIC},
+            {"root", weighting::ROOT}};
+        if (!__Type)
+            return weighting::UNKNOWN;
+        for (const auto &[name, scheme] : NAMES)
         {
-            double prod_sum = 0;
-            for (std::size_t j = 0; j < n; j++)
-                prod_sum += w[j] * prices[i - j];
-            wma[i] = prod_sum / w_sum;
+            if (std::strcmp(__Type, name) == 0)
+                return scheme;
         }
-        return wma;
+        return weighting::UNKNOWN;
     }
 
-    std::vector<double> VWMA(const std::vector<double> &prices, const std::vector<double> &volumes, const std::size_t &n)
+    namespace
     {
-        if (n == 0 || prices.size() < n || volumes.size() < n)
+        // `n` weights of `scheme` into `res`, NaN for an unknown scheme
+        void fill_weights(const weighting &scheme, const std::size_t &n, double *res)
+        {
+            for (std::size_t i = 1; i < n + 1; i++)
+            {
+                const double x = (double)i;
+                switch (scheme)
+                {
+                case weighting::LINEAR:
+                    res[i - 1] = x;
+                    break;
+                case weighting::NORMALIZED_LINEAR:
+                    res[i - 1] = x / (double)n;
+                    break;
+                case weighting::HARMONIC:
+                    res[i - 1] = 1.0 / x;
+                    break;
+                case weighting::TRIANGULAR:
+                    // 1, 2, ..., 2, 1 with one peak for odd n and two for even n
+                    res[i - 1] = (double)std::min(i, n + 1 - i);
+                    break;
+                case weighting::QUADRATIC:
+                    res[i - 1] = x * x;
+                    break;
+                case weighting::CUBIC:
+                    res[i - 1] = x * x * x;
+                    break;
+                case weighting::ROOT:
+                    res[i - 1] = std::sqrt(x);
+                    break;
+                default:
+                    res[i - 1] = std::numeric_limits<double>::quiet_NaN();
+                    break;
+                }
+            }
+        }
+    }
+
+    std::vector<double> WEIGHTS(const char *__Type, const std::size_t &n)
+    {
+        if (n == 0 || !__Type)
             return {};
+        std::vector<double> res(n);
+        fill_weights(resolve_weighting(__Type), n, res.data());
+        return res;
+    }
 
-        std::vector<double> vwma(prices.size(), std::numeric_limits<double>::quiet_NaN());
+    namespace
+    {
+        // from this period on the convolution schemes go through the FFT instead of a dot product per bar
+        constexpr std::size_t FFT_MIN = 128;
+        // bars of a float32 block widened to double for the convolution
+        constexpr std::size_t DOT_BLOCK = 1024;
+        // lane groups of bars a convolution pass keeps in flight, their sums are independent chains
+        constexpr std::size_t CONV_GROUPS = 4;
+        // weight tables kept at once, the cache starts over when it would hold more
+        constexpr std::size_t MAX_TABLES = 64;
 
-        for (std::size_t i = n - 1; i < prices.size(); i++)
+        // schemes without a recurrence, summed as a convolution
+        bool convolved(const weighting &scheme)
         {
-            double pv_sum = 0, vl_sum = 0;
-            for (std::size_t j = 0; j < n; j++)
+            return scheme == weighting::HARMONIC || scheme == weighting::QUADRATIC || scheme == weighting::CUBIC || scheme == weighting::ROOT;
+        }
+
+        struct weight_table
+        {
+            std::size_t n = 0;
+            // reversed WEIGHTS, lined up with a window of prices (oldest first)
+            std::vector<double> oldest;
+            double sum = 0.0;
+            // convolution schemes with n >= FFT_MIN: FFT of the zero padded weights, and exp(-2 pi i k / size)
+            // for k < size / 2
+            std::vector<std::complex<double>> spectrum, twiddles;
+        };
+
+        // in-place radix-2 FFT of the `m` (a power of two) values of `a`, unscaled; the butterflies are written
+        // out because std::complex products check for NaN and infinity on every multiplication
+        void fft(std::complex<double> *a, const std::size_t &m, const std::complex<double> *twiddles, const bool &inverse)
+        {
+            for (std::size_t i = 1, j = 0; i < m; i++)
             {
-                pv_sum += prices[i - j] * volumes[i - j];
-                vl_sum += volumes[i - j];
+                std::size_t bit = m >> 1;
+                for (; j & bit; bit >>= 1)
+                    j ^= bit;
+                j ^= bit;
+                if (i < j)
+                    std::swap(a[i], a[j]);
+            }
+            const double sign = inverse ? -1.0 : 1.0;
+            for (std::size_t half = 1; half < m; half <<= 1)
+            {
+                const std::size_t stride = m / (2 * half);
+                for (std::size_t first = 0; first < m; first += 2 * half)
+                {
+                    for (std::size_t k = 0; k < half; k++)
+                    {
+                        const double wr = twiddles[k * stride].real(), wi = sign * twiddles[k * stride].imag();
+                        std::complex<double> &u = a[first + k], &v = a[first + k + half];
+                        const double vr = v.real() * wr - v.imag() * wi, vi = v.real() * wi + v.imag() * wr;
+                        v = {u.real() - vr, u.imag() - vi};
+                        u = {u.real() + vr, u.imag() + vi};
+                    }
+                }
             }
-            vwma[i] = (vl_sum == 0.0) ? std::numeric_limits<double>::quiet_NaN() : pv_sum / vl_sum;
         }
 
-        return vwma;
-    }
+        // table of (scheme, n), built on first use and shared by every thread
+        std::shared_ptr<const weight_table> weights_of(const weighting &scheme, const std::size_t &n)
+        {
+            static std::mutex lock;
+            static std::map<std::pair<weighting, std::size_t>, std::shared_ptr<const weight_table>> tables;
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                auto it = tables.find({scheme, n});
+                if (it != tables.end())
+                    return it->second;
+            }
 
-    std::vector<double> MACD(const std::vector<double> &prices, const std::size_t &fast, const std::size_t &slow)
-    {
-        if (fast == 0 || slow == 0 || prices.size() < std::max(fast, slow))
-            return {};
+            // built outside the lock, when two threads race for the same table the first one stored is kept
+            auto t = std::make_shared<weight_table>();
+            t->n = n;
+            t->oldest.resize(n);
+            fill_weights(scheme, n, t->oldest.data());
+            t->sum = vector_sum(t->oldest.data(), n);
+            std::reverse(t->oldest.begin(), t->oldest.end());
+            if (convolved(scheme) && n >= FFT_MIN)
+            {
+                const std::size_t m = std::bit_ceil(4 * n);
+                t->twiddles.resize(m / 2);
+                for (std::size_t k = 0; k < m / 2; k++)
+                    t->twiddles[k] = std::polar(1.0, -2.0 * std::numbers::pi * (double)k / (double)m);
+                // the newest price's weight first, so the circular convolution is the weighted sum
+                t->spectrum.assign(m, 0.0);
+                for (std::size_t j = 0; j < n; j++)
+                    t->spectrum[j] = t->oldest[n - 1 - j];
+                fft(t->spectrum.data(), m, t->twiddles.data(), false);
+            }
 
-        const std::vector<double> a = EMA(prices, fast);
-        const std::vector<double> b = EMA(prices, slow);
+            std::lock_guard<std::mutex> guard(lock);
+            if (tables.size() >= MAX_TABLES)
+                tables.clear();
+            return tables.try_emplace({scheme, n}, std::move(t)).first->second;
+        }
 
-        std::vector<double> macd(a.size(), std::numeric_limits<double>::quiet_NaN());
+        template <typename T>
+        double window_sum(const T *first, const std::size_t &count)
+        {
+            double sum = 0.0;
+            for (std::size_t j = 0; j < count; j++)
+                sum += first[j];
+            return sum;
+        }
 
-        for (std::size_t i = 0; i < a.size(); i++)
+        // weighted sum of the window starting at `window`, oldest price first
+        template <typename T>
+        double window_dot(const T *window, const weight_table &w)
         {
-            if (std::isnan(a[i]) || std::isnan(b[i]))
-                macd[i] = std::numeric_limits<double>::quiet_NaN();
+            if constexpr (std::is_same_v<T, double>)
+                return vector_dot_product(w.oldest.data(), window, w.n);
             else
-                macd[i] = a[i] - b[i];
+            {
+                double sum = 0.0;
+                for (std::size_t j = 0; j < w.n; j++)
+                    sum += w.oldest[j] * window[j];
+                return sum;
+            }
+        }
+
+        // WMA from running sums: `anchor(i)` rebuilds them from the window of bar i and `slide(i)` moves them
+        // there from bar i - 1, both returning the weighted sum. A window with a non-finite price is summed
+        // directly, and the sums are rebuilt once the window is clean again
+        template <typename T, typename A, typename S>
+        void wma_sliding(std::span<const T> prices, const weight_table &w, std::span<T> out, A &&anchor, S &&slide)
+        {
+            const std::size_t n = w.n, len = prices.size(), reanchor = reanchor_interval(n);
+            // bars before `clean_from` have a non-finite price in their window
+            std::size_t clean_from = 0, slides = 0;
+            bool stale = true;
+            for (std::size_t i = 0; i + 1 < n; i++)
+            {
+                if (!std::isfinite(prices[i]))
+                    clean_from = i + n;
+            }
+            for (std::size_t i = n - 1; i < len; i++)
+            {
+                if (!std::isfinite(prices[i]))
+                    clean_from = i + n;
+                if (i < clean_from)
+                {
+                    out[i] = window_dot(prices.data() + i - n + 1, w) / w.sum;
+                    stale = true;
+                    continue;
+                }
+                double weighted;
+                if (stale || slides == reanchor)
+                {
+                    weighted = anchor(i);
+                    stale = false;
+                    slides = 0;
+                }
+                else
+                {
+                    weighted = slide(i);
+                    slides++;
+                }
+                out[i] = weighted / w.sum;
+            }
+        }
+
+        // weights n, ..., 1 from the oldest price: weighted += sum + in - (n + 1) out, sum += in - out
+        template <typename T>
+        void wma_linear(std::span<const T> prices, const weight_table &w, std::span<T> out)
+        {
+            const std::size_t n = w.n;
+            const T *p = prices.data();
+            double sum = 0.0, weighted = 0.0;
+            wma_sliding(
+                prices, w, out,
+                [&](const std::size_t &i)
+                {
+                    sum = window_sum(p + i - n + 1, n);
+                    return weighted = window_dot(p + i - n + 1, w);
+                },
+                [&](const std::size_t &i)
+                {
+                    weighted += sum + p[i] - (double)(n + 1) * p[i - n];
+                    sum += (double)p[i] - p[i - n];
+                    return weighted;
+                });
+        }
+
+        // the triangle is an SMA of a prices over an SMA of b of them (a + b = n + 1), so the weighted sum moves
+        // by the newest a-sum (`front`) minus the a-sum b bars back (`back`)
+        template <typename T>
+        void wma_triangular(std::span<const T> prices, const weight_table &w, std::span<T> out)
+        {
+            const std::size_t n = w.n, a = (n + 1) / 2, b = n + 1 - a;
+            const T *p = prices.data();
+            // after bar i: front is the sum of prices (i - a, i], back that of (i - n, i - n + a]
+            double front = 0.0, back = 0.0, weighted = 0.0;
+            wma_sliding(
+                prices, w, out,
+                [&](const std::size_t &i)
+                {
+                    front = window_sum(p + i - a + 1, a);
+                    back = window_sum(p + i - n + 1, a);
+                    return weighted = window_dot(p + i - n + 1, w);
+                },
+                [&](const std::size_t &i)
+                {
+                    front += (double)p[i] - p[i - a];
+                    weighted += front - back;
+                    back += (double)p[i + 1 - b] - p[i - n];
+                    return weighted;
+                });
+        }
+
+        // weighted sums of the `count` windows starting at `first`, `first + 1`, ... over `sum`: CONV_GROUPS x LANES
+        // bars at a time, each weight is broadcast against the prices it meets in those windows
+        __attribute__((target_clones("avx512f", "avx2", "default"))) void convolve_lanes(const double *__restrict first, const double *__restrict oldest, const std::size_t n, const double sum, const std::size_t count, double *__restrict res)
+        {
+            constexpr std::size_t STEP = CONV_GROUPS * LANES;
+            std::size_t t = 0;
+            for (; t + STEP <= count; t += STEP)
+            {
+                lanes_pd acc[CONV_GROUPS] = {};
+                for (std::size_t j = 0; j < n; j++)
+                {
+                    for (std::size_t g = 0; g < CONV_GROUPS; g++)
+                    {
+                        lanes_pd window;
+                        std::memcpy(&window, first + t + g * LANES + j, sizeof(window));
+                        acc[g] += oldest[j] * window;
+                    }
+                }
+                for (std::size_t g = 0; g < CONV_GROUPS; g++)
+                {
+                    const lanes_pd mean = acc[g] / sum;
+                    std::memcpy(res + t + g * LANES, &mean, sizeof(mean));
+                }
+            }
+            for (; t < count; t++)
+            {
+                double acc = 0.0;
+                for (std::size_t j = 0; j < n; j++)
+                    acc += oldest[j] * first[t + j];
+                res[t] = acc / sum;
+            }
         }
 
-        return macd;
+        // bars [from, to) as a direct convolution, float32 prices (and results) go through double a block at a time
+        template <typename T>
+        void wma_direct(std::span<const T> prices, const weight_table &w, std::span<T> out, const std::size_t &from, const std::size_t &to, arena &scratch)
+        {
+            const std::size_t n = w.n;
+            if constexpr (std::is_same_v<T, double>)
+                convolve_lanes(prices.data() + from - n + 1, w.oldest.data(), n, w.sum, to - from, out.data() + from);
+            else
+            {
+                arena::scope temporaries(scratch);
+                std::span<double> block = scratch.take(DOT_BLOCK + n - 1), res = scratch.take(DOT_BLOCK);
+                for (std::size_t base = from; base < to; base += DOT_BLOCK)
+                {
+                    const std::size_t end = std::min(base + DOT_BLOCK, to);
+                    std::copy(prices.begin() + (base - n + 1), prices.begin() + end, block.begin());
+                    convolve_lanes(block.data(), w.oldest.data(), n, w.sum, end - base, res.data());
+                    std::copy(res.begin(), res.begin() + (end - base), out.begin() + base);
+                }
+            }
+        }
+
+        // overlap-save: an FFT of m prices gives the m - n + 1 bars whose whole window it holds. Two blocks share
+        // one complex FFT, the first in the real part and the second in the imaginary part (the weights are real)
+        template <typename T>
+        void wma_fft(std::span<const T> prices, const weight_table &w, std::span<T> out, arena &scratch)
+        {
+            const std::size_t n = w.n, len = prices.size(), m = w.spectrum.size(), step = m - n + 1;
+            arena::scope temporaries(scratch);
+            // complex<double> is laid out as two doubles
+            std::complex<double> *buffer = reinterpret_cast<std::complex<double> *>(scratch.take(2 * m).data());
+            const double scale = 1.0 / ((double)m * w.sum);
+
+            for (std::size_t base = n - 1; base < len; base += 2 * step)
+            {
+                const std::size_t second = base + step, end = std::min(base + 2 * step, len);
+                bool finite = true;
+                for (std::size_t k = 0; k < m; k++)
+                {
+                    // the padding past the last price only reaches bars that do not exist
+                    const std::size_t i = base - n + 1 + k, j = second - n + 1 + k;
+                    const double re = i < len ? (double)prices[i] : 0.0, im = j < len ? (double)prices[j] : 0.0;
+                    finite &= std::isfinite(re) && std::isfinite(im);
+                    buffer[k] = {re, im};
+                }
+                if (!finite)
+                {
+                    // NaN or infinity would spread over every bar of the block
+                    wma_direct(prices, w, out, base, end, scratch);
+                    continue;
+                }
+
+                fft(buffer, m, w.twiddles.data(), false);
+                for (std::size_t k = 0; k < m; k++)
+                {
+                    const double xr = buffer[k].real(), xi = buffer[k].imag(), hr = w.spectrum[k].real(), hi = w.spectrum[k].imag();
+                    buffer[k] = {xr * hr - xi * hi, xr * hi + xi * hr};
+                }
+                fft(buffer, m, w.twiddles.data(), true);
+
+                for (std::size_t t = 0; t < step && base + t < len; t++)
+                    out[base + t] = buffer[n - 1 + t].real() * scale;
+                for (std::size_t t = 0; t < step && second + t < len; t++)
+                    out[second + t] = buffer[n - 1 + t].imag() * scale;
+            }
+        }
     }
 
-    std::vector<double> RSI(const std::vector<double> &prices, const std::size_t &n)
+    namespace
     {
-        if (n == 0 || prices.size() <= n)
-            return {};
+        // the batch indicators for double and float32 columns: values are read as stored and every sum,
+        // EMA and Wilder mean is carried in double, so the float32 results are rounded once, on store.
+        // Each writes the whole of out[0, prices.size()), warm-up included, and returns false on invalid input
+        template <typename T, typename U>
+        bool sma(std::span<const U> prices, const std::size_t &n, std::span<T> out)
+        {
+            if (n == 0 || prices.size() < n || out.size() < prices.size())
+                return false;
 
-        std::vector<double> gains(prices.size(), 0), losses(prices.size(), 0);
+            double wsum = 0.0;
+            for (std::size_t i = 0; i < prices.size(); i++)
+            {
+                wsum += prices[i];
 
-        for (std::size_t i = 1; i < prices.size(); i++)
+                if (i >= n)
+                    wsum -= prices[i - n];
+
+                if (i < n - 1)
+                    out[i] = std::numeric_limits<T>::quiet_NaN();
+                else
+                    out[i] = wsum / n;
+            }
+
+            return true;
+        }
+
+        // `O` is the column type or double for a temporary, rounded to the column type when it is read
+        template <typename T, typename O>
+        bool ema(std::span<const T> prices, const std::size_t &n, std::span<O> out)
         {
-            double delta = prices[i] - prices[i - 1];
-            if (delta > 0)
-                gains[i] = delta;
+            if (n == 0 || prices.size() < n || out.size() < prices.size())
+                return false;
+            std::fill(out.begin(), out.begin() + (n - 1), std::numeric_limits<O>::quiet_NaN());
+
+            double alpha = 2.00 / (n + 1.00);
+            double ema_prev = mean_of(prices.data(), n);
+            out[n - 1] = ema_prev;
+
+            for (size_t i = n; i < prices.size(); i++)
+            {
+                double ema_curr = alpha * prices[i] + (1 - alpha) * ema_prev;
+                out[i] = ema_curr;
+                ema_prev = ema_curr;
+            }
+
+            return true;
+        }
+
+        template <typename T>
+        bool wma(std::span<const T> prices, const char *weights, const std::size_t &n, std::span<T> out, arena &scratch)
+        {
+            if (n == 0 || prices.size() < n || !weights || out.size() < prices.size())
+                return false;
+
+            const weighting scheme = resolve_weighting(weights);
+            std::fill(out.begin(), out.begin() + (n - 1), std::numeric_limits<T>::quiet_NaN());
+            switch (scheme)
+            {
+            case weighting::LINEAR:
+            case weighting::NORMALIZED_LINEAR:
+                // scaling the weights does not change the average
+                wma_linear(prices, *weights_of(weighting::LINEAR, n), out);
+                break;
+            case weighting::TRIANGULAR:
+                wma_triangular(prices, *weights_of(scheme, n), out);
+                break;
+            case weighting::UNKNOWN:
+                // the weights are NaN
+                std::fill(out.begin() + (n - 1), out.begin() + prices.size(), std::numeric_limits<T>::quiet_NaN());
+                break;
+            default:
+            {
+                std::shared_ptr<const weight_table> w = weights_of(scheme, n);
+                if (n >= FFT_MIN)
+                    wma_fft(prices, *w, out, scratch);
+                else
+                    wma_direct(prices, *w, out, n - 1, prices.size(), scratch);
+                break;
+            }
+            }
+            return true;
+        }
+
+        template <typename T>
+        bool vwma(std::span<const T> prices, std::span<const T> volumes, const std::size_t &n, std::span<T> out)
+        {
+            if (n == 0 || prices.size() < n || volumes.size() < n || out.size() < prices.size())
+                return false;
+
+            const std::size_t len = std::min(prices.size(), volumes.size());
+            std::fill(out.begin(), out.begin() + (n - 1), std::numeric_limits<T>::quiet_NaN());
+            // bars past the end of the volumes have no window
+            std::fill(out.begin() + len, out.begin() + prices.size(), std::numeric_limits<T>::quiet_NaN());
+
+            rolling_vwma sums(n);
+            for (std::size_t i = n - 1; i < len; i++)
+            {
+                T out_price = i >= n ? prices[i - n] : 0.0, out_volume = i >= n ? volumes[i - n] : 0.0;
+                out[i] = sums.update(prices.data() + i - n + 1, volumes.data() + i - n + 1, out_price, out_volume);
+            }
+
+            return true;
+        }
+
+        template <typename T>
+        bool macd(std::span<const T> prices, const std::size_t &fast, const std::size_t &slow, std::span<T> out, arena &scratch)
+        {
+            if (fast == 0 || slow == 0 || prices.size() < std::max(fast, slow) || out.size() < prices.size())
+                return false;
+
+            // both EMAs stay in double (a double `out` holds the fast one), so the difference is rounded once
+            arena::scope temporaries(scratch);
+            std::span<double> a, b = scratch.take(prices.size());
+            if constexpr (std::is_same_v<T, double>)
+                a = out;
             else
-                losses[i] = -delta;
+                a = scratch.take(prices.size());
+            ema(prices, fast, a);
+            ema(prices, slow, b);
+
+            for (std::size_t i = 0; i < prices.size(); i++)
+            {
+                if (std::isnan(a[i]) || std::isnan(b[i]))
+                    out[i] = std::numeric_limits<T>::quiet_NaN();
+                else
+                    out[i] = a[i] - b[i];
+            }
+
+            return true;
         }
-        double mean_gains = vector_mean(gains.data(), n), mean_losses = vector_mean(losses.data(), n);
 
-        std::vector<double> rsi(prices.size(), std::numeric_limits<double>::quiet_NaN());
-        double rs = (mean_losses == 0) ? std::numeric_limits<double>::infinity() : mean_gains / mean_losses;
-        rsi[n] = 100.0 - (100.0 / (1 + rs));
+        template <typename T>
+        bool rsi(std::span<const T> prices, const std::size_t &n, std::span<T> out, arena &scratch)
+        {
+            if (n == 0 || prices.size() <= n || out.size() < prices.size())
+                return false;
+
+            // gain and loss of bar i, from the price change since bar i - 1 (bar 0 has neither)
+            auto change = [&](const std::size_t &i, double &gain, double &loss)
+            {
+                double delta = prices[i] - prices[i - 1];
+                gain = delta > 0 ? delta : 0.0;
+                loss = delta > 0 ? 0.0 : -delta;
+            };
+
+            // only the seed window is kept, it is averaged with the SIMD mean
+            arena::scope temporaries(scratch);
+            std::span<double> gains = scratch.take(n), losses = scratch.take(n);
+            gains[0] = losses[0] = 0.0;
+            for (std::size_t i = 1; i < n; i++)
+                change(i, gains[i], losses[i]);
+            double mean_gains = vector_mean(gains.data(), n), mean_losses = vector_mean(losses.data(), n);
+
+            std::fill(out.begin(), out.begin() + n, std::numeric_limits<T>::quiet_NaN());
+            double rs = (mean_losses == 0) ? std::numeric_limits<double>::infinity() : mean_gains / mean_losses;
+            out[n] = 100.0 - (100.0 / (1 + rs));
+
+            double gain, loss;
+            for (std::size_t i = n + 1; i < prices.size(); i++)
+            {
+                change(i, gain, loss);
+                mean_gains = (mean_gains * (n - 1) + gain) / n;
+                mean_losses = (mean_losses * (n - 1) + loss) / n;
+                rs = (mean_losses == 0) ? std::numeric_limits<double>::infinity() : mean_gains / mean_losses;
+                out[i] = 100.0 - (100.0 / (1 + rs));
+            }
+            return true;
+        }
 
-        for (std::size_t i = n + 1; i < gains.size(); i++)
+        template <typename T>
+        bool bollinger_bands(std::span<const T> prices, const std::size_t n, const double &k, std::span<T> middle, std::span<T> upper, std::span<T> lower, arena &scratch)
         {
-            mean_gains = (mean_gains * (n - 1) + gains[i]) / n;
-            mean_losses = (mean_losses * (n - 1) + losses[i]) / n;
-            rs = (mean_losses == 0) ? std::numeric_limits<double>::infinity() : mean_gains / mean_losses;
-            rsi[i] = 100.0 - (100.0 / (1 + rs));
+            const std::size_t len = prices.size();
+            if (n == 0 || len < n || middle.size() < len || upper.size() < len || lower.size() < len)
+                return false;
+
+            // the bands are spread around the unrounded mean, a double middle band is that mean already
+            arena::scope temporaries(scratch);
+            std::span<double> sma_values;
+            if constexpr (std::is_same_v<T, double>)
+                sma_values = middle;
+            else
+                sma_values = scratch.take(len);
+            sma(prices, n, sma_values);
+            if constexpr (!std::is_same_v<T, double>)
+                std::copy(sma_values.begin(), sma_values.end(), middle.begin());
+
+            std::fill(upper.begin(), upper.begin() + (n - 1), std::numeric_limits<T>::quiet_NaN());
+            std::fill(lower.begin(), lower.begin() + (n - 1), std::numeric_limits<T>::quiet_NaN());
+            rolling_variance variance(n);
+            for (std::size_t i = n - 1; i < len; ++i)
+            {
+                double sd = std::sqrt(variance.update(prices.data() + i - n + 1, i >= n ? prices[i - n] : 0.0));
+
+                if (!std::isnan(sma_values[i]))
+                {
+                    upper[i] = sma_values[i] + k * sd;
+                    lower[i] = sma_values[i] - k * sd;
+                }
+                else
+                    upper[i] = lower[i] = std::numeric_limits<T>::quiet_NaN();
+            }
+
+            return true;
         }
-        return rsi;
-    }
 
-    std::vector<std::vector<double>> BollingerBands(const std::vector<double> &prices, const std::size_t n, const double &k)
-    {
-        if (n == 0 || prices.size() < n)
-            return {};
+        template <typename T>
+        bool atr(std::span<const T> highs, std::span<const T> lows, std::span<const T> closes, const std::size_t &n, std::span<T> out, arena &scratch)
+        {
+            if (highs.size() != lows.size() || highs.size() != closes.size() || highs.empty() || n == 0 || highs.size() < n || out.size() < highs.size())
+                return false;
 
-        std::vector<double> middle = SMA(prices, n);
-        std::vector<double> upper(prices.size(), std::numeric_limits<double>::quiet_NaN());
-        std::vector<double> lower(prices.size(), std::numeric_limits<double>::quiet_NaN());
+            arena::scope temporaries(scratch);
+            std::span<double> true_range = scratch.take(highs.size());
+            true_range[0] = (double)highs[0] - lows[0];
+
+            for (std::size_t i = 1; i < highs.size(); i++)
+            {
+                double hl = (double)highs[i] - lows[i], hc = std::abs((double)highs[i] - closes[i - 1]), lc = std::abs((double)lows[i] - closes[i - 1]);
+                true_range[i] = MAX_3(hl, hc, lc);
+            }
 
-        for (std::size_t i = n - 1; i < prices.size(); ++i)
+            return sma(std::span<const double>(true_range), n, out);
+        }
+
+        template <typename T>
+        bool momentum(std::span<const T> prices, const std::size_t n, std::span<T> out)
+        {
+            if (n == 0 || prices.size() <= n || out.size() < prices.size())
+                return false;
+            std::fill(out.begin(), out.begin() + n, std::numeric_limits<T>::quiet_NaN());
+            for (std::size_t i = n; i < prices.size(); i++)
+                out[i] = prices[i] - prices[i - n];
+            return true;
+        }
+
+        // every high/low indicator reads equal-length columns
+        template <typename T>
+        bool same_length(std::span<const T> highs, std::span<const T> lows, std::span<const T> closes = {})
         {
-            std::span<const double> slice(prices.data() + i - n + 1, prices.data() + i + 1);
-            double sd = vector_std_deviation(slice.data(), slice.size());
+            return highs.size() == lows.size() && (closes.empty() || closes.size() == highs.size());
+        }
 
-            if (!std::isnan(middle[i]))
+        template <typename T>
+        bool donchian(std::span<const T> highs, std::span<const T> lows, const std::size_t &n, std::span<T> middle, std::span<T> upper, std::span<T> lower)
+        {
+            const std::size_t len = highs.size();
+            if (!same_length(highs, lows) || n == 0 || len < n || middle.size() < len || upper.size() < len || lower.size() < len)
+                return false;
+
+            rolling_extreme highest(n, true), lowest(n, false);
+            for (std::size_t i = 0; i < len; i++)
+            {
+                const double hh = highest.update(highs[i]), ll = lowest.update(lows[i]);
+                if (i < n - 1)
+                    middle[i] = upper[i] = lower[i] = std::numeric_limits<T>::quiet_NaN();
+                else
+                {
+                    middle[i] = (hh + ll) / 2;
+                    upper[i] = hh;
+                    lower[i] = ll;
+                }
+            }
+            return true;
+        }
+
+        template <typename T>
+        bool stochastic(std::span<const T> highs, std::span<const T> lows, std::span<const T> closes, const std::size_t &n, const std::size_t &d, std::span<T> k_out, std::span<T> d_out)
+        {
+            const std::size_t len = highs.size();
+            if (!same_length(highs, lows, closes) || n == 0 || d == 0 || len < n || k_out.size() < len || d_out.size() < len)
+                return false;
+
+            rolling_extreme highest(n, true), lowest(n, false);
+            // the last d unrounded %K values, %D sums them oldest first like `stream::Stochastic`
+            std::vector<double> recent(d, 0.0);
+            for (std::size_t i = 0; i < len; i++)
+            {
+                const double hh = highest.update(highs[i]), ll = lowest.update(lows[i]);
+                if (i < n - 1)
+                {
+                    k_out[i] = d_out[i] = std::numeric_limits<T>::quiet_NaN();
+                    continue;
+                }
+                const double range = hh - ll, c = closes[i];
+                const double k = range != 0 || std::isnan(c) ? 100.0 * (c - ll) / range : 0.0;
+                k_out[i] = k;
+                recent[(i - (n - 1)) % d] = k;
+                if (i - (n - 1) + 1 < d)
+                {
+                    d_out[i] = std::numeric_limits<T>::quiet_NaN();
+                    continue;
+                }
+                double sum = 0.0;
+                for (std::size_t j = 0; j < d; j++)
+                    sum += recent[(i - (n - 1) + 1 + j) % d];
+                d_out[i] = sum / d;
+            }
+            return true;
+        }
+
+        template <typename T>
+        bool williams_r(std::span<const T> highs, std::span<const T> lows, std::span<const T> closes, const std::size_t &n, std::span<T> out)
+        {
+            const std::size_t len = highs.size();
+            if (!same_length(highs, lows, closes) || n == 0 || len < n || out.size() < len)
+                return false;
+
+            rolling_extreme highest(n, true), lowest(n, false);
+            for (std::size_t i = 0; i < len; i++)
             {
-                upper[i] = middle[i] + k * sd;
-                lower[i] = middle[i] - k * sd;
+                const double hh = highest.update(highs[i]), ll = lowest.update(lows[i]);
+                if (i < n - 1)
+                {
+                    out[i] = std::numeric_limits<T>::quiet_NaN();
+                    continue;
+                }
+                const double range = hh - ll, c = closes[i];
+                out[i] = range != 0 || std::isnan(c) ? -100.0 * (hh - c) / range : 0.0;
             }
+            return true;
         }
 
-        std::vector<std::vector<double>> bb(3);
-        bb[0] = std::move(middle);
-        bb[1] = std::move(upper);
-        bb[2] = std::move(lower);
+        template <typename T>
+        bool aroon(std::span<const T> highs, std::span<const T> lows, const std::size_t &n, std::span<T> up, std::span<T> down)
+        {
+            const std::size_t len = highs.size();
+            if (!same_length(highs, lows) || n == 0 || len <= n || up.size() < len || down.size() < len)
+                return false;
+
+            rolling_extreme highest(n + 1, true), lowest(n + 1, false);
+            for (std::size_t i = 0; i < len; i++)
+            {
+                const double hh = highest.update(highs[i]), ll = lowest.update(lows[i]);
+                if (i < n)
+                    up[i] = down[i] = std::numeric_limits<T>::quiet_NaN();
+                else
+                {
+                    up[i] = std::isnan(hh) ? hh : 100.0 * (double)(n - highest.age()) / n;
+                    down[i] = std::isnan(ll) ? ll : 100.0 * (double)(n - lowest.age()) / n;
+                }
+            }
+            return true;
+        }
+
+        // vector form of a span form, empty when it fails
+        template <typename T, typename F>
+        std::vector<T> collect(const std::size_t &len, F &&fill)
+        {
+            std::vector<T> res(len);
+            if (!fill(std::span<T>(res)))
+                return {};
+            return res;
+        }
+    }
 
-        return bb;
+    std::vector<double> SMA(std::span<const double> prices, const std::size_t &n)
+    {
+        return collect<double>(prices.size(), [&](std::span<double> out)
+                              { return sma(prices, n, out); });
     }
 
-    std::vector<double> ATR(const std::vector<double> &highs, const std::vector<double> &lows, const std::vector<double> &closes, const std::size_t &n)
+    std::vector<double> EMA(std::span<const double> prices, const std::size_t &n)
     {
-        if (highs.size() != lows.size() || highs.size() != closes.size() || highs.empty())
-            return {};
+        return collect<double>(prices.size(), [&](std::span<double> out)
+                              { return ema(prices, n, out); });
+    }
+
+    std::vector<double> WMA(std::span<const double> prices, const char *weights, const std::size_t &n)
+    {
+        return collect<double>(prices.size(), [&](std::span<double> out)
+                              { return wma(prices, weights, n, out, arena::local()); });
+    }
+
+    std::vector<double> VWMA(std::span<const double> prices, std::span<const double> volumes, const std::size_t &n)
+    {
+        return collect<double>(prices.size(), [&](std::span<double> out)
+                              { return vwma(prices, volumes, n, out); });
+    }
+
+    std::vector<double> MACD(std::span<const double> prices, const std::size_t &fast, const std::size_t &slow)
+    {
+        return collect<double>(prices.size(), [&](std::span<double> out)
+                              { return macd(prices, fast, slow, out, arena::local()); });
+    }
+
+    std::vector<double> RSI(std::span<const double> prices, const std::size_t &n)
+    {
+        return collect<double>(prices.size(), [&](std::span<double> out)
+                              { return rsi(prices, n, out, arena::local()); });
+    }
+
+    std::vector<double> BollingerBands(std::span<const double> prices, const std::size_t n, const double &k)
+    {
+        const std::size_t len = prices.size();
+        return collect<double>(3 * len, [&](std::span<double> out)
+                              { return bollinger_bands(prices, n, k, out.first(len), out.subspan(len, len), out.last(len), arena::local()); });
+    }
+
+    std::vector<double> ATR(std::span<const double> highs, std::span<const double> lows, std::span<const double> closes, const std::size_t &n)
+    {
+        return collect<double>(highs.size(), [&](std::span<double> out)
+                              { return atr(highs, lows, closes, n, out, arena::local()); });
+    }
+
+    std::vector<double> Momentum(std::span<const double> prices, const std::size_t n)
+    {
+        return collect<double>(prices.size(), [&](std::span<double> out)
+                              { return momentum(prices, n, out); });
+    }
+
+    std::vector<double> Donchian(std::span<const double> highs, std::span<const double> lows, const std::size_t &n)
+    {
+        const std::size_t len = highs.size();
+        return collect<double>(3 * len, [&](std::span<double> out)
+                              { return donchian(highs, lows, n, out.first(len), out.subspan(len, len), out.last(len)); });
+    }
+
+    std::vector<double> Stochastic(std::span<const double> highs, std::span<const double> lows, std::span<const double> closes, const std::size_t &n, const std::size_t &d)
+    {
+        const std::size_t len = highs.size();
+        return collect<double>(2 * len, [&](std::span<double> out)
+                              { return stochastic(highs, lows, closes, n, d, out.first(len), out.last(len)); });
+    }
+
+    std::vector<double> WilliamsR(std::span<const double> highs, std::span<const double> lows, std::span<const double> closes, const std::size_t &n)
+    {
+        return collect<double>(highs.size(), [&](std::span<double> out)
+                              { return williams_r(highs, lows, closes, n, out); });
+    }
+
+    std::vector<double> Aroon(std::span<const double> highs, std::span<const double> lows, const std::size_t &n)
+    {
+        const std::size_t len = highs.size();
+        return collect<double>(2 * len, [&](std::span<double> out)
+                              { return aroon(highs, lows, n, out.first(len), out.last(len)); });
+    }
+
+    std::vector<float> SMA(std::span<const float> prices, const std::size_t &n)
+    {
+        return collect<float>(prices.size(), [&](std::span<float> out)
+                              { return sma(prices, n, out); });
+    }
+
+    std::vector<float> EMA(std::span<const float> prices, const std::size_t &n)
+    {
+        return collect<float>(prices.size(), [&](std::span<float> out)
+                              { return ema(prices, n, out); });
+    }
+
+    std::vector<float> WMA(std::span<const float> prices, const char *weights, const std::size_t &n)
+    {
+        return collect<float>(prices.size(), [&](std::span<float> out)
+                              { return wma(prices, weights, n, out, arena::local()); });
+    }
+
+    std::vector<float> VWMA(std::span<const float> prices, std::span<const float> volumes, const std::size_t &n)
+    {
+        return collect<float>(prices.size(), [&](std::span<float> out)
+                              { return vwma(prices, volumes, n, out); });
+    }
+
+    std::vector<float> MACD(std::span<const float> prices, const std::size_t &fast, const std::size_t &slow)
+    {
+        return collect<float>(prices.size(), [&](std::span<float> out)
+                              { return macd(prices, fast, slow, out, arena::local()); });
+    }
+
+    std::vector<float> RSI(std::span<const float> prices, const std::size_t &n)
+    {
+        return collect<float>(prices.size(), [&](std::span<float> out)
+                              { return rsi(prices, n, out, arena::local()); });
+    }
+
+    std::vector<float> BollingerBands(std::span<const float> prices, const std::size_t n, const double &k)
+    {
+        const std::size_t len = prices.size();
+        return collect<float>(3 * len, [&](std::span<float> out)
+                              { return bollinger_bands(prices, n, k, out.first(len), out.subspan(len, len), out.last(len), arena::local()); });
+    }
+
+    std::vector<float> ATR(std::span<const float> highs, std::span<const float> lows, std::span<const float> closes, const std::size_t &n)
+    {
+        return collect<float>(highs.size(), [&](std::span<float> out)
+                              { return atr(highs, lows, closes, n, out, arena::local()); });
+    }
+
+    std::vector<float> Momentum(std::span<const float> prices, const std::size_t n)
+    {
+        return collect<float>(prices.size(), [&](std::span<float> out)
+                              { return momentum(prices, n, out); });
+    }
+
+    std::vector<float> Donchian(std::span<const float> highs, std::span<const float> lows, const std::size_t &n)
+    {
+        const std::size_t len = highs.size();
+        return collect<float>(3 * len, [&](std::span<float> out)
+                              { return donchian(highs, lows, n, out.first(len), out.subspan(len, len), out.last(len)); });
+    }
+
+    std::vector<float> Stochastic(std::span<const float> highs, std::span<const float> lows, std::span<const float> closes, const std::size_t &n, const std::size_t &d)
+    {
+        const std::size_t len = highs.size();
+        return collect<float>(2 * len, [&](std::span<float> out)
+                              { return stochastic(highs, lows, closes, n, d, out.first(len), out.last(len)); });
+    }
+
+    std::vector<float> WilliamsR(std::span<const float> highs, std::span<const float> lows, std::span<const float> closes, const std::size_t &n)
+    {
+        return collect<float>(highs.size(), [&](std::span<float> out)
+                              { return williams_r(highs, lows, closes, n, out); });
+    }
+
+    std::vector<float> Aroon(std::span<const float> highs, std::span<const float> lows, const std::size_t &n)
+    {
+        const std::size_t len = highs.size();
+        return collect<float>(2 * len, [&](std::span<float> out)
+                              { return aroon(highs, lows, n, out.first(len), out.last(len)); });
+    }
+
+    bool SMA(std::span<const double> prices, const std::size_t &n, std::span<double> out)
+    {
+        return sma(prices, n, out);
+    }
+
+    bool EMA(std::span<const double> prices, const std::size_t &n, std::span<double> out)
+    {
+        return ema(prices, n, out);
+    }
+
+    bool WMA(std::span<const double> prices, const char *weights, const std::size_t &n, std::span<double> out, arena &scratch)
+    {
+        return wma(prices, weights, n, out, scratch);
+    }
+
+    bool VWMA(std::span<const double> prices, std::span<const double> volumes, const std::size_t &n, std::span<double> out)
+    {
+        return vwma(prices, volumes, n, out);
+    }
+
+    bool MACD(std::span<const double> prices, const std::size_t &fast, const std::size_t &slow, std::span<double> out, arena &scratch)
+    {
+        return macd(prices, fast, slow, out, scratch);
+    }
+
+    bool RSI(std::span<const double> prices, const std::size_t &n, std::span<double> out, arena &scratch)
+    {
+        return rsi(prices, n, out, scratch);
+    }
+
+    bool BollingerBands(std::span<const double> prices, const std::size_t n, const double &k, std::span<double> middle, std::span<double> upper, std::span<double> lower, arena &scratch)
+    {
+        return bollinger_bands(prices, n, k, middle, upper, lower, scratch);
+    }
+
+    bool ATR(std::span<const double> highs, std::span<const double> lows, std::span<const double> closes, const std::size_t &n, std::span<double> out, arena &scratch)
+    {
+        return atr(highs, lows, closes, n, out, scratch);
+    }
+
+    bool Momentum(std::span<const double> prices, const std::size_t n, std::span<double> out)
+    {
+        return momentum(prices, n, out);
+    }
+
+    bool Donchian(std::span<const double> highs, std::span<const double> lows, const std::size_t &n, std::span<double> middle, std::span<double> upper, std::span<double> lower)
+    {
+        return donchian(highs, lows, n, middle, upper, lower);
+    }
+
+    bool Stochastic(std::span<const double> highs, std::span<const double> lows, std::span<const double> closes, const std::size_t &n, const std::size_t &d, std::span<double> k, std::span<double> d_out)
+    {
+        return stochastic(highs, lows, closes, n, d, k, d_out);
+    }
 
-        std::vector<double> true_range(highs.size(), std::numeric_limits<double>::quiet_NaN());
-        true_range[0] = highs[0] - lows[0];
+    bool WilliamsR(std::span<const double> highs, std::span<const double> lows, std::span<const double> closes, const std::size_t &n, std::span<double> out)
+    {
+        return williams_r(highs, lows, closes, n, out);
+    }
 
-        for (std::size_t i = 1; i < highs.size(); i++)
+    bool Aroon(std::span<const double> highs, std::span<const double> lows, const std::size_t &n, std::span<double> up, std::span<double> down)
+    {
+        return aroon(highs, lows, n, up, down);
+    }
+
+    bool SMA(std::span<const float> prices, const std::size_t &n, std::span<float> out)
+    {
+        return sma(prices, n, out);
+    }
+
+    bool EMA(std::span<const float> prices, const std::size_t &n, std::span<float> out)
+    {
+        return ema(prices, n, out);
+    }
+
+    bool WMA(std::span<const float> prices, const char *weights, const std::size_t &n, std::span<float> out, arena &scratch)
+    {
+        return wma(prices, weights, n, out, scratch);
+    }
+
+    bool VWMA(std::span<const float> prices, std::span<const float> volumes, const std::size_t &n, std::span<float> out)
+    {
+        return vwma(prices, volumes, n, out);
+    }
+
+    bool MACD(std::span<const float> prices, const std::size_t &fast, const std::size_t &slow, std::span<float> out, arena &scratch)
+    {
+        return macd(prices, fast, slow, out, scratch);
+    }
+
+    bool RSI(std::span<const float> prices, const std::size_t &n, std::span<float> out, arena &scratch)
+    {
+        return rsi(prices, n, out, scratch);
+    }
+
+    bool BollingerBands(std::span<const float> prices, const std::size_t n, const double &k, std::span<float> middle, std::span<float> upper, std::span<float> lower, arena &scratch)
+    {
+        return bollinger_bands(prices, n, k, middle, upper, lower, scratch);
+    }
+
+    bool ATR(std::span<const float> highs, std::span<const float> lows, std::span<const float> closes, const std::size_t &n, std::span<float> out, arena &scratch)
+    {
+        return atr(highs, lows, closes, n, out, scratch);
+    }
+
+    bool Momentum(std::span<const float> prices, const std::size_t n, std::span<float> out)
+    {
+        return momentum(prices, n, out);
+    }
+
+    bool Donchian(std::span<const float> highs, std::span<const float> lows, const std::size_t &n, std::span<float> middle, std::span<float> upper, std::span<float> lower)
+    {
+        return donchian(highs, lows, n, middle, upper, lower);
+    }
+
+    bool Stochastic(std::span<const float> highs, std::span<const float> lows, std::span<const float> closes, const std::size_t &n, const std::size_t &d, std::span<float> k, std::span<float> d_out)
+    {
+        return stochastic(highs, lows, closes, n, d, k, d_out);
+    }
+
+    bool WilliamsR(std::span<const float> highs, std::span<const float> lows, std::span<const float> closes, const std::size_t &n, std::span<float> out)
+    {
+        return williams_r(highs, lows, closes, n, out);
+    }
+
+    bool Aroon(std::span<const float> highs, std::span<const float> lows, const std::size_t &n, std::span<float> up, std::span<float> down)
+    {
+        return aroon(highs, lows, n, up, down);
+    }
+
+    std::vector<double> SMA_multi(std::span<const double> prices, std::span<const std::size_t> periods)
+    {
+        const std::size_t len = prices.size();
+        std::vector<double> res(periods.size() * len, std::numeric_limits<double>::quiet_NaN());
+
+        // double-double prefix sums: window sum = (hi[i] - hi[i - n]) + (lo[i] - lo[i - n])
+        std::vector<double> hi(len + 1, 0.0), lo(len + 1, 0.0);
+        for (std::size_t i = 0; i < len; i++)
         {
-            true_range[i] = MAX_3(highs[i] - lows[i], std::abs(highs[i] - closes[i - 1]), std::abs(lows[i] - closes[i - 1]));
+            double s = hi[i] + prices[i];
+            double bp = s - hi[i];
+            double err = (hi[i] - (s - bp)) + (prices[i] - bp);
+            hi[i + 1] = s;
+            lo[i + 1] = lo[i] + err;
         }
 
-        return SMA(true_range, n);
+        const std::vector<std::size_t> order = sweep_order(periods, len);
+        for (std::size_t base = 0; base < len; base += SWEEP_BLOCK)
+        {
+            const std::size_t end = std::min(base + SWEEP_BLOCK, len);
+            for (const std::size_t &r : order)
+            {
+                const std::size_t n = periods[r];
+                double *row = res.data() + r * len;
+                for (std::size_t i = std::max(base, n - 1); i < end; i++)
+                    row[i] = ((hi[i + 1] - hi[i + 1 - n]) + (lo[i + 1] - lo[i + 1 - n])) / n;
+            }
+        }
+        return res;
     }
 
-    std::vector<double> Momentum(const std::vector<double> &prices, const std::size_t n)
+    std::vector<double> EMA_multi(std::span<const double> prices, std::span<const std::size_t> periods)
     {
-        if (n == 0 || prices.size() <= n)
-            return {};
-        std::vector<double> momentum_values(prices.size(), std::numeric_limits<double>::quiet_NaN());
-        for (std::size_t i = n; i < prices.size(); i++)
-            momentum_values[i] = prices[i] - prices[i - n];
-        return momentum_values;
+        const std::size_t len = prices.size();
+        std::vector<double> res(periods.size() * len, std::numeric_limits<double>::quiet_NaN());
+        const std::vector<std::size_t> order = sweep_order(periods, len);
+
+        // coefficients, seeds and carried state of each lane group, periods ascending; aligned for the widest
+        // clone, the default target only aligns vectors to 16 bytes
+        struct alignas(sizeof(lanes_pd)) lane_group
+        {
+            lanes_pd alpha, beta, seed, state;
+            lanes_pi start;
+        };
+        std::vector<lane_group> groups;
+        for (std::size_t g = 0; g < order.size(); g += LANES)
+        {
+            const std::size_t used = std::min(LANES, order.size() - g);
+            lanes_pd alpha{}, seed{};
+            // unused lanes never reach their start and stay NaN
+            lanes_pi start = lanes_pi{} - 1;
+            for (std::size_t l = 0; l < used; l++)
+            {
+                const std::size_t n = periods[order[g + l]];
+                alpha[l] = 2.00 / (n + 1.00);
+                seed[l] = vector_mean(prices.data(), n);
+                start[l] = n - 1;
+            }
+            groups.push_back({alpha, 1 - alpha, seed, lanes_pd{} + std::numeric_limits<double>::quiet_NaN(), start});
+        }
+        if (groups.empty())
+            return res;
+
+        // every lane group runs over a block while its prices are in L1, so the prices are read once however
+        // many periods are swept; nothing before the first seed bar needs computing
+        alignas(sizeof(lanes_pd)) lanes_pd block[SWEEP_BLOCK];
+        for (std::size_t base = groups[0].start[0]; base < len; base += SWEEP_BLOCK)
+        {
+            const std::size_t m = std::min(SWEEP_BLOCK, len - base);
+            for (std::size_t k = 0; k < groups.size() && (std::size_t)groups[k].start[0] < base + m; k++)
+            {
+                lane_group &gr = groups[k];
+                const std::size_t g = k * LANES;
+                ema_lanes(prices.data() + base, base, m, gr.alpha, gr.beta, gr.start, gr.seed, gr.state, block);
+                sweep_scatter((const double *)block, order.data() + g, std::min(LANES, order.size() - g), m, res.data(), len, base);
+            }
+        }
+        return res;
+    }
+
+    std::vector<double> RSI_multi(std::span<const double> prices, std::span<const std::size_t> periods)
+    {
+        const std::size_t len = prices.size();
+        std::vector<double> res(periods.size() * len, std::numeric_limits<double>::quiet_NaN());
+        if (len < 2)
+            return res;
+        const std::vector<std::size_t> order = sweep_order(periods, len - 1);
+
+        std::vector<double> gains(len, 0), losses(len, 0);
+        for (std::size_t i = 1; i < len; i++)
+        {
+            double delta = prices[i] - prices[i - 1];
+            if (delta > 0)
+                gains[i] = delta;
+            else
+                losses[i] = -delta;
+        }
+
+        struct alignas(sizeof(lanes_pd)) lane_group
+        {
+            lanes_pd nm1, nd, seed_gains, seed_losses, mean_gains, mean_losses;
+            lanes_pi start;
+        };
+        std::vector<lane_group> groups;
+        for (std::size_t g = 0; g < order.size(); g += LANES)
+        {
+            const std::size_t used = std::min(LANES, order.size() - g);
+            lanes_pd nm1{}, nd = lanes_pd{} + 1, seed_gains{}, seed_losses{};
+            lanes_pi start = lanes_pi{} - 1;
+            for (std::size_t l = 0; l < used; l++)
+            {
+                const std::size_t n = periods[order[g + l]];
+                nm1[l] = n - 1;
+                nd[l] = n;
+                seed_gains[l] = vector_mean(gains.data(), n);
+                seed_losses[l] = vector_mean(losses.data(), n);
+                start[l] = n;
+            }
+            const lanes_pd nan = lanes_pd{} + std::numeric_limits<double>::quiet_NaN();
+            groups.push_back({nm1, nd, seed_gains, seed_losses, nan, nan, start});
+        }
+        if (groups.empty())
+            return res;
+
+        // blocks outside, lane groups inside, as in `EMA_multi`
+        alignas(sizeof(lanes_pd)) lanes_pd block[SWEEP_BLOCK];
+        for (std::size_t base = groups[0].start[0]; base < len; base += SWEEP_BLOCK)
+        {
+            const std::size_t m = std::min(SWEEP_BLOCK, len - base);
+            for (std::size_t k = 0; k < groups.size() && (std::size_t)groups[k].start[0] < base + m; k++)
+            {
+                lane_group &gr = groups[k];
+                const std::size_t g = k * LANES;
+                rsi_lanes(gains.data() + base, losses.data() + base, base, m, gr.nm1, gr.nd, gr.start, gr.seed_gains, gr.seed_losses, gr.mean_gains, gr.mean_losses, block);
+                sweep_scatter((const double *)block, order.data() + g, std::min(LANES, order.size() - g), m, res.data(), len, base);
+            }
+        }
+        return res;
     }
 }
@@ -12,6 +12,16 @@
 #include <cmath>
 #include <span>
 #include <cstring>
+#include <limits>
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <complex>
+#include <mutex>
+#include <map>
+#include <utility>
+#include <bit>
+#include <numbers>
 
 #include "../simd_math/simd_math.h"
 
@@ -21,6 +31,199 @@
 
 namespace core::indicators
 {
+    /**
+     * @brief Scratch memory for the temporaries of the indicators (RSI's seed gains, MACD's second EMA, ATR's
+     * true ranges, ...)
+     *
+     * Doubles are carved out of blocks that are kept when a `scope` gives them back, so once an arena has served
+     * the largest run, later runs allocate nothing. Not thread-safe, every thread uses its own.
+     */
+    class arena
+    {
+    public:
+        arena() = default;
+        arena(const arena &) = delete;
+        arena &operator=(const arena &) = delete;
+
+        /**
+         * @brief `n` uninitialized doubles, valid until the innermost `scope` open at the call ends
+         */
+        std::span<double> take(const std::size_t &n);
+
+        /**
+         * @brief Doubles held in the blocks
+         */
+        std::size_t capacity() const;
+
+        /**
+         * @brief Frees the blocks, outside of any `scope`
+         */
+        void release();
+
+        /**
+         * @brief Arena of the calling thread, the default of the span forms of the indicators
+         */
+        static arena &local();
+
+        /**
+         * @brief Gives everything taken from the arena during its lifetime back on destruction
+         */
+        class scope
+        {
+        public:
+            explicit scope(arena &owner) : owner(owner), block(owner.block), used(owner.used) {}
+            ~scope()
+            {
+                owner.block = block;
+                owner.used = used;
+            }
+
+            scope(const scope &) = delete;
+            scope &operator=(const scope &) = delete;
+
+        private:
+            arena &owner;
+            std::size_t block, used;
+        };
+
+    private:
+        // smallest block, 1 MiB
+        static constexpr std::size_t MIN_BLOCK = std::size_t(1) << 17;
+
+        std::vector<std::unique_ptr<double[]>> blocks;
+        std::vector<std::size_t> sizes;
+        // block being carved and the doubles already taken from it
+        std::size_t block = 0, used = 0;
+    };
+
+    /**
+     * @brief Population variance of a sliding window in O(1) per slide (Welford update)
+     *
+     * The first full window and every `reanchor` slides after it are recomputed with a two-pass sum over
+     * the window, so rounding error cannot accumulate over long series. Feeding the same windows in the
+     * same order always gives the same bits, which keeps the batch and streaming indicators identical.
+     */
+    class rolling_variance
+    {
+    public:
+        explicit rolling_variance(const std::size_t &n);
+
+        /**
+         * @brief Slides the window by one value
+         *
+         * @param window The `n` values of the new window, oldest first
+         * @param out Value that left the window since the previous call (ignored on the first call)
+         * @return Population variance of `window`
+         */
+        double update(const double *window, const double &out);
+        double update(const float *window, const float &out);
+
+    private:
+        template <typename T>
+        double slide(const T *window, const double &out);
+
+        std::size_t n, reanchor, slides = 0;
+        double mean = 0.0, m2 = 0.0;
+    };
+
+    /**
+     * @brief Sliding sums of price * volume and volume in O(1) per slide
+     *
+     * The sums are compensated (Neumaier) and re-anchored like `rolling_variance`, and also as soon as a
+     * non-finite value has left the window.
+     */
+    class rolling_vwma
+    {
+    public:
+        explicit rolling_vwma(const std::size_t &n);
+
+        /**
+         * @brief Slides the window by one bar
+         *
+         * @param prices The `n` prices of the new window, oldest first
+         * @param volumes The `n` volumes of the new window, oldest first
+         * @param out_price Price that left the window since the previous call (ignored on the first call)
+         * @param out_volume Volume that left the window since the previous call (ignored on the first call)
+         * @return Volume-weighted mean of the window, NaN if the volumes sum to 0 or a value is not finite
+         */
+        double update(const double *prices, const double *volumes, const double &out_price, const double &out_volume);
+        double update(const float *prices, const float *volumes, const float &out_price, const float &out_volume);
+
+    private:
+        template <typename T>
+        void anchor(const T *prices, const T *volumes);
+        template <typename T>
+        double slide(const T *prices, const T *volumes, const double &out_price, const double &out_volume);
+
+        std::size_t n, reanchor, slides = 0, zeros = 0, non_finite = 0;
+        double pv_sum = 0.0, vl_sum = 0.0, pv_c = 0.0, vl_c = 0.0;
+    };
+
+    /**
+     * @brief Maximum (or minimum) of a sliding window in amortized O(1) per slide
+     *
+     * A monotonic deque of (bar, value) candidates kept in a ring buffer sized once, so sliding allocates
+     * nothing: a new value drops every older candidate it dominates, and the front leaves once it is `n`
+     * bars old. A window holding a NaN is NaN.
+     */
+    class rolling_extreme
+    {
+    public:
+        /**
+         * @param n Number of values in the window
+         * @param maximum true for the maximum, false for the minimum
+         */
+        rolling_extreme(const std::size_t &n, const bool &maximum);
+
+        /**
+         * @brief Slides the window by one value
+         *
+         * @return Extreme of the last `n` values (of every value so far until `n` were seen)
+         */
+        double update(const double &value);
+        double value() const;
+
+        /**
+         * @brief Values since the extreme was seen, the most recent one if it is tied
+         */
+        std::size_t age() const { return size == 0 ? 0 : bars - 1 - ring[head].bar; }
+
+    private:
+        struct entry
+        {
+            std::size_t bar;
+            double value;
+        };
+
+        std::size_t n, mask;
+        bool maximum;
+        std::vector<entry> ring;
+        std::size_t head = 0, size = 0, bars = 0, nan_end = 0;
+    };
+
+    /**
+     * @brief Weight schemes of WMA, each with its own kernel
+     */
+    enum class weighting : std::uint8_t
+    {
+        LINEAR,
+        NORMALIZED_LINEAR,
+        HARMONIC,
+        TRIANGULAR,
+        QUADRATIC,
+        CUBIC,
+        ROOT,
+        UNKNOWN
+    };
+
+    /**
+     * @brief Resolves a weight type name to its scheme
+     *
+     * @param __Type Type of weights {"linear", "harmonic", "triangular", "normalized linear", "quadratic", "cubic", "root"}
+     * @return Scheme of `__Type`, `weighting::UNKNOWN` if unknown (or null)
+     */
+    weighting resolve_weighting(const char *__Type);
+
     /**
      * @brief Returns weights array of type `__Type`
      *
@@ -37,7 +240,7 @@ namespace core::indicators
      * @param n Number of periods
      * @return Average price over a specific number of periods, indicating trend direction.
      */
-    std::vector<double> SMA(const std::vector<double> &prices, const std::size_t &n);
+    std::vector<double> SMA(std::span<const double> prices, const std::size_t &n);
 
     /**
      * @brief EMA(Exponential Moving Average) Indicator
@@ -46,27 +249,35 @@ namespace core::indicators
      * @param n Number of periods
      * @return Responds faster to recent price changes
      */
-    std::vector<double> EMA(const std::vector<double> &prices, const std::size_t &n);
+    std::vector<double> EMA(std::span<const double> prices, const std::size_t &n);
 
     /**
      * @brief WMA(Weighted Moving Average) Indicator
      *
+     * The first weight applies to the newest price. Linear and normalized linear weights slide two running sums
+     * and triangular weights (an SMA of an SMA) three, re-anchored like `rolling_variance`, so they are O(N) for
+     * any period. The other schemes are a convolution: a SIMD dot product per bar, or overlap-save FFT blocks
+     * for long periods. Both match the per-window sums to within 1e-12 x price; a window holding a non-finite
+     * price is summed directly. Weight tables are built once per (scheme, n) and shared between calls.
+     *
      * @param prices Price over n periods
      * @param weights Weight for period
      * @param n Number of periods
      * @return Applies custom weights to price data
      */
-    std::vector<double> WMA(const std::vector<double> &prices, const char *weights, const std::size_t &n);
+    std::vector<double> WMA(std::span<const double> prices, const char *weights, const std::size_t &n);
 
     /**
      * @brief VWMA(Volume-Weighted Moving Average) Indicator
      *
+     * O(N) with `rolling_vwma`; matches the per-window sums to within 1e-11 x price.
+     *
      * @param prices Price over n periods
      * @param volumes Volumes for period
      * @param n Number of periods
      * @return Weights price by trading volume
      */
-    std::vector<double> VWMA(const std::vector<double> &prices, const std::vector<double> &volumes, const std::size_t &n);
+    std::vector<double> VWMA(std::span<const double> prices, std::span<const double> volumes, const std::size_t &n);
 
     /**
      * @brief MACD(Moving Average Convergence/Divergence) Indicator
@@ -76,7 +287,7 @@ namespace core::indicators
      * @param slow EMA periods
      * @return Shows momentum by EMA difference
      */
-    std::vector<double> MACD(const std::vector<double> &prices, const std::size_t &fast, const std::size_t &slow);
+    std::vector<double> MACD(std::span<const double> prices, const std::size_t &fast, const std::size_t &slow);
 
     /**
      * @brief RSI(Relative Strength Index) Indicator
@@ -85,17 +296,21 @@ namespace core::indicators
      * @param n Number of periods
      * @return Measures overbought/oversold conditions
      */
-    std::vector<double> RSI(const std::vector<double> &prices, const std::size_t &n);
+    std::vector<double> RSI(std::span<const double> prices, const std::size_t &n);
 
     /**
      * @brief Bollinger Bands Indicator
      *
+     * O(N) with `rolling_variance`; the bands match the per-window `vector_std_deviation` to within
+     * 1e-10 x price for n >= 5. Below that the one-pass per-window variance is the less accurate of the
+     * two and could even turn negative (NaN bands), the rolling variance is clamped at 0.
+     *
      * @param prices Price over n periods
      * @param n Number of periods
      * @param k multiplier
-     * @return Visualizes volatility bands
+     * @return Visualizes volatility bands, as one row-major 3 x N buffer {middle, upper, lower}
      */
-    std::vector<std::vector<double>> BollingerBands(const std::vector<double> &prices, const std::size_t n, const double &k);
+    std::vector<double> BollingerBands(std::span<const double> prices, const std::size_t n, const double &k);
 
     /**
      * @brief  ATR(Average True Range) Indicator
@@ -106,7 +321,7 @@ namespace core::indicators
      * @param n Number of periods
      * @return Measures market volatility
      */
-    std::vector<double> ATR(const std::vector<double> &highs, const std::vector<double> &lows, const std::vector<double> &closes, const std::size_t &n);
+    std::vector<double> ATR(std::span<const double> highs, std::span<const double> lows, std::span<const double> closes, const std::size_t &n);
 
     /**
      * @brief Momentum Indicator
@@ -115,7 +330,144 @@ namespace core::indicators
      * @param n Number of periods
      * @return Absolute price change
      */
-    std::vector<double> Momentum(const std::vector<double> &prices, const std::size_t n);
+    std::vector<double> Momentum(std::span<const double> prices, const std::size_t n);
+
+    /**
+     * @brief Donchian Channels
+     *
+     * O(N) with `rolling_extreme`.
+     *
+     * @param highs High prices over n periods
+     * @param lows Low prices over n periods
+     * @param n Number of periods
+     * @return Highest high, lowest low and their midpoint, as one row-major 3 x N buffer {middle, upper, lower}
+     */
+    std::vector<double> Donchian(std::span<const double> highs, std::span<const double> lows, const std::size_t &n);
+
+    /**
+     * @brief Stochastic Oscillator
+     *
+     * O(N) with `rolling_extreme`. %K is 0 over a window whose high equals its low.
+     *
+     * @param highs High prices over n periods
+     * @param lows Low prices over n periods
+     * @param closes Closing prices over n periods
+     * @param n Number of periods of %K
+     * @param d Number of periods of %D, the SMA of %K
+     * @return Close within the n-period range in percent, as one row-major 2 x N buffer {%K, %D}
+     */
+    std::vector<double> Stochastic(std::span<const double> highs, std::span<const double> lows, std::span<const double> closes, const std::size_t &n, const std::size_t &d);
+
+    /**
+     * @brief Williams %R
+     *
+     * O(N) with `rolling_extreme`, 0 over a window whose high equals its low.
+     *
+     * @param highs High prices over n periods
+     * @param lows Low prices over n periods
+     * @param closes Closing prices over n periods
+     * @param n Number of periods
+     * @return Distance of the close below the n-period high, from 0 to -100
+     */
+    std::vector<double> WilliamsR(std::span<const double> highs, std::span<const double> lows, std::span<const double> closes, const std::size_t &n);
+
+    /**
+     * @brief Aroon Indicator
+     *
+     * O(N) with `rolling_extreme`. The window is the last n + 1 bars, a tied extreme counts from its most
+     * recent bar.
+     *
+     * @param highs High prices over n periods
+     * @param lows Low prices over n periods
+     * @param n Number of periods
+     * @return Time since the n-period high and low, as one row-major 2 x N buffer {up, down}
+     */
+    std::vector<double> Aroon(std::span<const double> highs, std::span<const double> lows, const std::size_t &n);
+
+    /*
+     * float32 variants of the batch indicators, for screening and charting where float precision is enough:
+     * half the memory traffic. Inputs are widened as they are read and every running sum, EMA and Wilder mean
+     * is kept in double, so each result is rounded to float once, when it is stored.
+     */
+
+    std::vector<float> SMA(std::span<const float> prices, const std::size_t &n);
+    std::vector<float> EMA(std::span<const float> prices, const std::size_t &n);
+    std::vector<float> WMA(std::span<const float> prices, const char *weights, const std::size_t &n);
+    std::vector<float> VWMA(std::span<const float> prices, std::span<const float> volumes, const std::size_t &n);
+    std::vector<float> MACD(std::span<const float> prices, const std::size_t &fast, const std::size_t &slow);
+    std::vector<float> RSI(std::span<const float> prices, const std::size_t &n);
+    std::vector<float> BollingerBands(std::span<const float> prices, const std::size_t n, const double &k);
+    std::vector<float> ATR(std::span<const float> highs, std::span<const float> lows, std::span<const float> closes, const std::size_t &n);
+    std::vector<float> Momentum(std::span<const float> prices, const std::size_t n);
+    std::vector<float> Donchian(std::span<const float> highs, std::span<const float> lows, const std::size_t &n);
+    std::vector<float> Stochastic(std::span<const float> highs, std::span<const float> lows, std::span<const float> closes, const std::size_t &n, const std::size_t &d);
+    std::vector<float> WilliamsR(std::span<const float> highs, std::span<const float> lows, std::span<const float> closes, const std::size_t &n);
+    std::vector<float> Aroon(std::span<const float> highs, std::span<const float> lows, const std::size_t &n);
+
+    /*
+     * Span forms of the batch indicators: the result is written to the first `prices.size()` elements of `out`
+     * (`middle`, `upper`, `lower` for BollingerBands and Donchian, one span per row for the other multi-row
+     * indicators) and temporaries come from `scratch`, so a caller reusing its buffers allocates nothing per
+     * call; only the rolling extremes allocate their O(n) rings. The values are those of the vector forms, bit
+     * for bit. They return false, with `out` untouched, for the inputs the vector forms return empty for and
+     * for a short `out`.
+     */
+
+    bool SMA(std::span<const double> prices, const std::size_t &n, std::span<double> out);
+    bool EMA(std::span<const double> prices, const std::size_t &n, std::span<double> out);
+    bool WMA(std::span<const double> prices, const char *weights, const std::size_t &n, std::span<double> out, arena &scratch = arena::local());
+    bool VWMA(std::span<const double> prices, std::span<const double> volumes, const std::size_t &n, std::span<double> out);
+    bool MACD(std::span<const double> prices, const std::size_t &fast, const std::size_t &slow, std::span<double> out, arena &scratch = arena::local());
+    bool RSI(std::span<const double> prices, const std::size_t &n, std::span<double> out, arena &scratch = arena::local());
+    bool BollingerBands(std::span<const double> prices, const std::size_t n, const double &k, std::span<double> middle, std::span<double> upper, std::span<double> lower, arena &scratch = arena::local());
+    bool ATR(std::span<const double> highs, std::span<const double> lows, std::span<const double> closes, const std::size_t &n, std::span<double> out, arena &scratch = arena::local());
+    bool Momentum(std::span<const double> prices, const std::size_t n, std::span<double> out);
+    bool Donchian(std::span<const double> highs, std::span<const double> lows, const std::size_t &n, std::span<double> middle, std::span<double> upper, std::span<double> lower);
+    bool Stochastic(std::span<const double> highs, std::span<const double> lows, std::span<const double> closes, const std::size_t &n, const std::size_t &d, std::span<double> k, std::span<double> d_out);
+    bool WilliamsR(std::span<const double> highs, std::span<const double> lows, std::span<const double> closes, const std::size_t &n, std::span<double> out);
+    bool Aroon(std::span<const double> highs, std::span<const double> lows, const std::size_t &n, std::span<double> up, std::span<double> down);
+
+    bool SMA(std::span<const float> prices, const std::size_t &n, std::span<float> out);
+    bool EMA(std::span<const float> prices, const std::size_t &n, std::span<float> out);
+    bool WMA(std::span<const float> prices, const char *weights, const std::size_t &n, std::span<float> out, arena &scratch = arena::local());
+    bool VWMA(std::span<const float> prices, std::span<const float> volumes, const std::size_t &n, std::span<float> out);
+    bool MACD(std::span<const float> prices, const std::size_t &fast, const std::size_t &slow, std::span<float> out, arena &scratch = arena::local());
+    bool RSI(std::span<const float> prices, const std::size_t &n, std::span<float> out, arena &scratch = arena::local());
+    bool BollingerBands(std::span<const float> prices, const std::size_t n, const double &k, std::span<float> middle, std::span<float> upper, std::span<float> lower, arena &scratch = arena::local());
+    bool ATR(std::span<const float> highs, std::span<const float> lows, std::span<const float> closes, const std::size_t &n, std::span<float> out, arena &scratch = arena::local());
+    bool Momentum(std::span<const float> prices, const std::size_t n, std::span<float> out);
+    bool Donchian(std::span<const float> highs, std::span<const float> lows, const std::size_t &n, std::span<float> middle, std::span<float> upper, std::span<float> lower);
+    bool Stochastic(std::span<const float> highs, std::span<const float> lows, std::span<const float> closes, const std::size_t &n, const std::size_t &d, std::span<float> k, std::span<float> d_out);
+    bool WilliamsR(std::span<const float> highs, std::span<const float> lows, std::span<const float> closes, const std::size_t &n, std::span<float> out);
+    bool Aroon(std::span<const float> highs, std::span<const float> lows, const std::size_t &n, std::span<float> up, std::span<float> down);
+
+    /**
+     * @brief SMA for many periods in one pass, from a shared compensated prefix sum
+     *
+     * @param prices Price over n periods
+     * @param periods Number of periods of each row
+     * @return Row-major periods.size() x prices.size() matrix, a row is all NaN if its period is 0 or longer than the series.
+     * Rows agree with `SMA` to the rounding of the window sum (the running sum of `SMA` is the less accurate one).
+     */
+    std::vector<double> SMA_multi(std::span<const double> prices, std::span<const std::size_t> periods);
+
+    /**
+     * @brief EMA for many periods in one pass, the periods run side by side in SIMD lanes
+     *
+     * @param prices Price over n periods
+     * @param periods Number of periods of each row
+     * @return Row-major periods.size() x prices.size() matrix, each valid row identical to `EMA`, invalid rows all NaN
+     */
+    std::vector<double> EMA_multi(std::span<const double> prices, std::span<const std::size_t> periods);
+
+    /**
+     * @brief RSI for many periods in one pass, the Wilder smoothings run side by side in SIMD lanes
+     *
+     * @param prices Price over n periods
+     * @param periods Number of periods of each row
+     * @return Row-major periods.size() x prices.size() matrix, each valid row identical to `RSI`, invalid rows all NaN
+     */
+    std::vector<double> RSI_multi(std::span<const double> prices, std::span<const std::size_t> periods);
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,339 @@
+/**
+ * @file pipeline.cc
+ * @license This file is licensed under the GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007. You may obtain a copy of this license at https://www.gnu.org/licenses/gpl-3.0.en.html.
+ * @author Tushar Chaurasia (Dark-CodeX)
+ */
+
+#include "./pipeline.hh"
+
+namespace core::indicators::pipeline
+{
+    namespace
+    {
+        // bars per block, the prices, the per-bar intermediates and a few node columns of a block fit in L1/L2
+        constexpr std::size_t BLOCK = 512;
+    }
+
+    plan::plan(std::span<const universe::spec> specs)
+    {
+        for (const universe::spec &sp : specs)
+        {
+            step st;
+            st.spec = sp;
+            switch (sp.indicator)
+            {
+            case universe::kind::SMA:
+                st.a = share(source::PRICE_SUM, sp.n);
+                break;
+            case universe::kind::EMA:
+                st.a = share(source::EMA, sp.n);
+                break;
+            case universe::kind::MACD:
+                st.a = share(source::EMA, sp.n);
+                st.b = share(source::EMA, sp.slow);
+                break;
+            case universe::kind::BOLLINGER_BANDS:
+                st.a = share(source::PRICE_SUM, sp.n);
+                st.b = share(source::DEVIATION, sp.n);
+                break;
+            case universe::kind::ATR:
+                st.a = share(source::TRUE_RANGE_SUM, sp.n);
+                break;
+            case universe::kind::RSI:
+                st.a = share(source::RSI, sp.n);
+                break;
+            case universe::kind::VWMA:
+                st.a = share(source::VWMA, sp.n);
+                break;
+            default:
+                break;
+            }
+            steps.emplace_back(std::move(st));
+        }
+    }
+
+    std::size_t plan::share(const source &what, const std::size_t &n)
+    {
+        auto [it, inserted] = index.try_emplace({what, n}, nodes.size());
+        if (inserted)
+            nodes.push_back({what, n});
+        return it->second;
+    }
+
+    bool plan::valid(const step &st, const universe::series &s) const
+    {
+        // the inputs the batch functions accept
+        const std::size_t len = s.prices.size(), n = st.spec.n;
+        switch (st.spec.indicator)
+        {
+        case universe::kind::SMA:
+        case universe::kind::EMA:
+        case universe::kind::WMA:
+        case universe::kind::BOLLINGER_BANDS:
+            return n != 0 && len >= n;
+        case universe::kind::VWMA:
+            return n != 0 && len >= n && s.volumes.size() >= n;
+        case universe::kind::MACD:
+            return n != 0 && st.spec.slow != 0 && len >= std::max(n, st.spec.slow);
+        case universe::kind::RSI:
+        case universe::kind::MOMENTUM:
+            return n != 0 && len > n;
+        case universe::kind::ATR:
+        case universe::kind::DONCHIAN:
+        case universe::kind::WILLIAMS_R:
+            return s.highs.size() == len && s.lows.size() == len && len != 0 && n != 0 && len >= n;
+        case universe::kind::STOCHASTIC:
+            return s.highs.size() == len && s.lows.size() == len && n != 0 && st.spec.slow != 0 && len >= n;
+        case universe::kind::AROON:
+            return s.highs.size() == len && s.lows.size() == len && n != 0 && len > n;
+        default:
+            return false;
+        }
+    }
+
+    std::size_t plan::output_size(const std::size_t &i, const std::size_t &len) const
+    {
+        return universe::rows(steps[i].spec.indicator) * len;
+    }
+
+    std::vector<bool> plan::run(const universe::series &s, std::span<const std::span<double>> outputs) const
+    {
+        const std::size_t len = s.prices.size(), N = nodes.size();
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        const double *p = s.prices.data(), *hi = s.highs.data(), *lo = s.lows.data(), *vl = s.volumes.data();
+
+        // only the intermediates of the specs that run are advanced
+        std::vector<bool> done(steps.size(), false), live(N, false);
+        for (std::size_t i = 0; i < steps.size(); i++)
+        {
+            done[i] = i < outputs.size() && outputs[i].size() == output_size(i, len) && valid(steps[i], s);
+            if (done[i] && steps[i].a != NONE)
+                live[steps[i].a] = true;
+            if (done[i] && steps[i].b != NONE)
+                live[steps[i].b] = true;
+        }
+
+        // running state of every intermediate: the rolling sum, the EMA or the mean gains (x) and mean losses (y)
+        std::vector<double> x(N, 0.0), y(N, 0.0);
+        std::vector<rolling_variance> deviations;
+        std::vector<rolling_vwma> vwmas;
+        std::vector<std::size_t> slot(N, 0);
+        bool true_ranges = false, deltas = false;
+        // longest RSI seed window
+        std::size_t seed = 0;
+        for (std::size_t k = 0; k < N; k++)
+        {
+            if (!live[k])
+                continue;
+            if (nodes[k].what == source::DEVIATION)
+            {
+                slot[k] = deviations.size();
+                deviations.emplace_back(nodes[k].n);
+            }
+            else if (nodes[k].what == source::VWMA)
+            {
+                slot[k] = vwmas.size();
+                vwmas.emplace_back(nodes[k].n);
+            }
+            true_ranges |= nodes[k].what == source::TRUE_RANGE_SUM;
+            deltas |= nodes[k].what == source::RSI;
+            if (nodes[k].what == source::RSI)
+                seed = std::max(seed, nodes[k].n);
+        }
+
+        auto true_range = [&](const std::size_t &i)
+        {
+            if (i == 0)
+                return hi[0] - lo[0];
+            return MAX_3(hi[i] - lo[i], std::abs(hi[i] - p[i - 1]), std::abs(lo[i] - p[i - 1]));
+        };
+
+        std::vector<double> column(N * BLOCK), tr(true_ranges ? BLOCK : 0), gains(deltas ? BLOCK : 0), losses(deltas ? BLOCK : 0);
+        // gains/losses of the seed window of every RSI, taken once for the longest one
+        arena::scope temporaries(arena::local());
+        const std::span<double> seed_gains = arena::local().take(seed), seed_losses = arena::local().take(seed);
+        for (std::size_t base = 0; base < len; base += BLOCK)
+        {
+            const std::size_t end = std::min(base + BLOCK, len);
+
+            // per-bar intermediates, computed once for every ATR and RSI
+            if (true_ranges)
+            {
+                for (std::size_t i = base; i < end; i++)
+                    tr[i - base] = true_range(i);
+            }
+            if (deltas)
+            {
+                for (std::size_t i = base; i < end; i++)
+                {
+                    double delta = i == 0 ? 0.0 : p[i] - p[i - 1];
+                    gains[i - base] = losses[i - base] = 0;
+                    if (delta > 0)
+                        gains[i - base] = delta;
+                    else if (i != 0)
+                        losses[i - base] = -delta;
+                }
+            }
+
+            for (std::size_t k = 0; k < N; k++)
+            {
+                if (!live[k])
+                    continue;
+                const std::size_t n = nodes[k].n;
+                double *out = column.data() + k * BLOCK;
+                switch (nodes[k].what)
+                {
+                case source::PRICE_SUM:
+                    for (std::size_t i = base; i < end; i++)
+                    {
+                        x[k] += p[i];
+                        if (i >= n)
+                            x[k] -= p[i - n];
+                        out[i - base] = i < n - 1 ? nan : x[k] / n;
+                    }
+                    break;
+                case source::TRUE_RANGE_SUM:
+                    for (std::size_t i = base; i < end; i++)
+                    {
+                        x[k] += tr[i - base];
+                        // a range that left an earlier block is recomputed, it rounds the same
+                        if (i >= n)
+                            x[k] -= i - n >= base ? tr[i - n - base] : true_range(i - n);
+                        out[i - base] = i < n - 1 ? nan : x[k] / n;
+                    }
+                    break;
+                case source::EMA:
+                {
+                    double alpha = 2.00 / (n + 1.00);
+                    for (std::size_t i = base; i < end; i++)
+                    {
+                        if (i == n - 1)
+                            x[k] = vector_mean(p, n);
+                        else if (i >= n)
+                            x[k] = alpha * p[i] + (1 - alpha) * x[k];
+                        out[i - base] = i < n - 1 ? nan : x[k];
+                    }
+                    break;
+                }
+                case source::DEVIATION:
+                    for (std::size_t i = base; i < end; i++)
+                        out[i - base] = i < n - 1 ? nan : std::sqrt(deviations[slot[k]].update(p + i - n + 1, i >= n ? p[i - n] : 0.0));
+                    break;
+                case source::RSI:
+                    for (std::size_t i = base; i < end; i++)
+                    {
+                        if (i < n)
+                        {
+                            out[i - base] = nan;
+                            continue;
+                        }
+                        if (i == n)
+                        {
+                            // the seed averages the first n bars, which may lie in earlier blocks
+                            double *g = seed_gains.data(), *l = seed_losses.data();
+                            g[0] = l[0] = 0.0;
+                            for (std::size_t j = 1; j < n; j++)
+                            {
+                                double delta = p[j] - p[j - 1];
+                                g[j] = delta > 0 ? delta : 0.0;
+                                l[j] = delta > 0 ? 0.0 : -delta;
+                            }
+                            x[k] = vector_mean(g, n);
+                            y[k] = vector_mean(l, n);
+                        }
+                        else
+                        {
+                            x[k] = (x[k] * (n - 1) + gains[i - base]) / n;
+                            y[k] = (y[k] * (n - 1) + losses[i - base]) / n;
+                        }
+                        double rs = (y[k] == 0) ? std::numeric_limits<double>::infinity() : x[k] / y[k];
+                        out[i - base] = 100.0 - (100.0 / (1 + rs));
+                    }
+                    break;
+                case source::VWMA:
+                    for (std::size_t i = base; i < end; i++)
+                    {
+                        if (i < n - 1 || i >= s.volumes.size())
+                        {
+                            out[i - base] = nan;
+                            continue;
+                        }
+                        double out_price = i >= n ? p[i - n] : 0.0, out_volume = i >= n ? vl[i - n] : 0.0;
+                        out[i - base] = vwmas[slot[k]].update(p + i - n + 1, vl + i - n + 1, out_price, out_volume);
+                    }
+                    break;
+                }
+            }
+
+            for (std::size_t r = 0; r < steps.size(); r++)
+            {
+                if (!done[r])
+                    continue;
+                const step &st = steps[r];
+                const std::size_t n = st.spec.n;
+                const double *a = st.a != NONE ? column.data() + st.a * BLOCK : nullptr;
+                const double *b = st.b != NONE ? column.data() + st.b * BLOCK : nullptr;
+                double *out = outputs[r].data();
+                switch (st.spec.indicator)
+                {
+                case universe::kind::MACD:
+                    for (std::size_t i = base; i < end; i++)
+                        out[i] = std::isnan(a[i - base]) || std::isnan(b[i - base]) ? nan : a[i - base] - b[i - base];
+                    break;
+                case universe::kind::BOLLINGER_BANDS:
+                    for (std::size_t i = base; i < end; i++)
+                    {
+                        const double middle = a[i - base], sd = b[i - base];
+                        out[i] = middle;
+                        out[len + i] = std::isnan(middle) ? nan : middle + st.spec.k * sd;
+                        out[2 * len + i] = std::isnan(middle) ? nan : middle - st.spec.k * sd;
+                    }
+                    break;
+                case universe::kind::MOMENTUM:
+                    for (std::size_t i = base; i < end; i++)
+                        out[i] = i < n ? nan : p[i] - p[i - n];
+                    break;
+                case universe::kind::WMA:
+                case universe::kind::DONCHIAN:
+                case universe::kind::STOCHASTIC:
+                case universe::kind::WILLIAMS_R:
+                case universe::kind::AROON:
+                    // written after the blocks, their sums and deques slide over the whole series
+                    break;
+                default:
+                    std::copy(a, a + (end - base), out + base);
+                    break;
+                }
+            }
+        }
+
+        for (std::size_t r = 0; r < steps.size(); r++)
+        {
+            if (!done[r])
+                continue;
+            const universe::spec &sp = steps[r].spec;
+            const std::span<double> out = outputs[r];
+            switch (sp.indicator)
+            {
+            case universe::kind::WMA:
+                WMA(s.prices, sp.weights.c_str(), sp.n, out);
+                break;
+            case universe::kind::DONCHIAN:
+                Donchian(s.highs, s.lows, sp.n, out.first(len), out.subspan(len, len), out.last(len));
+                break;
+            case universe::kind::STOCHASTIC:
+                Stochastic(s.highs, s.lows, s.prices, sp.n, sp.slow, out.first(len), out.last(len));
+                break;
+            case universe::kind::WILLIAMS_R:
+                WilliamsR(s.highs, s.lows, s.prices, sp.n, out);
+                break;
+            case universe::kind::AROON:
+                Aroon(s.highs, s.lows, sp.n, out.first(len), out.last(len));
+                break;
+            default:
+                break;
+            }
+        }
+        return done;
+    }
+}
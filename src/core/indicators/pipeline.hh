@@ -0,0 +1,102 @@
+/**
+ * @file pipeline.hh
+ * @license This file is licensed under the GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007. You may obtain a copy of this license at https://www.gnu.org/licenses/gpl-3.0.en.html.
+ * @author Tushar Chaurasia (Dark-CodeX)
+ */
+
+#ifndef QUANTZ_INDICATOR_PIPELINE_HH
+#define QUANTZ_INDICATOR_PIPELINE_HH
+
+#include <map>
+#include <utility>
+
+#include "./universe.hh"
+
+/**
+ * Many indicators of one symbol in a single pass. The specs are planned once: sub-computations they have
+ * in common (EMAs of MACD and EMA, rolling sums of SMA and BollingerBands, the true range of every ATR,
+ * the gains/losses of every RSI) become one shared intermediate. A run walks the bars in blocks that stay
+ * in cache, advances every intermediate over the block and writes the results straight into the caller's
+ * columns, bit for bit equal to the batch functions.
+ */
+namespace core::indicators::pipeline
+{
+    class plan
+    {
+    public:
+        /**
+         * @brief Plans the specs, identical sub-computations are shared between them
+         *
+         * @param specs Indicators to compute, in output order
+         */
+        explicit plan(std::span<const universe::spec> specs);
+
+        /**
+         * @brief Number of specs of the plan
+         */
+        std::size_t size() const { return steps.size(); }
+
+        /**
+         * @brief Number of shared intermediates (rolling sums, EMAs, variances, ...) a run keeps
+         */
+        std::size_t intermediates() const { return nodes.size(); }
+
+        /**
+         * @brief Length of the output column of spec `i`
+         *
+         * @param i Index of the spec
+         * @param len Number of bars
+         * @return `universe::rows` of the indicator times len, BollingerBands is {middle, upper, lower}
+         */
+        std::size_t output_size(const std::size_t &i, const std::size_t &len) const;
+
+        /**
+         * @brief Computes every spec over the series
+         *
+         * @param s Columns of the symbol
+         * @param outputs One column per spec, `output_size(i, s.prices.size())` long
+         * @return Whether spec `i` was written; a spec the batch function would reject, or whose column has
+         * the wrong size, leaves its column untouched
+         */
+        std::vector<bool> run(const universe::series &s, std::span<const std::span<double>> outputs) const;
+
+    private:
+        enum class source : std::uint8_t
+        {
+            // rolling sum of the prices, SMA
+            PRICE_SUM,
+            // rolling sum of the true range, ATR
+            TRUE_RANGE_SUM,
+            EMA,
+            // rolling standard deviation of the prices
+            DEVIATION,
+            // Wilder-smoothed gains/losses, RSI
+            RSI,
+            VWMA
+        };
+
+        static constexpr std::size_t NONE = std::numeric_limits<std::size_t>::max();
+
+        struct node
+        {
+            source what = source::PRICE_SUM;
+            std::size_t n = 0;
+        };
+
+        struct step
+        {
+            universe::spec spec;
+            // shared intermediates the spec reads
+            std::size_t a = NONE, b = NONE;
+        };
+
+        std::size_t share(const source &what, const std::size_t &n);
+        bool valid(const step &st, const universe::series &s) const;
+
+        std::vector<node> nodes;
+        std::vector<step> steps;
+        std::map<std::pair<source, std::size_t>, std::size_t> index;
+    };
+}
+
+#endif
\ No newline at end of file
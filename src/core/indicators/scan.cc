@@ -0,0 +1,229 @@
+/**
+ * @file scan.cc
+ * @license This file is licensed under the GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007. You may obtain a copy of this license at https://www.gnu.org/licenses/gpl-3.0.en.html.
+ * @author Tushar Chaurasia (Dark-CodeX)
+ */
+
+#include "./scan.hh"
+
+namespace core::indicators::scan
+{
+    namespace
+    {
+        double mean_of(const double *values, const std::size_t &n)
+        {
+            return vector_mean(values, n);
+        }
+
+        double mean_of(const float *values, const std::size_t &n)
+        {
+            return vector_meanf(values, n);
+        }
+
+        // number of blocks [first, len) is cut into, 1 when the series is too short to split
+        std::size_t blocks_of(const std::size_t &first, const std::size_t &len, const std::size_t &threads, thread_pool::pool &workers)
+        {
+            const std::size_t tasks = threads == 0 ? workers.size() + 1 : threads;
+            return std::max<std::size_t>(1, std::min(tasks, (len - first) / MIN_BLOCK));
+        }
+
+        // runs fn(block, begin, end) over the blocks of [first, len)
+        template <typename F>
+        void each_block(const std::size_t &blocks, const std::size_t &first, const std::size_t &len, thread_pool::pool &workers, F &&fn)
+        {
+            workers.parallel_for(blocks, [&](std::size_t b)
+                                 { fn(b, first + (len - first) * b / blocks, first + (len - first) * (b + 1) / blocks); }, 1);
+        }
+
+        // b^k by squaring
+        double power(double b, std::size_t k)
+        {
+            double result = 1.0;
+            for (; k != 0; k >>= 1, b *= b)
+            {
+                if (k & 1)
+                    result *= b;
+            }
+            return result;
+        }
+
+        // a non-finite carry stays non-finite in the sequential recurrence, but b^len * carry turns an infinity
+        // into NaN (0 * inf) once b^len underflows: such series are left to the sequential loop
+        bool all_finite(std::span<const double> carries)
+        {
+            return std::all_of(carries.begin(), carries.end(), [](const double &c)
+                               { return std::isfinite(c); });
+        }
+
+        template <typename T>
+        bool ema(std::span<const T> prices, const std::size_t &n, std::span<T> ema, const std::size_t &threads, thread_pool::pool &workers)
+        {
+            if (n == 0 || prices.size() < n || ema.size() < prices.size())
+                return false;
+            const std::size_t blocks = threads == 1 ? 1 : blocks_of(n, prices.size(), threads, workers);
+            if (blocks == 1)
+                return indicators::EMA(prices, n, ema);
+
+            std::fill(ema.begin(), ema.begin() + (n - 1), std::numeric_limits<T>::quiet_NaN());
+            const double alpha = 2.00 / (n + 1.00), beta = 1 - alpha;
+            const double seed = mean_of(prices.data(), n);
+            ema[n - 1] = seed;
+
+            // 1. end value of every block started from 0
+            std::vector<double> ends(blocks), carries(blocks);
+            each_block(blocks, n, prices.size(), workers, [&](std::size_t b, std::size_t begin, std::size_t end)
+                       {
+                           double local = 0.0;
+                           for (std::size_t i = begin; i < end; i++)
+                               local = alpha * prices[i] + (1 - alpha) * local;
+                           ends[b] = local; });
+
+            // 2. value entering every block
+            carries[0] = seed;
+            for (std::size_t b = 1; b < blocks; b++)
+            {
+                const std::size_t begin = n + (prices.size() - n) * (b - 1) / blocks, end = n + (prices.size() - n) * b / blocks;
+                carries[b] = ends[b - 1] + power(beta, end - begin) * carries[b - 1];
+            }
+            if (!all_finite(carries))
+                return indicators::EMA(prices, n, ema);
+
+            // 3. the sequential recurrence of every block, from its carry
+            each_block(blocks, n, prices.size(), workers, [&](std::size_t b, std::size_t begin, std::size_t end)
+                       {
+                           double ema_prev = carries[b];
+                           for (std::size_t i = begin; i < end; i++)
+                           {
+                               double ema_curr = alpha * prices[i] + (1 - alpha) * ema_prev;
+                               ema[i] = ema_curr;
+                               ema_prev = ema_curr;
+                           } });
+            return true;
+        }
+
+        template <typename T>
+        bool rsi(std::span<const T> prices, const std::size_t &n, std::span<T> rsi, const std::size_t &threads, thread_pool::pool &workers)
+        {
+            if (n == 0 || prices.size() <= n || rsi.size() < prices.size())
+                return false;
+            const std::size_t blocks = threads == 1 ? 1 : blocks_of(n + 1, prices.size(), threads, workers);
+            if (blocks == 1)
+                return indicators::RSI(prices, n, rsi);
+
+            // gain and loss of bar i, from the price change since bar i - 1
+            auto change = [&](const std::size_t &i, double &gain, double &loss)
+            {
+                double delta = prices[i] - prices[i - 1];
+                gain = delta > 0 ? delta : 0.0;
+                loss = delta > 0 ? 0.0 : -delta;
+            };
+
+            arena::scope temporaries(arena::local());
+            std::span<double> gains = arena::local().take(n), losses = arena::local().take(n);
+            gains[0] = losses[0] = 0.0;
+            for (std::size_t i = 1; i < n; i++)
+                change(i, gains[i], losses[i]);
+            const double seed_gains = vector_mean(gains.data(), n), seed_losses = vector_mean(losses.data(), n);
+
+            std::fill(rsi.begin(), rsi.begin() + n, std::numeric_limits<T>::quiet_NaN());
+            double rs = (seed_losses == 0) ? std::numeric_limits<double>::infinity() : seed_gains / seed_losses;
+            rsi[n] = 100.0 - (100.0 / (1 + rs));
+
+            // 1. end values of the Wilder means of every block started from 0
+            std::vector<double> end_gains(blocks), end_losses(blocks), carry_gains(blocks), carry_losses(blocks);
+            each_block(blocks, n + 1, prices.size(), workers, [&](std::size_t b, std::size_t begin, std::size_t end)
+                       {
+                           double mean_gains = 0.0, mean_losses = 0.0, gain, loss;
+                           for (std::size_t i = begin; i < end; i++)
+                           {
+                               change(i, gain, loss);
+                               mean_gains = (mean_gains * (n - 1) + gain) / n;
+                               mean_losses = (mean_losses * (n - 1) + loss) / n;
+                           }
+                           end_gains[b] = mean_gains;
+                           end_losses[b] = mean_losses; });
+
+            // 2. means entering every block
+            const double beta = (n - 1.0) / n;
+            carry_gains[0] = seed_gains;
+            carry_losses[0] = seed_losses;
+            for (std::size_t b = 1; b < blocks; b++)
+            {
+                const std::size_t begin = n + 1 + (prices.size() - n - 1) * (b - 1) / blocks, end = n + 1 + (prices.size() - n - 1) * b / blocks;
+                const double decay = power(beta, end - begin);
+                carry_gains[b] = end_gains[b - 1] + decay * carry_gains[b - 1];
+                carry_losses[b] = end_losses[b - 1] + decay * carry_losses[b - 1];
+            }
+            if (!all_finite(carry_gains) || !all_finite(carry_losses))
+                return indicators::RSI(prices, n, rsi);
+
+            // 3. the sequential smoothing of every block, from its carries
+            each_block(blocks, n + 1, prices.size(), workers, [&](std::size_t b, std::size_t begin, std::size_t end)
+                       {
+                           double mean_gains = carry_gains[b], mean_losses = carry_losses[b], gain, loss;
+                           for (std::size_t i = begin; i < end; i++)
+                           {
+                               change(i, gain, loss);
+                               mean_gains = (mean_gains * (n - 1) + gain) / n;
+                               mean_losses = (mean_losses * (n - 1) + loss) / n;
+                               double rs = (mean_losses == 0) ? std::numeric_limits<double>::infinity() : mean_gains / mean_losses;
+                               rsi[i] = 100.0 - (100.0 / (1 + rs));
+                           } });
+            return true;
+        }
+
+        // vector form of a span form, empty when it fails
+        template <typename T, typename F>
+        std::vector<T> collect(const std::size_t &len, F &&fill)
+        {
+            std::vector<T> res(len);
+            if (!fill(std::span<T>(res)))
+                return {};
+            return res;
+        }
+    }
+
+    std::vector<double> EMA(std::span<const double> prices, const std::size_t &n, const std::size_t &threads, thread_pool::pool &workers)
+    {
+        return collect<double>(prices.size(), [&](std::span<double> out)
+                              { return ema(prices, n, out, threads, workers); });
+    }
+
+    std::vector<float> EMA(std::span<const float> prices, const std::size_t &n, const std::size_t &threads, thread_pool::pool &workers)
+    {
+        return collect<float>(prices.size(), [&](std::span<float> out)
+                              { return ema(prices, n, out, threads, workers); });
+    }
+
+    std::vector<double> RSI(std::span<const double> prices, const std::size_t &n, const std::size_t &threads, thread_pool::pool &workers)
+    {
+        return collect<double>(prices.size(), [&](std::span<double> out)
+                              { return rsi(prices, n, out, threads, workers); });
+    }
+
+    std::vector<float> RSI(std::span<const float> prices, const std::size_t &n, const std::size_t &threads, thread_pool::pool &workers)
+    {
+        return collect<float>(prices.size(), [&](std::span<float> out)
+                              { return rsi(prices, n, out, threads, workers); });
+    }
+
+    bool EMA(std::span<const double> prices, const std::size_t &n, std::span<double> out, const std::size_t &threads, thread_pool::pool &workers)
+    {
+        return ema(prices, n, out, threads, workers);
+    }
+
+    bool EMA(std::span<const float> prices, const std::size_t &n, std::span<float> out, const std::size_t &threads, thread_pool::pool &workers)
+    {
+        return ema(prices, n, out, threads, workers);
+    }
+
+    bool RSI(std::span<const double> prices, const std::size_t &n, std::span<double> out, const std::size_t &threads, thread_pool::pool &workers)
+    {
+        return rsi(prices, n, out, threads, workers);
+    }
+
+    bool RSI(std::span<const float> prices, const std::size_t &n, std::span<float> out, const std::size_t &threads, thread_pool::pool &workers)
+    {
+        return rsi(prices, n, out, threads, workers);
+    }
+}
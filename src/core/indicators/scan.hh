@@ -0,0 +1,68 @@
+/**
+ * @file scan.hh
+ * @license This file is licensed under the GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007. You may obtain a copy of this license at https://www.gnu.org/licenses/gpl-3.0.en.html.
+ * @author Tushar Chaurasia (Dark-CodeX)
+ */
+
+#ifndef QUANTZ_INDICATOR_SCAN_HH
+#define QUANTZ_INDICATOR_SCAN_HH
+
+#include "./indicators.hh"
+#include "../thread_pool/thread_pool.hh"
+
+/**
+ * EMA and the Wilder smoothing of RSI are first-order linear recurrences, y[i] = b * y[i - 1] + c[i]. On long
+ * series they run as a blocked scan over a thread pool:
+ *
+ *   1. every block runs its recurrence from 0 (in parallel) and keeps its end value,
+ *   2. the carry into each block is chained over the block ends, carry = end + b^len * previous carry,
+ *   3. every block runs its recurrence again from its carry (in parallel) and writes the results.
+ *
+ * Step 3 is the sequential loop itself, only its starting value carries the rounding of step 2. When b^len
+ * underflows (periods far shorter than a block) the results equal the sequential ones; for periods close to
+ * the series length they agree to within 1e-11 relative (one float ulp for float32 columns). A non-finite
+ * carry (an infinite or NaN price before the last block) is left to the sequential loop.
+ */
+namespace core::indicators::scan
+{
+    // series shorter than this many bars per task stay sequential, the three passes would not pay off
+    constexpr std::size_t MIN_BLOCK = std::size_t(1) << 15;
+
+    /**
+     * @brief EMA, as a parallel scan
+     *
+     * @param prices Price over n periods
+     * @param n Number of periods
+     * @param threads 1 for the sequential `indicators::EMA` (bit for bit), 0 for every worker of the pool,
+     * otherwise the number of blocks scanned in parallel
+     * @param workers Pool running the blocks
+     * @return Same as `indicators::EMA`
+     */
+    std::vector<double> EMA(std::span<const double> prices, const std::size_t &n, const std::size_t &threads = 0, thread_pool::pool &workers = thread_pool::shared());
+    std::vector<float> EMA(std::span<const float> prices, const std::size_t &n, const std::size_t &threads = 0, thread_pool::pool &workers = thread_pool::shared());
+
+    /**
+     * @brief RSI, the mean gains and mean losses as parallel scans
+     *
+     * @param prices Price over n periods
+     * @param n Number of periods
+     * @param threads 1 for the sequential `indicators::RSI` (bit for bit), 0 for every worker of the pool,
+     * otherwise the number of blocks scanned in parallel
+     * @param workers Pool running the blocks
+     * @return Same as `indicators::RSI`
+     */
+    std::vector<double> RSI(std::span<const double> prices, const std::size_t &n, const std::size_t &threads = 0, thread_pool::pool &workers = thread_pool::shared());
+    std::vector<float> RSI(std::span<const float> prices, const std::size_t &n, const std::size_t &threads = 0, thread_pool::pool &workers = thread_pool::shared());
+
+    /*
+     * Span forms, writing to the first `prices.size()` elements of `out` like the span forms of `core::indicators`;
+     * false, with `out` untouched, on invalid input or a short `out`
+     */
+
+    bool EMA(std::span<const double> prices, const std::size_t &n, std::span<double> out, const std::size_t &threads = 0, thread_pool::pool &workers = thread_pool::shared());
+    bool EMA(std::span<const float> prices, const std::size_t &n, std::span<float> out, const std::size_t &threads = 0, thread_pool::pool &workers = thread_pool::shared());
+    bool RSI(std::span<const double> prices, const std::size_t &n, std::span<double> out, const std::size_t &threads = 0, thread_pool::pool &workers = thread_pool::shared());
+    bool RSI(std::span<const float> prices, const std::size_t &n, std::span<float> out, const std::size_t &threads = 0, thread_pool::pool &workers = thread_pool::shared());
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,330 @@
+/**
+ * @file stream.cc
+ * @license This file is licensed under the GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007. You may obtain a copy of this license at https://www.gnu.org/licenses/gpl-3.0.en.html.
+ * @author Tushar Chaurasia (Dark-CodeX)
+ */
+
+#include "./stream.hh"
+
+namespace core::indicators::stream
+{
+    SMA::SMA(const std::size_t &n) : n(n), window(n, 0.0) {}
+
+    double SMA::update(const double &price)
+    {
+        if (n == 0)
+            return val;
+
+        wsum += price;
+        if (count >= n)
+            wsum -= window[head];
+        window[head] = price;
+        head = (head + 1) % n;
+        count++;
+
+        if (count >= n)
+            val = wsum / n;
+        return val;
+    }
+
+    void SMA::seed(std::span<const double> prices)
+    {
+        for (const double &p : prices)
+            update(p);
+    }
+
+    EMA::EMA(const std::size_t &n) : n(n), warmup(n, 0.0), alpha(2.00 / (n + 1.00)) {}
+
+    double EMA::update(const double &price)
+    {
+        if (n == 0)
+            return val;
+
+        if (count < n)
+        {
+            warmup[count++] = price;
+            if (count == n)
+                val = vector_mean(warmup.data(), n);
+            return val;
+        }
+
+        val = alpha * price + (1 - alpha) * val;
+        count++;
+        return val;
+    }
+
+    void EMA::seed(std::span<const double> prices)
+    {
+        for (const double &p : prices)
+            update(p);
+    }
+
+    MACD::MACD(const std::size_t &fast, const std::size_t &slow) : fast(fast), slow(slow) {}
+
+    double MACD::update(const double &price)
+    {
+        double a = fast.update(price), b = slow.update(price);
+        if (std::isnan(a) || std::isnan(b))
+            val = std::numeric_limits<double>::quiet_NaN();
+        else
+            val = a - b;
+        return val;
+    }
+
+    void MACD::seed(std::span<const double> prices)
+    {
+        for (const double &p : prices)
+            update(p);
+    }
+
+    RSI::RSI(const std::size_t &n) : n(n), warmup_gains(n, 0.0), warmup_losses(n, 0.0) {}
+
+    double RSI::update(const double &price)
+    {
+        if (n == 0)
+            return val;
+
+        double gain = 0, loss = 0;
+        if (count > 0)
+        {
+            double delta = price - prev;
+            if (delta > 0)
+                gain = delta;
+            else
+                loss = -delta;
+        }
+        prev = price;
+
+        if (count < n)
+        {
+            warmup_gains[count] = gain;
+            warmup_losses[count] = loss;
+            count++;
+            return val;
+        }
+
+        // the batch RSI seeds from bars [0, n) and only starts smoothing at bar n + 1
+        if (count == n)
+        {
+            mean_gains = vector_mean(warmup_gains.data(), n);
+            mean_losses = vector_mean(warmup_losses.data(), n);
+        }
+        else
+        {
+            mean_gains = (mean_gains * (n - 1) + gain) / n;
+            mean_losses = (mean_losses * (n - 1) + loss) / n;
+        }
+        count++;
+
+        double rs = (mean_losses == 0) ? std::numeric_limits<double>::infinity() : mean_gains / mean_losses;
+        val = 100.0 - (100.0 / (1 + rs));
+        return val;
+    }
+
+    void RSI::seed(std::span<const double> prices)
+    {
+        for (const double &p : prices)
+            update(p);
+    }
+
+    BollingerBands::BollingerBands(const std::size_t &n, const double &k) : middle(n), n(n), k(k), window(2 * n, 0.0), variance(n) {}
+
+    double BollingerBands::update(const double &price)
+    {
+        if (n == 0)
+            return middle.value();
+
+        std::size_t idx = count % n;
+        double out = window[idx];
+        window[idx] = price;
+        window[idx + n] = price;
+        count++;
+
+        double mid = middle.update(price);
+        double sd = count >= n ? std::sqrt(variance.update(window.data() + idx + 1, out)) : 0.0;
+        if (count >= n && !std::isnan(mid))
+        {
+            up = mid + k * sd;
+            low = mid - k * sd;
+        }
+        else
+        {
+            up = low = std::numeric_limits<double>::quiet_NaN();
+        }
+        return mid;
+    }
+
+    void BollingerBands::seed(std::span<const double> prices)
+    {
+        for (const double &p : prices)
+            update(p);
+    }
+
+    VWMA::VWMA(const std::size_t &n) : n(n), prices(2 * n, 0.0), volumes(2 * n, 0.0), sums(n) {}
+
+    double VWMA::update(const double &price, const double &volume)
+    {
+        if (n == 0)
+            return val;
+
+        std::size_t idx = count % n;
+        double out_price = prices[idx], out_volume = volumes[idx];
+        prices[idx] = prices[idx + n] = price;
+        volumes[idx] = volumes[idx + n] = volume;
+        count++;
+
+        if (count >= n)
+            val = sums.update(prices.data() + idx + 1, volumes.data() + idx + 1, out_price, out_volume);
+        return val;
+    }
+
+    void VWMA::seed(std::span<const double> prices, std::span<const double> volumes)
+    {
+        for (std::size_t i = 0; i < std::min(prices.size(), volumes.size()); i++)
+            update(prices[i], volumes[i]);
+    }
+
+    ATR::ATR(const std::size_t &n) : true_range(n) {}
+
+    double ATR::update(const double &high, const double &low, const double &close)
+    {
+        double tr;
+        if (count == 0)
+            tr = high - low;
+        else
+            tr = MAX_3(high - low, std::abs(high - prev_close), std::abs(low - prev_close));
+        prev_close = close;
+        count++;
+        return true_range.update(tr);
+    }
+
+    void ATR::seed(std::span<const double> highs, std::span<const double> lows, std::span<const double> closes)
+    {
+        for (std::size_t i = 0; i < std::min({highs.size(), lows.size(), closes.size()}); i++)
+            update(highs[i], lows[i], closes[i]);
+    }
+
+    Momentum::Momentum(const std::size_t &n) : n(n), window(n, 0.0) {}
+
+    double Momentum::update(const double &price)
+    {
+        if (n == 0)
+            return val;
+
+        if (count >= n)
+            val = price - window[head];
+        window[head] = price;
+        head = (head + 1) % n;
+        count++;
+        return val;
+    }
+
+    void Momentum::seed(std::span<const double> prices)
+    {
+        for (const double &p : prices)
+            update(p);
+    }
+
+    Donchian::Donchian(const std::size_t &n) : n(n), highest(n, true), lowest(n, false) {}
+
+    double Donchian::update(const double &high, const double &low)
+    {
+        if (n == 0)
+            return val;
+
+        const double hh = highest.update(high), ll = lowest.update(low);
+        count++;
+        if (count >= n)
+        {
+            val = (hh + ll) / 2;
+            up = hh;
+            this->low = ll;
+        }
+        return val;
+    }
+
+    void Donchian::seed(std::span<const double> highs, std::span<const double> lows)
+    {
+        for (std::size_t i = 0; i < std::min(highs.size(), lows.size()); i++)
+            update(highs[i], lows[i]);
+    }
+
+    Stochastic::Stochastic(const std::size_t &n, const std::size_t &d) : n(n), smoothing(d), highest(n, true), lowest(n, false), recent(d, 0.0) {}
+
+    double Stochastic::update(const double &high, const double &low, const double &close)
+    {
+        if (n == 0 || smoothing == 0)
+            return val;
+
+        const double hh = highest.update(high), ll = lowest.update(low);
+        count++;
+        if (count < n)
+            return val;
+
+        // same arithmetic as the batch Stochastic
+        const double range = hh - ll;
+        val = range != 0 || std::isnan(close) ? 100.0 * (close - ll) / range : 0.0;
+        const std::size_t m = count - n;
+        recent[m % smoothing] = val;
+        if (m + 1 >= smoothing)
+        {
+            double sum = 0.0;
+            for (std::size_t j = 0; j < smoothing; j++)
+                sum += recent[(m + 1 + j) % smoothing];
+            signal = sum / smoothing;
+        }
+        return val;
+    }
+
+    void Stochastic::seed(std::span<const double> highs, std::span<const double> lows, std::span<const double> closes)
+    {
+        for (std::size_t i = 0; i < std::min({highs.size(), lows.size(), closes.size()}); i++)
+            update(highs[i], lows[i], closes[i]);
+    }
+
+    WilliamsR::WilliamsR(const std::size_t &n) : n(n), highest(n, true), lowest(n, false) {}
+
+    double WilliamsR::update(const double &high, const double &low, const double &close)
+    {
+        if (n == 0)
+            return val;
+
+        const double hh = highest.update(high), ll = lowest.update(low);
+        count++;
+        if (count >= n)
+        {
+            const double range = hh - ll;
+            val = range != 0 || std::isnan(close) ? -100.0 * (hh - close) / range : 0.0;
+        }
+        return val;
+    }
+
+    void WilliamsR::seed(std::span<const double> highs, std::span<const double> lows, std::span<const double> closes)
+    {
+        for (std::size_t i = 0; i < std::min({highs.size(), lows.size(), closes.size()}); i++)
+            update(highs[i], lows[i], closes[i]);
+    }
+
+    Aroon::Aroon(const std::size_t &n) : n(n), highest(n + 1, true), lowest(n + 1, false) {}
+
+    double Aroon::update(const double &high, const double &low)
+    {
+        if (n == 0)
+            return val;
+
+        const double hh = highest.update(high), ll = lowest.update(low);
+        count++;
+        if (count > n)
+        {
+            val = std::isnan(hh) ? hh : 100.0 * (double)(n - highest.age()) / n;
+            dn = std::isnan(ll) ? ll : 100.0 * (double)(n - lowest.age()) / n;
+        }
+        return val;
+    }
+
+    void Aroon::seed(std::span<const double> highs, std::span<const double> lows)
+    {
+        for (std::size_t i = 0; i < std::min(highs.size(), lows.size()); i++)
+            update(highs[i], lows[i]);
+    }
+}
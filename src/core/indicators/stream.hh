@@ -0,0 +1,220 @@
+/**
+ * @file stream.hh
+ * @license This file is licensed under the GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007. You may obtain a copy of this license at https://www.gnu.org/licenses/gpl-3.0.en.html.
+ * @author Tushar Chaurasia (Dark-CodeX)
+ */
+
+#ifndef QUANTZ_INDICATOR_STREAM_HH
+#define QUANTZ_INDICATOR_STREAM_HH
+
+#include "./indicators.hh"
+
+/**
+ * Incremental counterparts of the batch indicators. Each object keeps its own ring buffers and running
+ * sums, `update` consumes one bar in O(1) and returns `value()`. After feeding the same bars, `value()`
+ * equals the last element of the batch result bit for bit (NaN while warming up). `seed` replays a
+ * history in one pass, so a live session can start from the data it already has.
+ */
+namespace core::indicators::stream
+{
+    class SMA
+    {
+    public:
+        explicit SMA(const std::size_t &n);
+        double update(const double &price);
+        double value() const { return val; }
+        bool ready() const { return n != 0 && count >= n; }
+        void seed(std::span<const double> prices);
+
+    private:
+        std::size_t n, head = 0, count = 0;
+        std::vector<double> window;
+        double wsum = 0.0, val = std::numeric_limits<double>::quiet_NaN();
+    };
+
+    class EMA
+    {
+    public:
+        explicit EMA(const std::size_t &n);
+        double update(const double &price);
+        double value() const { return val; }
+        bool ready() const { return n != 0 && count >= n; }
+        void seed(std::span<const double> prices);
+
+    private:
+        std::size_t n, count = 0;
+        // first `n` prices, the seed is their SIMD mean exactly like the batch EMA
+        std::vector<double> warmup;
+        double alpha, val = std::numeric_limits<double>::quiet_NaN();
+    };
+
+    class MACD
+    {
+    public:
+        MACD(const std::size_t &fast, const std::size_t &slow);
+        double update(const double &price);
+        double value() const { return val; }
+        bool ready() const { return fast.ready() && slow.ready(); }
+        void seed(std::span<const double> prices);
+
+    private:
+        EMA fast, slow;
+        double val = std::numeric_limits<double>::quiet_NaN();
+    };
+
+    class RSI
+    {
+    public:
+        explicit RSI(const std::size_t &n);
+        double update(const double &price);
+        double value() const { return val; }
+        bool ready() const { return n != 0 && count > n; }
+        void seed(std::span<const double> prices);
+
+    private:
+        std::size_t n, count = 0;
+        // gains/losses of the first `n` bars (the first one is always 0)
+        std::vector<double> warmup_gains, warmup_losses;
+        double prev = 0.0, mean_gains = 0.0, mean_losses = 0.0, val = std::numeric_limits<double>::quiet_NaN();
+    };
+
+    class BollingerBands
+    {
+    public:
+        BollingerBands(const std::size_t &n, const double &k);
+        double update(const double &price);
+        double value() const { return middle.value(); }
+        double upper() const { return up; }
+        double lower() const { return low; }
+        bool ready() const { return middle.ready(); }
+        void seed(std::span<const double> prices);
+
+    private:
+        SMA middle;
+        std::size_t n, count = 0;
+        double k;
+        // every price is stored twice (at i % n and i % n + n) so the last n prices are always contiguous
+        std::vector<double> window;
+        rolling_variance variance;
+        double up = std::numeric_limits<double>::quiet_NaN(), low = std::numeric_limits<double>::quiet_NaN();
+    };
+
+    class VWMA
+    {
+    public:
+        explicit VWMA(const std::size_t &n);
+        double update(const double &price, const double &volume);
+        double value() const { return val; }
+        bool ready() const { return n != 0 && count >= n; }
+        void seed(std::span<const double> prices, std::span<const double> volumes);
+
+    private:
+        std::size_t n, count = 0;
+        // mirrored like BollingerBands, newest bar at `count % n + n`
+        std::vector<double> prices, volumes;
+        rolling_vwma sums;
+        double val = std::numeric_limits<double>::quiet_NaN();
+    };
+
+    class ATR
+    {
+    public:
+        explicit ATR(const std::size_t &n);
+        double update(const double &high, const double &low, const double &close);
+        double value() const { return true_range.value(); }
+        bool ready() const { return true_range.ready(); }
+        void seed(std::span<const double> highs, std::span<const double> lows, std::span<const double> closes);
+
+    private:
+        SMA true_range;
+        std::size_t count = 0;
+        double prev_close = 0.0;
+    };
+
+    class Momentum
+    {
+    public:
+        explicit Momentum(const std::size_t &n);
+        double update(const double &price);
+        double value() const { return val; }
+        bool ready() const { return n != 0 && count > n; }
+        void seed(std::span<const double> prices);
+
+    private:
+        std::size_t n, head = 0, count = 0;
+        std::vector<double> window;
+        double val = std::numeric_limits<double>::quiet_NaN();
+    };
+
+    class Donchian
+    {
+    public:
+        explicit Donchian(const std::size_t &n);
+        double update(const double &high, const double &low);
+        double value() const { return val; }
+        double upper() const { return up; }
+        double lower() const { return low; }
+        bool ready() const { return n != 0 && count >= n; }
+        void seed(std::span<const double> highs, std::span<const double> lows);
+
+    private:
+        std::size_t n, count = 0;
+        rolling_extreme highest, lowest;
+        double val = std::numeric_limits<double>::quiet_NaN(), up = std::numeric_limits<double>::quiet_NaN(), low = std::numeric_limits<double>::quiet_NaN();
+    };
+
+    class Stochastic
+    {
+    public:
+        Stochastic(const std::size_t &n, const std::size_t &d);
+        double update(const double &high, const double &low, const double &close);
+        // %K
+        double value() const { return val; }
+        // %D
+        double d() const { return signal; }
+        bool ready() const { return n != 0 && smoothing != 0 && count >= n + smoothing - 1; }
+        void seed(std::span<const double> highs, std::span<const double> lows, std::span<const double> closes);
+
+    private:
+        std::size_t n, smoothing, count = 0;
+        rolling_extreme highest, lowest;
+        // the last `smoothing` %K values, at (bar - n + 1) % smoothing
+        std::vector<double> recent;
+        double val = std::numeric_limits<double>::quiet_NaN(), signal = std::numeric_limits<double>::quiet_NaN();
+    };
+
+    class WilliamsR
+    {
+    public:
+        explicit WilliamsR(const std::size_t &n);
+        double update(const double &high, const double &low, const double &close);
+        double value() const { return val; }
+        bool ready() const { return n != 0 && count >= n; }
+        void seed(std::span<const double> highs, std::span<const double> lows, std::span<const double> closes);
+
+    private:
+        std::size_t n, count = 0;
+        rolling_extreme highest, lowest;
+        double val = std::numeric_limits<double>::quiet_NaN();
+    };
+
+    class Aroon
+    {
+    public:
+        explicit Aroon(const std::size_t &n);
+        double update(const double &high, const double &low);
+        // Aroon up
+        double value() const { return val; }
+        double down() const { return dn; }
+        bool ready() const { return n != 0 && count > n; }
+        void seed(std::span<const double> highs, std::span<const double> lows);
+
+    private:
+        std::size_t n, count = 0;
+        // over the last n + 1 bars
+        rolling_extreme highest, lowest;
+        double val = std::numeric_limits<double>::quiet_NaN(), dn = std::numeric_limits<double>::quiet_NaN();
+    };
+}
+
+#endif
\ No newline at end of file
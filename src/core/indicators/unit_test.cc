@@ -0,0 +1,468 @@
+/**
+ * @file unit_test.cc
+ * @license This file is licensed under the GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007. You may obtain a copy of this license at https://www.gnu.org/licenses/gpl-3.0.en.html.
+ * @author Tushar Chaurasia (Dark-CodeX)
+ */
+
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include "./indicators.hh"
+#include "./universe.hh"
+#include "./cache.hh"
+#include "./stream.hh"
+#include "./pipeline.hh"
+#include "./scan.hh"
+
+namespace
+{
+    using namespace core::indicators;
+
+    // equal values, NaN where the other is NaN
+    bool same(std::span<const double> a, std::span<const double> b)
+    {
+        if (a.size() != b.size())
+            return false;
+        for (std::size_t i = 0; i < a.size(); i++)
+        {
+            if (!(a[i] == b[i] || (std::isnan(a[i]) && std::isnan(b[i]))))
+                return false;
+        }
+        return true;
+    }
+
+    // a wandering price path with highs above and lows below it
+    struct bars
+    {
+        std::vector<double> prices, highs, lows, volumes;
+
+        explicit bars(const std::size_t &len)
+        {
+            double p = 100.0;
+            for (std::size_t i = 0; i < len; i++)
+            {
+                p *= 1.0 + 0.01 * std::sin(0.37 * (double)i) + 0.002 * std::cos(1.91 * (double)i);
+                prices.emplace_back(p);
+                highs.emplace_back(p * (1.0 + 0.004 * (1.0 + std::sin(0.71 * (double)i))));
+                lows.emplace_back(p * (1.0 - 0.004 * (1.0 + std::cos(0.53 * (double)i))));
+                volumes.emplace_back(1000.0 + 500.0 * std::sin(0.11 * (double)i));
+            }
+        }
+
+        // the first `len` bars
+        universe::series head(const std::size_t &len) const
+        {
+            return {std::span<const double>(prices).first(len), std::span<const double>(highs).first(len), std::span<const double>(lows).first(len), std::span<const double>(volumes).first(len)};
+        }
+    };
+
+    void test_macd_float()
+    {
+        // float32 prices, and the same values widened to double for the reference results
+        std::vector<float> pricesf(5000);
+        std::vector<double> prices(pricesf.size());
+        double p = 100.0;
+        for (std::size_t i = 0; i < pricesf.size(); i++)
+        {
+            p *= 1.0 + 0.01 * std::sin(0.37 * (double)i) + 0.002 * std::cos(1.91 * (double)i);
+            pricesf[i] = (float)p;
+            prices[i] = pricesf[i];
+        }
+
+        // a float32 result is the double result rounded once, when it is stored
+        std::size_t periods[][2] = {{12, 26}, {5, 35}, {26, 12}, {1, 2}};
+        for (const auto &fs : periods)
+        {
+            std::vector<double> ref = MACD(std::span<const double>(prices), fs[0], fs[1]);
+            std::vector<float> res = MACD(std::span<const float>(pricesf), fs[0], fs[1]);
+            assert(res.size() == ref.size());
+            for (std::size_t i = 0; i < ref.size(); i++)
+                assert((std::isnan(ref[i]) && std::isnan(res[i])) || res[i] == (float)ref[i]);
+
+            std::vector<float> out(pricesf.size());
+            assert(MACD(std::span<const float>(pricesf), fs[0], fs[1], std::span<float>(out)));
+            for (std::size_t i = 0; i < ref.size(); i++)
+                assert((std::isnan(res[i]) && std::isnan(out[i])) || out[i] == res[i]);
+        }
+        printf("float32 MACD matches the rounded double MACD\n");
+    }
+
+    void test_cache()
+    {
+        const bars data(3000);
+        using universe::kind;
+
+        // every streaming kind, extended twice over appended bars: 1-row and R x N results equal a fresh compute
+        const kind kinds[] = {kind::SMA, kind::EMA, kind::VWMA, kind::MACD, kind::RSI, kind::BOLLINGER_BANDS, kind::ATR,
+                              kind::MOMENTUM, kind::DONCHIAN, kind::STOCHASTIC, kind::WILLIAMS_R, kind::AROON, kind::WMA};
+        result_cache cache(std::size_t(1) << 30);
+        cache.appended("d", 1, 2);
+        cache.appended("d", 2, 3);
+        for (const kind &kd : kinds)
+        {
+            universe::spec sp;
+            sp.indicator = kd;
+            sp.n = 14;
+            sp.slow = kd == kind::MACD ? 26 : 3;
+            const std::size_t lens[] = {1000, 1700, 3000};
+            for (std::size_t v = 0; v < 3; v++)
+            {
+                std::shared_ptr<const std::vector<double>> got = cache.get("d", v + 1, sp, "close", data.head(lens[v]));
+                assert(same(*got, universe::compute(data.head(lens[v]), sp)));
+                assert(same(*cache.get("d", v + 1, sp, "close", data.head(lens[v])), *got));
+            }
+        }
+        result_cache::stats s = cache.statistics();
+        // WMA has no streaming form, each of its versions is a miss
+        assert(s.misses == 12 + 3 && s.extensions == 12 * 2 && s.hits == 13 * 3 && s.evictions == 0 && s.entries == 13);
+
+        // a version that does not descend from the cached one replaces it
+        universe::spec sma;
+        sma.n = 14;
+        sma.slow = 3;
+        cache.get("d", 9, sma, "close", data.head(500));
+        s = cache.statistics();
+        assert(s.misses == 16 && s.entries == 13);
+
+        // least recently used first: a, b, a touched, c evicts b
+        result_cache lru(std::size_t(1) << 30);
+        universe::spec a = sma, b = sma, c = sma;
+        b.n = 21;
+        c.n = 22;
+        lru.get("e", 1, a, "close", data.head(1000));
+        const std::size_t one = lru.statistics().bytes;
+        lru.set_budget(2 * one + one / 2);
+        lru.get("e", 1, b, "close", data.head(1000));
+        lru.get("e", 1, a, "close", data.head(1000));
+        lru.get("e", 1, c, "close", data.head(1000));
+        s = lru.statistics();
+        assert(s.evictions == 1 && s.entries == 2 && s.bytes <= 2 * one + one / 2);
+        lru.get("e", 1, a, "close", data.head(1000));
+        assert(lru.statistics().hits == 2);
+        lru.get("e", 1, b, "close", data.head(1000));
+        assert(lru.statistics().misses == 4 && lru.statistics().evictions == 2);
+
+        // concurrent misses of one key share a single computation
+        result_cache shared(std::size_t(1) << 30);
+        universe::spec slow;
+        slow.indicator = kind::WMA;
+        slow.n = 300;
+        std::vector<std::shared_ptr<const std::vector<double>>> results(8);
+        std::vector<std::thread> threads;
+        for (std::size_t t = 0; t < results.size(); t++)
+            threads.emplace_back([&, t]
+                                 { results[t] = shared.get("f", 1, slow, "close", data.head(3000)); });
+        for (std::thread &t : threads)
+            t.join();
+        s = shared.statistics();
+        assert(s.misses == 1 && s.hits == results.size() - 1);
+        for (const auto &r : results)
+            assert(r == results[0]);
+        printf("cache hits, misses, extensions and LRU eviction behave\n");
+    }
+
+    /**
+     * `rows` row-major batch rows against the values a stream object gave bar by bar (one vector per row). A
+     * batch that refused its input (period longer than the data) leaves the stream NaN throughout.
+     */
+    void same_rows(const std::vector<double> &batch, const std::vector<std::vector<double>> &streamed)
+    {
+        const std::size_t len = streamed[0].size();
+        if (batch.empty())
+        {
+            for (const std::vector<double> &row : streamed)
+            {
+                for (const double &v : row)
+                    assert(std::isnan(v));
+            }
+            return;
+        }
+        assert(batch.size() == streamed.size() * len);
+        for (std::size_t r = 0; r < streamed.size(); r++)
+            assert(same(std::span<const double>(batch).subspan(r * len, len), streamed[r]));
+    }
+
+    void test_wma()
+    {
+        // NaN prints make some windows NaN, the bars between them are finite again
+        bars data(1500);
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        data.prices[40] = data.prices[900] = data.prices[905] = nan;
+        const std::span<const double> prices = data.prices;
+
+        const char *schemes[] = {"linear", "normalized linear", "harmonic", "triangular", "quadratic", "cubic", "root"};
+        for (const char *scheme : schemes)
+        {
+            // sliding sums, SIMD dot products, and FFT blocks from n = 128 on
+            for (const std::size_t &n : {1, 2, 7, 64, 127, 128, 300})
+            {
+                const std::vector<double> w = WEIGHTS(scheme, n);
+                double wsum = 0.0;
+                for (const double &x : w)
+                    wsum += x;
+                // the whole series, and exactly one window
+                for (const std::size_t &len : {prices.size(), n})
+                {
+                    const std::span<const double> p = prices.first(len);
+                    const std::vector<double> res = WMA(p, scheme, n);
+                    assert(res.size() == len);
+                    for (std::size_t i = 0; i < len; i++)
+                    {
+                        if (i + 1 < n)
+                        {
+                            assert(std::isnan(res[i]));
+                            continue;
+                        }
+                        // the first weight meets the newest price
+                        double naive = 0.0, scale = 0.0;
+                        for (std::size_t j = 0; j < n; j++)
+                        {
+                            naive += w[j] * p[i - j];
+                            scale = std::max(scale, std::abs(p[i - j]));
+                        }
+                        naive /= wsum;
+                        assert(std::isnan(naive) ? std::isnan(res[i]) : std::abs(res[i] - naive) <= 1e-12 * scale);
+                    }
+                }
+            }
+        }
+        printf("WMA matches the naive weighted sums for every scheme\n");
+    }
+
+    void test_multi()
+    {
+        const std::vector<double> prices = bars(3000).prices;
+        const std::size_t len = prices.size();
+
+        // row counts around the lane width, with a repeated period, a zero one and one longer than the series
+        const std::vector<std::size_t> all = {14, 2, 200, 14, 1, 0, 50, 3001, 9, 3000, 26, 7, 128};
+        for (const std::size_t &rows : {1, 3, 7, 9, 13})
+        {
+            const std::span<const std::size_t> periods = std::span<const std::size_t>(all).first(rows);
+            const std::vector<double> sma = SMA_multi(prices, periods), ema = EMA_multi(prices, periods), rsi = RSI_multi(prices, periods);
+            assert(sma.size() == rows * len && ema.size() == rows * len && rsi.size() == rows * len);
+            for (std::size_t r = 0; r < rows; r++)
+            {
+                auto row = [&](const std::vector<double> &m)
+                { return std::span<const double>(m).subspan(r * len, len); };
+                auto invalid = [](std::span<const double> x)
+                { return std::all_of(x.begin(), x.end(), [](const double &v)
+                                     { return std::isnan(v); }); };
+                const std::vector<double> sma_ref = SMA(prices, periods[r]), ema_ref = EMA(prices, periods[r]), rsi_ref = RSI(prices, periods[r]);
+                assert(sma_ref.empty() ? invalid(row(sma)) : sma_ref.size() == len);
+                assert(ema_ref.empty() ? invalid(row(ema)) : same(row(ema), ema_ref));
+                assert(rsi_ref.empty() ? invalid(row(rsi)) : same(row(rsi), rsi_ref));
+                // SMA rows round their window sums differently
+                for (std::size_t i = 0; i < sma_ref.size(); i++)
+                    assert(std::isnan(sma_ref[i]) ? std::isnan(row(sma)[i]) : std::abs(row(sma)[i] - sma_ref[i]) <= 1e-12 * std::abs(sma_ref[i]));
+            }
+        }
+        printf("multi-period rows match the single-period indicators\n");
+    }
+
+    void test_scan()
+    {
+        // four blocks of the scan
+        std::vector<double> prices = bars(4 * scan::MIN_BLOCK + 17).prices;
+        const std::size_t len = prices.size();
+
+        // periods far shorter than a block give the sequential results, long ones agree to 1e-11 relative
+        auto check = [&](const std::size_t &n, const bool &exact)
+        {
+            const std::vector<double> series[][2] = {{EMA(prices, n), scan::EMA(prices, n, 4)}, {RSI(prices, n), scan::RSI(prices, n, 4)}};
+            for (const auto &pair : series)
+            {
+                const std::vector<double> &ref = pair[0], &res = pair[1];
+                assert(res.size() == ref.size());
+                if (exact)
+                    assert(same(res, ref));
+                else
+                {
+                    for (std::size_t i = 0; i < len; i++)
+                        assert(std::isnan(ref[i]) ? std::isnan(res[i]) : std::abs(res[i] - ref[i]) <= 1e-11 * std::abs(ref[i]));
+                }
+            }
+        };
+        check(14, true);
+        check(200, true);
+        check(3 * scan::MIN_BLOCK, false);
+
+        // an infinite print in the first block: EMA stays infinite (and RSI NaN) for good, where the carry
+        // combine would have made 0 * inf of it
+        prices[1000] = std::numeric_limits<double>::infinity();
+        check(14, true);
+        // a NaN print in the second one
+        prices[1000] = 100.0;
+        prices[scan::MIN_BLOCK + 1000] = std::numeric_limits<double>::quiet_NaN();
+        check(14, true);
+        printf("parallel EMA and RSI scans match the sequential ones\n");
+    }
+
+    void test_pipeline()
+    {
+        // several blocks long, with NaN prints
+        bars data(2500);
+        data.prices[700] = data.highs[1300] = data.lows[1900] = data.volumes[40] = std::numeric_limits<double>::quiet_NaN();
+        using universe::kind;
+
+        // shared sums and EMAs (SMA/BollingerBands, EMA/MACD), several RSIs, a period crossing a block, the
+        // whole-series kinds, and specs the batch functions reject
+        std::vector<universe::spec> specs;
+        auto add = [&](const kind &kd, const std::size_t &n, const std::size_t &slow)
+        {
+            universe::spec sp;
+            sp.indicator = kd;
+            sp.n = n;
+            sp.slow = slow;
+            specs.emplace_back(sp);
+        };
+        for (const std::size_t &n : {1, 14, 20, 600})
+        {
+            add(kind::SMA, n, 0);
+            add(kind::EMA, n, 0);
+            add(kind::RSI, n, 0);
+            add(kind::BOLLINGER_BANDS, n, 0);
+            add(kind::ATR, n, 0);
+            add(kind::VWMA, n, 0);
+            add(kind::MOMENTUM, n, 0);
+            add(kind::WMA, n, 0);
+            add(kind::DONCHIAN, n, 0);
+            add(kind::STOCHASTIC, n, 3);
+            add(kind::WILLIAMS_R, n, 0);
+            add(kind::AROON, n, 0);
+        }
+        add(kind::MACD, 12, 26);
+        add(kind::MACD, 20, 14);
+        add(kind::EMA, 26, 0);
+        add(kind::SMA, 0, 0);
+        add(kind::RSI, 5000, 0);
+        add(kind::AROON, 2500, 0);
+
+        const pipeline::plan plan(specs);
+        assert(plan.size() == specs.size() && plan.intermediates() < specs.size());
+        const universe::series s = data.head(2500);
+        std::vector<std::vector<double>> columns(specs.size());
+        std::vector<std::span<double>> outputs;
+        for (std::size_t i = 0; i < specs.size(); i++)
+        {
+            columns[i].assign(plan.output_size(i, 2500), -1.0);
+            outputs.emplace_back(columns[i]);
+        }
+        const std::vector<bool> done = plan.run(s, outputs);
+        for (std::size_t i = 0; i < specs.size(); i++)
+        {
+            const std::vector<double> batch = universe::compute(s, specs[i]);
+            // a rejected spec leaves its column untouched
+            assert(done[i] == !batch.empty());
+            if (!done[i])
+            {
+                for (const double &v : columns[i])
+                    assert(v == -1.0);
+                continue;
+            }
+            assert(batch.size() == columns[i].size() && std::memcmp(batch.data(), columns[i].data(), batch.size() * sizeof(double)) == 0);
+        }
+        printf("the pipeline is bit for bit the batch functions\n");
+    }
+
+    void test_stream()
+    {
+        // NaN prints in every input, early (inside the warm-up) and later on
+        bars data(600);
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        for (const std::size_t &i : {3, 250, 251, 420})
+        {
+            data.prices[i] = nan;
+            data.highs[i + 7] = nan;
+            data.lows[i + 11] = nan;
+            data.volumes[i + 13] = nan;
+        }
+        const std::span<const double> p = data.prices, h = data.highs, l = data.lows, v = data.volumes;
+        const std::size_t len = p.size();
+
+        // period 1, short and long windows, and one longer than the data
+        for (const std::size_t &n : {1, 5, 14, 64, 700})
+        {
+            std::vector<std::vector<double>> one(1, std::vector<double>(len)), two(2, one[0]), three(3, one[0]);
+
+            stream::SMA sma(n);
+            stream::EMA ema(n);
+            stream::RSI rsi(n);
+            stream::VWMA vwma(n);
+            stream::Momentum momentum(n);
+            stream::MACD macd(n, n + 12);
+            stream::BollingerBands bands(n, 2.0);
+            stream::ATR atr(n);
+            stream::Donchian donchian(n);
+            stream::Stochastic stochastic(n, 3);
+            stream::WilliamsR williams(n);
+            stream::Aroon aroon(n);
+
+            std::vector<std::vector<double>> sma_v = one, ema_v = one, rsi_v = one, vwma_v = one, momentum_v = one, macd_v = one, atr_v = one, williams_v = one;
+            std::vector<std::vector<double>> bands_v = three, donchian_v = three, stochastic_v = two, aroon_v = two;
+            for (std::size_t i = 0; i < len; i++)
+            {
+                sma_v[0][i] = sma.update(p[i]);
+                ema_v[0][i] = ema.update(p[i]);
+                rsi_v[0][i] = rsi.update(p[i]);
+                vwma_v[0][i] = vwma.update(p[i], v[i]);
+                momentum_v[0][i] = momentum.update(p[i]);
+                macd_v[0][i] = macd.update(p[i]);
+                bands_v[0][i] = bands.update(p[i]);
+                bands_v[1][i] = bands.upper();
+                bands_v[2][i] = bands.lower();
+                atr_v[0][i] = atr.update(h[i], l[i], p[i]);
+                donchian_v[0][i] = donchian.update(h[i], l[i]);
+                donchian_v[1][i] = donchian.upper();
+                donchian_v[2][i] = donchian.lower();
+                stochastic_v[0][i] = stochastic.update(h[i], l[i], p[i]);
+                stochastic_v[1][i] = stochastic.d();
+                williams_v[0][i] = williams.update(h[i], l[i], p[i]);
+                aroon_v[0][i] = aroon.update(h[i], l[i]);
+                aroon_v[1][i] = aroon.down();
+            }
+
+            same_rows(SMA(p, n), sma_v);
+            same_rows(EMA(p, n), ema_v);
+            same_rows(RSI(p, n), rsi_v);
+            same_rows(VWMA(p, v, n), vwma_v);
+            same_rows(Momentum(p, n), momentum_v);
+            same_rows(MACD(p, n, n + 12), macd_v);
+            same_rows(BollingerBands(p, n, 2.0), bands_v);
+            same_rows(ATR(h, l, p, n), atr_v);
+            same_rows(Donchian(h, l, n), donchian_v);
+            same_rows(Stochastic(h, l, p, n, 3), stochastic_v);
+            same_rows(WilliamsR(h, l, p, n), williams_v);
+            same_rows(Aroon(h, l, n), aroon_v);
+
+            // seeding with the whole history lands on the last streamed value
+            auto last = [](const double &x, const std::vector<double> &row)
+            { return x == row.back() || (std::isnan(x) && std::isnan(row.back())); };
+            stream::SMA sma_seeded(n);
+            stream::RSI rsi_seeded(n);
+            stream::Donchian donchian_seeded(n);
+            stream::Aroon aroon_seeded(n);
+            sma_seeded.seed(p);
+            rsi_seeded.seed(p);
+            donchian_seeded.seed(h, l);
+            aroon_seeded.seed(h, l);
+            assert(last(sma_seeded.value(), sma_v[0]) && last(rsi_seeded.value(), rsi_v[0]));
+            assert(last(donchian_seeded.upper(), donchian_v[1]) && last(donchian_seeded.lower(), donchian_v[2]));
+            assert(last(aroon_seeded.value(), aroon_v[0]) && last(aroon_seeded.down(), aroon_v[1]));
+        }
+        printf("streaming indicators match the batch rows bar by bar\n");
+    }
+}
+
+int main()
+{
+    test_macd_float();
+    test_cache();
+    test_stream();
+    test_pipeline();
+    test_wma();
+    test_scan();
+    test_multi();
+    return 0;
+}
@@ -0,0 +1,133 @@
+/**
+ * @file universe.cc
+ * @license This file is licensed under the GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007. You may obtain a copy of this license at https://www.gnu.org/licenses/gpl-3.0.en.html.
+ * @author Tushar Chaurasia (Dark-CodeX)
+ */
+
+#include "./universe.hh"
+
+namespace core::indicators::universe
+{
+    bool resolve_kind(const std::string &label, kind &out)
+    {
+        if (label == "SMA")
+            out = kind::SMA;
+        else if (label == "EMA")
+            out = kind::EMA;
+        else if (label == "WMA")
+            out = kind::WMA;
+        else if (label == "VWMA")
+            out = kind::VWMA;
+        else if (label == "MACD")
+            out = kind::MACD;
+        else if (label == "RSI")
+            out = kind::RSI;
+        else if (label == "BollingerBands")
+            out = kind::BOLLINGER_BANDS;
+        else if (label == "ATR")
+            out = kind::ATR;
+        else if (label == "Momentum")
+            out = kind::MOMENTUM;
+        else if (label == "Donchian")
+            out = kind::DONCHIAN;
+        else if (label == "Stochastic")
+            out = kind::STOCHASTIC;
+        else if (label == "WilliamsR")
+            out = kind::WILLIAMS_R;
+        else if (label == "Aroon")
+            out = kind::AROON;
+        else
+            return false;
+        return true;
+    }
+
+    std::size_t rows(const kind &indicator)
+    {
+        switch (indicator)
+        {
+        case kind::BOLLINGER_BANDS:
+        case kind::DONCHIAN:
+            return 3;
+        case kind::STOCHASTIC:
+        case kind::AROON:
+            return 2;
+        default:
+            return 1;
+        }
+    }
+
+    bool resolve_line(const kind &indicator, const std::string &line, std::size_t &out)
+    {
+        static const char *const bands[] = {"middle", "upper", "lower"}, *const stochastic[] = {"k", "d"}, *const aroon[] = {"up", "down"};
+        std::span<const char *const> names;
+        if (indicator == kind::BOLLINGER_BANDS || indicator == kind::DONCHIAN)
+            names = bands;
+        else if (indicator == kind::STOCHASTIC)
+            names = stochastic;
+        else if (indicator == kind::AROON)
+            names = aroon;
+
+        if (line.empty())
+        {
+            out = 0;
+            return true;
+        }
+        for (std::size_t i = 0; i < names.size(); i++)
+        {
+            if (line == names[i])
+            {
+                out = i;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::vector<double> compute(const series &s, const spec &sp)
+    {
+        switch (sp.indicator)
+        {
+        case kind::SMA:
+            return SMA(s.prices, sp.n);
+        case kind::EMA:
+            return EMA(s.prices, sp.n);
+        case kind::WMA:
+            return WMA(s.prices, sp.weights.c_str(), sp.n);
+        case kind::VWMA:
+            return VWMA(s.prices, s.volumes, sp.n);
+        case kind::MACD:
+            return MACD(s.prices, sp.n, sp.slow);
+        case kind::RSI:
+            return RSI(s.prices, sp.n);
+        case kind::BOLLINGER_BANDS:
+            return BollingerBands(s.prices, sp.n, sp.k);
+        case kind::ATR:
+            return ATR(s.highs, s.lows, s.prices, sp.n);
+        case kind::MOMENTUM:
+            return Momentum(s.prices, sp.n);
+        case kind::DONCHIAN:
+            return Donchian(s.highs, s.lows, sp.n);
+        case kind::STOCHASTIC:
+            return Stochastic(s.highs, s.lows, s.prices, sp.n, sp.slow);
+        case kind::WILLIAMS_R:
+            return WilliamsR(s.highs, s.lows, s.prices, sp.n);
+        case kind::AROON:
+            return Aroon(s.highs, s.lows, sp.n);
+        default:
+            return {};
+        }
+    }
+
+    std::vector<std::vector<std::vector<double>>> compute(std::span<const series> symbols, std::span<const spec> specs, thread_pool::pool &workers)
+    {
+        std::vector<std::vector<std::vector<double>>> res(symbols.size(), std::vector<std::vector<double>>(specs.size()));
+        if (specs.empty())
+            return res;
+
+        // (symbol, spec) pairs in symbol-major order, so a task's pairs mostly share the same columns in cache;
+        // each pair writes only its own slot of `res`
+        workers.parallel_for(symbols.size() * specs.size(), [&](std::size_t t)
+                             { res[t / specs.size()][t % specs.size()] = compute(symbols[t / specs.size()], specs[t % specs.size()]); });
+        return res;
+    }
+}
@@ -0,0 +1,112 @@
+/**
+ * @file universe.hh
+ * @license This file is licensed under the GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007. You may obtain a copy of this license at https://www.gnu.org/licenses/gpl-3.0.en.html.
+ * @author Tushar Chaurasia (Dark-CodeX)
+ */
+
+#ifndef QUANTZ_INDICATOR_UNIVERSE_HH
+#define QUANTZ_INDICATOR_UNIVERSE_HH
+
+#include <string>
+
+#include "./indicators.hh"
+#include "../thread_pool/thread_pool.hh"
+
+/**
+ * Indicators over many symbols at once. Every (symbol, indicator) pair is an independent task on a
+ * work-stealing pool, so a screen over thousands of series keeps every core busy even when the series
+ * have very different lengths.
+ */
+namespace core::indicators::universe
+{
+    enum class kind : std::uint8_t
+    {
+        SMA,
+        EMA,
+        WMA,
+        VWMA,
+        MACD,
+        RSI,
+        BOLLINGER_BANDS,
+        ATR,
+        MOMENTUM,
+        DONCHIAN,
+        STOCHASTIC,
+        WILLIAMS_R,
+        AROON
+    };
+
+    struct spec
+    {
+        kind indicator = kind::SMA;
+        // period, or the fast period of MACD
+        std::size_t n = 0;
+        // slow period of MACD, %D period of Stochastic
+        std::size_t slow = 0;
+        // band width of BollingerBands
+        double k = 2.0;
+        // weight scheme of WMA
+        std::string weights = "linear";
+    };
+
+    /**
+     * @brief One symbol's columns, columns an indicator does not use may be empty
+     */
+    struct series
+    {
+        // closing prices, the input of every price indicator and the closes of ATR, Stochastic and WilliamsR
+        std::span<const double> prices;
+        std::span<const double> highs;
+        std::span<const double> lows;
+        std::span<const double> volumes;
+    };
+
+    /**
+     * @brief Maps an indicator label (as used by the strategy nodes) to its kind
+     *
+     * @param label "SMA", "EMA", "WMA", "VWMA", "MACD", "RSI", "BollingerBands", "ATR", "Momentum", "Donchian",
+     * "Stochastic", "WilliamsR" or "Aroon"
+     * @param out Kind of the label
+     * @return false if the label is unknown
+     */
+    bool resolve_kind(const std::string &label, kind &out);
+
+    /**
+     * @brief Rows of the result of an indicator, each as long as the series
+     *
+     * @return 3 for BollingerBands and Donchian, 2 for Stochastic and Aroon, 1 otherwise
+     */
+    std::size_t rows(const kind &indicator);
+
+    /**
+     * @brief Maps a line name of an indicator (as used by the strategy nodes, lower-case) to its row
+     *
+     * @param indicator Kind of the indicator
+     * @param line "middle", "upper" or "lower" (BollingerBands, Donchian), "k" or "d" (Stochastic), "up" or
+     * "down" (Aroon); empty for the first row of any indicator
+     * @param out Row of the line, below `rows(indicator)`
+     * @return false if the indicator has no such line
+     */
+    bool resolve_line(const kind &indicator, const std::string &line, std::size_t &out);
+
+    /**
+     * @brief Computes one indicator of one symbol, exactly the batch function of `core::indicators`
+     *
+     * @param s Columns of the symbol
+     * @param sp Indicator and its parameters
+     * @return Result of the batch function, `rows(sp.indicator)` x N, empty on invalid input
+     */
+    std::vector<double> compute(const series &s, const spec &sp);
+
+    /**
+     * @brief Computes every spec for every symbol on `workers`
+     *
+     * @param symbols Columns of each symbol
+     * @param specs Indicators to compute for each symbol
+     * @param workers Pool running the (symbol, spec) tasks
+     * @return result[symbol][spec]
+     */
+    std::vector<std::vector<std::vector<double>>> compute(std::span<const series> symbols, std::span<const spec> specs, thread_pool::pool &workers = thread_pool::shared());
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,283 @@
+/**
+ * @file ingest.cc
+ * @license This file is licensed under the GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007. You may obtain a copy of this license at https://www.gnu.org/licenses/gpl-3.0.en.html.
+ * @author Tushar Chaurasia (Dark-CodeX)
+ */
+
+#include "./ingest.hh"
+
+namespace core::ingest
+{
+    namespace
+    {
+        // bytes per parse task, large enough that the split scan is negligible
+        constexpr std::size_t CHUNK = 1 << 20;
+
+        std::string_view trim(std::string_view s)
+        {
+            while (!s.empty() && (s.front() == ' ' || s.front() == '\t' || s.front() == '"'))
+                s.remove_prefix(1);
+            while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '"' || s.back() == '\r'))
+                s.remove_suffix(1);
+            return s;
+        }
+
+        bool iequals(std::string_view a, std::string_view b)
+        {
+            return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y)
+                                                      { return (x | 0x20) == (y | 0x20); });
+        }
+
+        // next cell of `line` starting at `pos`, a quoted cell may contain commas
+        std::string_view next_cell(std::string_view line, std::size_t &pos)
+        {
+            std::size_t begin = pos, end;
+            if (pos < line.size() && line[pos] == '"')
+            {
+                std::size_t close = line.find('"', pos + 1);
+                end = line.find(',', close == std::string_view::npos ? line.size() : close);
+            }
+            else
+                end = line.find(',', pos);
+            if (end == std::string_view::npos)
+                end = line.size();
+            pos = end + 1;
+            return line.substr(begin, end - begin);
+        }
+
+        bool blank(std::string_view line)
+        {
+            return trim(line).empty();
+        }
+
+        // fixed-width unsigned integer of 1 to `max` digits
+        bool read_uint(std::string_view &s, const std::size_t &max, unsigned &out)
+        {
+            std::size_t n = 0;
+            out = 0;
+            while (n < s.size() && n < max && s[n] >= '0' && s[n] <= '9')
+                out = out * 10 + (s[n++] - '0');
+            s.remove_prefix(n);
+            return n != 0;
+        }
+
+        bool valid_date(const unsigned &y, const unsigned &m, const unsigned &d)
+        {
+            static constexpr unsigned DAYS[12] = {31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+            if (m < 1 || m > 12 || d < 1 || d > DAYS[m - 1])
+                return false;
+            return m != 2 || d < 29 || (y % 4 == 0 && (y % 100 != 0 || y % 400 == 0));
+        }
+    }
+
+    store::columns table::view() const
+    {
+        store::columns c;
+        c.date = date;
+        for (std::size_t f = 0; f < store::FIELDS; f++)
+            c.fields[f] = fields[f];
+        return c;
+    }
+
+    bool resolve_column(std::string_view name, int &out)
+    {
+        name = trim(name);
+        if (iequals(name, "Date"))
+            out = -1;
+        else if (iequals(name, "Close") || iequals(name, "Close/Last"))
+            out = (int)store::field::CLOSE;
+        else if (iequals(name, "Open"))
+            out = (int)store::field::OPEN;
+        else if (iequals(name, "High"))
+            out = (int)store::field::HIGH;
+        else if (iequals(name, "Low"))
+            out = (int)store::field::LOW;
+        else if (iequals(name, "Volume"))
+            out = (int)store::field::VOLUME;
+        else
+            return false;
+        return true;
+    }
+
+    double parse_number(std::string_view cell, const bool &dollar)
+    {
+        cell = trim(cell);
+        bool negative = false;
+        if (dollar && cell.size() > 1 && (cell[0] == '-' || cell[0] == '+') && cell[1] == '$')
+        {
+            negative = cell[0] == '-';
+            cell.remove_prefix(1);
+        }
+        if (dollar && !cell.empty() && cell[0] == '$')
+            cell.remove_prefix(1);
+        // from_chars takes no leading '+'
+        if (!cell.empty() && cell[0] == '+')
+            cell.remove_prefix(1);
+        if (cell.empty())
+            return std::numeric_limits<double>::quiet_NaN();
+
+        double v;
+        auto [end, ec] = std::from_chars(cell.data(), cell.data() + cell.size(), v);
+        if (ec != std::errc() || end != cell.data() + cell.size())
+            return std::numeric_limits<double>::quiet_NaN();
+        return negative ? -v : v;
+    }
+
+    std::int64_t parse_date(std::string_view cell)
+    {
+        cell = trim(cell);
+        unsigned y, m, d;
+        if (cell.size() >= 5 && cell[4] == '-')
+        {
+            // %Y-%m-%d
+            if (!read_uint(cell, 4, y) || cell.empty() || cell[0] != '-')
+                return NO_DATE;
+            cell.remove_prefix(1);
+            if (!read_uint(cell, 2, m) || cell.empty() || cell[0] != '-')
+                return NO_DATE;
+            cell.remove_prefix(1);
+            if (!read_uint(cell, 2, d) || !cell.empty())
+                return NO_DATE;
+        }
+        else
+        {
+            // %m/%d/%Y
+            if (!read_uint(cell, 2, m) || cell.empty() || cell[0] != '/')
+                return NO_DATE;
+            cell.remove_prefix(1);
+            if (!read_uint(cell, 2, d) || cell.empty() || cell[0] != '/')
+                return NO_DATE;
+            cell.remove_prefix(1);
+            if (cell.size() != 4 || !read_uint(cell, 4, y))
+                return NO_DATE;
+        }
+        if (!valid_date(y, m, d))
+            return NO_DATE;
+        return store::days_from_civil(y, m, d);
+    }
+
+    table parse(std::string_view text, const bool &reverse, thread_pool::pool &workers)
+    {
+        table t;
+        // UTF-8 byte order mark of spreadsheet exports
+        if (text.substr(0, 3) == "\xEF\xBB\xBF")
+            text.remove_prefix(3);
+        std::size_t eol = text.find('\n');
+        std::string_view head = text.substr(0, eol);
+        if (blank(head))
+            return t;
+        t.ok = true;
+
+        // position of each file column in `t`, -2 for columns that are skipped
+        std::vector<int> slot;
+        for (std::size_t pos = 0; pos <= head.size();)
+        {
+            int c;
+            std::string_view name = next_cell(head, pos);
+            if (resolve_column(name, c) && (c == -1 ? !t.has_date : !t.present[c]))
+            {
+                (c == -1 ? t.has_date : t.present[c]) = true;
+                t.order.emplace_back(c);
+                slot.emplace_back(c);
+            }
+            else
+                slot.emplace_back(-2);
+        }
+
+        std::string_view body = eol == std::string_view::npos ? std::string_view() : text.substr(eol + 1);
+
+        // chunks end right after a '\n', so no line is split between two tasks
+        std::vector<std::size_t> cuts{0};
+        while (cuts.back() < body.size())
+        {
+            std::size_t next = cuts.back() + CHUNK;
+            if (next >= body.size())
+                next = body.size();
+            else
+            {
+                next = body.find('\n', next);
+                next = next == std::string_view::npos ? body.size() : next + 1;
+            }
+            cuts.emplace_back(next);
+        }
+        const std::size_t chunks = cuts.size() - 1;
+
+        auto for_lines = [&](std::size_t c, auto fn)
+        {
+            std::string_view part = body.substr(cuts[c], cuts[c + 1] - cuts[c]);
+            for (std::size_t pos = 0; pos < part.size();)
+            {
+                std::size_t end = part.find('\n', pos);
+                if (end == std::string_view::npos)
+                    end = part.size();
+                std::string_view line = part.substr(pos, end - pos);
+                pos = end + 1;
+                if (!blank(line))
+                    fn(line);
+            }
+        };
+
+        // pass 1: rows per chunk, their prefix sum is the first row of each chunk
+        std::vector<std::size_t> first(chunks + 1, 0);
+        workers.parallel_for(chunks, [&](std::size_t c)
+                             { for_lines(c, [&](std::string_view)
+                                         { first[c + 1]++; }); }, 1);
+        for (std::size_t c = 0; c < chunks; c++)
+            first[c + 1] += first[c];
+        t.rows = first[chunks];
+
+        if (t.has_date)
+            t.date.assign(t.rows, NO_DATE);
+        for (std::size_t f = 0; f < store::FIELDS; f++)
+        {
+            if (t.present[f])
+                t.fields[f].assign(t.rows, std::numeric_limits<double>::quiet_NaN());
+        }
+
+        // pass 2: every row goes straight to its final position
+        workers.parallel_for(chunks, [&](std::size_t c)
+                             {
+                                 std::size_t row = first[c];
+                                 for_lines(c, [&](std::string_view line)
+                                           {
+                                               const std::size_t at = reverse ? t.rows - 1 - row : row;
+                                               std::size_t pos = 0;
+                                               for (std::size_t k = 0; k < slot.size() && pos <= line.size(); k++)
+                                               {
+                                                   std::string_view cell = next_cell(line, pos);
+                                                   if (slot[k] == -1)
+                                                       t.date[at] = parse_date(cell);
+                                                   else if (slot[k] >= 0)
+                                                       t.fields[slot[k]][at] = parse_number(cell, slot[k] != (int)store::field::VOLUME);
+                                               }
+                                               row++; }); }, 1);
+        return t;
+    }
+
+    table parse_file(const std::string &path, const bool &reverse, thread_pool::pool &workers)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return {};
+        struct stat st;
+        if (::fstat(fd, &st) != 0)
+        {
+            ::close(fd);
+            return {};
+        }
+        if (st.st_size == 0)
+        {
+            ::close(fd);
+            return parse(std::string_view(), reverse, workers);
+        }
+
+        void *p = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED)
+            return {};
+        ::madvise(p, st.st_size, MADV_SEQUENTIAL);
+        table t = parse(std::string_view(static_cast<const char *>(p), st.st_size), reverse, workers);
+        ::munmap(p, st.st_size);
+        return t;
+    }
+}
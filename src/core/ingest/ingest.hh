@@ -0,0 +1,106 @@
+/**
+ * @file ingest.hh
+ * @license This file is licensed under the GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007. You may obtain a copy of this license at https://www.gnu.org/licenses/gpl-3.0.en.html.
+ * @author Tushar Chaurasia (Dark-CodeX)
+ */
+
+#ifndef QUANTZ_INGEST_HH
+#define QUANTZ_INGEST_HH
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <array>
+#include <charconv>
+#include <system_error>
+#include <cmath>
+#include <limits>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+
+#include "../store/store.hh"
+#include "../thread_pool/thread_pool.hh"
+
+/**
+ * Native reader of the broker CSV export (what `CleanCSV` in api.py accepts):
+ *
+ *     Date,Close/Last,Volume,Open,High,Low
+ *     03/28/2025,$217.90,39818620,$221.39,$223.81,$217.68
+ *
+ * The text is split into line-aligned chunks parsed in parallel. Rows are written straight into their
+ * final (by default reversed, oldest first) position of contiguous columns, so no intermediate frame
+ * or copy is made.
+ */
+namespace core::ingest
+{
+    // date of a row whose date could not be parsed (NumPy's NaT)
+    constexpr std::int64_t NO_DATE = std::numeric_limits<std::int64_t>::min();
+
+    struct table
+    {
+        // false if the text has no header line
+        bool ok = false;
+        std::size_t rows = 0;
+        // file columns (by header position) that were recognized, in file order: -1 is the date, else a `store::field`
+        std::vector<int> order;
+        bool has_date = false;
+        std::array<bool, store::FIELDS> present{};
+        // days since 1970-01-01, `NO_DATE` where unparseable
+        std::vector<std::int64_t> date;
+        // NaN where a value is missing or not a number
+        std::array<std::vector<double>, store::FIELDS> fields;
+
+        store::columns view() const;
+    };
+
+    /**
+     * @brief Maps a header name to its column
+     *
+     * @param name Header cell, surrounding spaces and quotes ignored, case-insensitive
+     * {"Date", "Close", "Close/Last", "Open", "High", "Low", "Volume"}
+     * @param out -1 for the date, else the `store::field`
+     * @return false for any other name (the column is skipped)
+     */
+    bool resolve_column(std::string_view name, int &out);
+
+    /**
+     * @brief Parses a number, optionally `$`-prefixed ("$217.90", "-$1.5", "$-1.5")
+     *
+     * @param cell Cell text, surrounding spaces and quotes ignored
+     * @param dollar Whether a `$` is accepted (price columns)
+     * @return Value, NaN if empty or not a number
+     */
+    double parse_number(std::string_view cell, const bool &dollar);
+
+    /**
+     * @brief Parses a US `%m/%d/%Y` date (ISO `%Y-%m-%d` is accepted too)
+     *
+     * @param cell Cell text, surrounding spaces and quotes ignored
+     * @return Days since 1970-01-01, `NO_DATE` if not a valid date
+     */
+    std::int64_t parse_date(std::string_view cell);
+
+    /**
+     * @brief Parses a whole CSV text
+     *
+     * @param text CSV text, the first line is the header; blank lines are skipped
+     * @param reverse Store the rows in reverse file order (the broker export is newest first)
+     * @param workers Pool parsing the chunks
+     * @return Columns of the recognized header names
+     */
+    table parse(std::string_view text, const bool &reverse = true, thread_pool::pool &workers = thread_pool::shared());
+
+    /**
+     * @brief Maps a CSV file and parses it
+     *
+     * @param path File to read
+     * @param reverse Store the rows in reverse file order
+     * @param workers Pool parsing the chunks
+     * @return Columns, `ok` is false if the file cannot be read
+     */
+    table parse_file(const std::string &path, const bool &reverse = true, thread_pool::pool &workers = thread_pool::shared());
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,73 @@
+/**
+ * @file unit_test.cc
+ * @license This file is licensed under the GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007. You may obtain a copy of this license at https://www.gnu.org/licenses/gpl-3.0.en.html.
+ * @author Tushar Chaurasia (Dark-CodeX)
+ */
+
+#include <cassert>
+#include <cstdio>
+#include "./ingest.hh"
+
+int main()
+{
+    using namespace core;
+    using store::field;
+
+    // the broker export: quoted cells (one holding a comma in a column that is skipped), dollar prices, a
+    // missing and an impossible date, empty and non-numeric cells, CRLF endings and a blank line
+    const std::string text = "\xEF\xBB\xBF"
+                             "Date,\"Close/Last\",Volume,Note,Open,High,Low\r\n"
+                             "\"03/15/2024\",\"$172.62\",\"121136800\",\"split, 4:1\",$171.17,$172.62,$170.285\r\n"
+                             ",$173.00,1000,,$1,$2,$0.5\r\n"
+                             "\r\n"
+                             "02/30/2024,-$1.5,,x,N/A,,$-2\r\n"
+                             "2024-02-29,nan,\"12\",\"\",\"$3\",$4,$5\r\n";
+    const ingest::table t = ingest::parse(text, false);
+    assert(t.ok && t.rows == 4 && t.has_date);
+    assert((t.order == std::vector<int>{-1, (int)field::CLOSE, (int)field::VOLUME, (int)field::OPEN, (int)field::HIGH, (int)field::LOW}));
+    const std::span<const double> close = t.fields[(std::size_t)field::CLOSE], volume = t.fields[(std::size_t)field::VOLUME];
+    const std::span<const double> open = t.fields[(std::size_t)field::OPEN], high = t.fields[(std::size_t)field::HIGH], low = t.fields[(std::size_t)field::LOW];
+
+    assert(t.date[0] == store::days_from_civil(2024, 3, 15) && t.date[1] == ingest::NO_DATE && t.date[2] == ingest::NO_DATE);
+    assert(t.date[3] == store::days_from_civil(2024, 2, 29));
+    assert(close[0] == 172.62 && volume[0] == 121136800.0 && open[0] == 171.17 && high[0] == 172.62 && low[0] == 170.285);
+    assert(close[1] == 173.0 && volume[1] == 1000.0 && open[1] == 1.0 && high[1] == 2.0 && low[1] == 0.5);
+    assert(close[2] == -1.5 && std::isnan(volume[2]) && std::isnan(open[2]) && std::isnan(high[2]) && low[2] == -2.0);
+    assert(std::isnan(close[3]) && volume[3] == 12.0 && open[3] == 3.0 && high[3] == 4.0 && low[3] == 5.0);
+
+    // newest first by default: the same rows, last line first
+    const ingest::table r = ingest::parse(text);
+    assert(r.rows == t.rows && r.date[0] == t.date[3] && r.fields[(std::size_t)field::LOW][3] == low[0]);
+
+    // the cell helpers on their own
+    assert(ingest::parse_number(" \"$1e3\" ", true) == 1000.0 && std::isnan(ingest::parse_number("$5", false)));
+    assert(std::isnan(ingest::parse_number("1,234", false)) && std::isnan(ingest::parse_number("", true)));
+    assert(ingest::parse_date("12/31/1969") == -1 && ingest::parse_date("1/2/1970") == 1 && ingest::parse_date("2023-02-29") == ingest::NO_DATE);
+
+    // no header line: not ok; a header alone: no rows
+    assert(!ingest::parse("\r\n1,2\n").ok);
+    const ingest::table head = ingest::parse("Date,Close");
+    assert(head.ok && head.rows == 0 && head.present[(std::size_t)field::CLOSE] && !head.present[(std::size_t)field::OPEN]);
+
+    // several parse chunks: every row lands in its place, newest first
+    std::string big = "Date,Close,Volume\n";
+    const std::size_t rows = 120000;
+    for (std::size_t i = 0; i < rows; i++)
+    {
+        big += i % 97 == 0 ? std::string() : "\"1970-01-01\"";
+        big += ",\"$" + std::to_string(i) + ".25\"," + (i % 13 == 0 ? std::string("-") : std::to_string(i * 3)) + "\n";
+    }
+    assert(big.size() > 2 * (std::size_t(1) << 20));
+    const ingest::table b = ingest::parse(big);
+    assert(b.rows == rows);
+    for (std::size_t i = 0; i < rows; i++)
+    {
+        const std::size_t at = rows - 1 - i;
+        assert(b.date[at] == (i % 97 == 0 ? ingest::NO_DATE : 0));
+        assert(b.fields[(std::size_t)field::CLOSE][at] == (double)i + 0.25);
+        assert(i % 13 == 0 ? std::isnan(b.fields[(std::size_t)field::VOLUME][at]) : b.fields[(std::size_t)field::VOLUME][at] == (double)(i * 3));
+    }
+    printf("CSV parsing handles quoted cells, missing dates and NaN cells\n");
+
+    return 0;
+}
@@ -0,0 +1,359 @@
+/**
+ * @file live.cc
+ * @license This file is licensed under the GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007. You may obtain a copy of this license at https://www.gnu.org/licenses/gpl-3.0.en.html.
+ * @author Tushar Chaurasia (Dark-CodeX)
+ */
+
+#include "./live.hh"
+
+namespace core::live
+{
+    namespace
+    {
+        // empty polls before a waiting side yields its core, the other side may be sharing it
+        constexpr std::size_t SPINS = 64;
+
+        std::int64_t now_ns()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        double field_of(const event &e, const store::field &f)
+        {
+            switch (f)
+            {
+            case store::field::OPEN:
+                return e.open;
+            case store::field::HIGH:
+                return e.high;
+            case store::field::LOW:
+                return e.low;
+            case store::field::VOLUME:
+                return e.volume;
+            default:
+                return e.close;
+            }
+        }
+
+        double cell(std::span<const double> column, const std::size_t &i)
+        {
+            return i < column.size() ? column[i] : std::numeric_limits<double>::quiet_NaN();
+        }
+
+        bool ends_with(const std::string &s, std::string_view suffix)
+        {
+            return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+        }
+    }
+
+    void histogram::record(const std::int64_t &ns)
+    {
+        const std::uint64_t v = ns > 0 ? (std::uint64_t)ns : 0;
+        std::size_t index = v;
+        if (v >= SUB)
+        {
+            // the top SUB_BITS + 1 bits select the bucket
+            const std::size_t shift = std::bit_width(v) - SUB_BITS - 1;
+            index = (shift + 1) * SUB + (std::size_t)(v >> shift) - SUB;
+        }
+        buckets[index]++;
+        samples++;
+        largest = std::max<std::int64_t>(largest, (std::int64_t)v);
+    }
+
+    double histogram::percentile(const double &q) const
+    {
+        if (samples == 0)
+            return 0.0;
+        const double rank = std::clamp(q, 0.0, 100.0) / 100.0 * (double)samples;
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < buckets.size(); i++)
+        {
+            seen += buckets[i];
+            if (buckets[i] != 0 && (double)seen >= rank)
+            {
+                if (i < SUB)
+                    return (double)i;
+                // middle of the bucket, never past the largest sample
+                const std::size_t shift = i / SUB - 1;
+                const double low = (double)((i % SUB + SUB) << shift), width = (double)(std::uint64_t(1) << shift);
+                return std::min(low + width / 2, max());
+            }
+        }
+        return max();
+    }
+
+    engine::engine(strategy::dag graph, std::span<const indicator_node> indicators, const options &opts)
+        : opts(opts), queue(opts.capacity), nodes(indicators.begin(), indicators.end()), ticks(opts.by, opts.threshold)
+    {
+        using namespace indicators::universe;
+        namespace stream = indicators::stream;
+
+        for (std::size_t i = 0; i < nodes.size(); i++)
+        {
+            const spec &sp = nodes[i].spec;
+            switch (sp.indicator)
+            {
+            case kind::SMA:
+                states.emplace_back(stream::SMA(sp.n));
+                break;
+            case kind::EMA:
+                states.emplace_back(stream::EMA(sp.n));
+                break;
+            case kind::VWMA:
+                states.emplace_back(stream::VWMA(sp.n));
+                break;
+            case kind::MACD:
+                states.emplace_back(stream::MACD(sp.n, sp.slow));
+                break;
+            case kind::RSI:
+                states.emplace_back(stream::RSI(sp.n));
+                break;
+            case kind::BOLLINGER_BANDS:
+                states.emplace_back(stream::BollingerBands(sp.n, sp.k));
+                break;
+            case kind::ATR:
+                states.emplace_back(stream::ATR(sp.n));
+                break;
+            case kind::MOMENTUM:
+                states.emplace_back(stream::Momentum(sp.n));
+                break;
+            case kind::DONCHIAN:
+                states.emplace_back(stream::Donchian(sp.n));
+                break;
+            case kind::STOCHASTIC:
+                states.emplace_back(stream::Stochastic(sp.n, sp.slow));
+                break;
+            case kind::WILLIAMS_R:
+                states.emplace_back(stream::WilliamsR(sp.n));
+                break;
+            case kind::AROON:
+                states.emplace_back(stream::Aroon(sp.n));
+                break;
+            default:
+                states.emplace_back(std::monostate());
+                break;
+            }
+            if (nodes[i].node < graph.nodes.size())
+                graph.nodes[nodes[i].node].column = i;
+        }
+        values.assign(nodes.size(), std::numeric_limits<double>::quiet_NaN());
+        prog = strategy::compile(graph);
+        slots.assign(prog.slots, 0.0);
+
+        if (opts.ticks)
+            ticks.subscribe([this](const bars::bar &b)
+                            { evaluate({b.time, b.open, b.high, b.low, b.close, b.volume, 0}); });
+    }
+
+    engine::~engine()
+    {
+        if (consumer.joinable())
+        {
+            done.store(true, std::memory_order_release);
+            consumer.join();
+        }
+    }
+
+    void engine::subscribe(std::function<void(const event &, strategy::signal)> consumer)
+    {
+        consumers.emplace_back(std::move(consumer));
+    }
+
+    void engine::reserve(const std::size_t &bars)
+    {
+        seen.signals.reserve(bars);
+    }
+
+    void engine::start()
+    {
+        if (!prog.ok || consumer.joinable())
+            return;
+        done.store(false, std::memory_order_relaxed);
+        started = std::chrono::steady_clock::now();
+        consumer = std::thread([this]
+                               { run(); });
+    }
+
+    bool engine::push(event e)
+    {
+        e.pushed = now_ns();
+        return queue.push(e);
+    }
+
+    void engine::push_wait(const event &e)
+    {
+        if (push(e))
+            return;
+        stalls++;
+        for (std::size_t spin = 0; !push(e); spin++)
+        {
+            if (spin >= SPINS)
+                std::this_thread::yield();
+        }
+    }
+
+    report engine::stop()
+    {
+        if (!consumer.joinable())
+            return {};
+        done.store(true, std::memory_order_release);
+        consumer.join();
+        if (opts.ticks)
+            ticks.flush();
+
+        report out = std::move(seen);
+        seen = report();
+        out.stalls = stalls;
+        out.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        out.p50 = latency.percentile(50);
+        out.p90 = latency.percentile(90);
+        out.p99 = latency.percentile(99);
+        out.p999 = latency.percentile(99.9);
+        out.max = latency.max();
+        stalls = 0;
+        latency = histogram();
+        return out;
+    }
+
+    void engine::run()
+    {
+        event e;
+        for (std::size_t idle = 0;;)
+        {
+            if (queue.pop(e))
+            {
+                handle(e);
+                idle = 0;
+            }
+            // everything pushed before `done` was set is visible now, drain it before leaving
+            else if (done.load(std::memory_order_acquire))
+            {
+                while (queue.pop(e))
+                    handle(e);
+                return;
+            }
+            else if (++idle >= SPINS)
+                std::this_thread::yield();
+        }
+    }
+
+    void engine::handle(const event &e)
+    {
+        if (opts.ticks)
+            ticks.update(e.time, e.close, e.volume);
+        else
+            evaluate(e);
+        seen.events++;
+        latency.record(now_ns() - e.pushed);
+    }
+
+    void engine::evaluate(const event &bar)
+    {
+        using namespace indicators::stream;
+        for (std::size_t i = 0; i < states.size(); i++)
+        {
+            const double price = field_of(bar, nodes[i].price);
+            const std::size_t row = nodes[i].row;
+            values[i] = std::visit([&](auto &s) -> double
+                                   {
+                                       using S = std::decay_t<decltype(s)>;
+                                       if constexpr (std::is_same_v<S, std::monostate>)
+                                           return std::numeric_limits<double>::quiet_NaN();
+                                       else if constexpr (std::is_same_v<S, VWMA>)
+                                           return s.update(price, bar.volume);
+                                       else if constexpr (std::is_same_v<S, ATR> || std::is_same_v<S, WilliamsR>)
+                                           return s.update(bar.high, bar.low, price);
+                                       else if constexpr (std::is_same_v<S, Stochastic>)
+                                       {
+                                           const double k = s.update(bar.high, bar.low, price);
+                                           return row == 1 ? s.d() : k;
+                                       }
+                                       else if constexpr (std::is_same_v<S, Donchian>)
+                                       {
+                                           const double middle = s.update(bar.high, bar.low);
+                                           return row == 1 ? s.upper() : row == 2 ? s.lower() : middle;
+                                       }
+                                       else if constexpr (std::is_same_v<S, Aroon>)
+                                       {
+                                           const double up = s.update(bar.high, bar.low);
+                                           return row == 1 ? s.down() : up;
+                                       }
+                                       else if constexpr (std::is_same_v<S, BollingerBands>)
+                                       {
+                                           const double middle = s.update(price);
+                                           return row == 1 ? s.upper() : row == 2 ? s.lower() : middle;
+                                       }
+                                       else
+                                           return s.update(price); },
+                                   states[i]);
+        }
+
+        const strategy::signal sig = strategy::step(prog, values, slots);
+        seen.bars++;
+        seen.buys += sig == strategy::signal::BUY;
+        seen.sells += sig == strategy::signal::SELL;
+        seen.signals.emplace_back(sig);
+        for (const std::function<void(const event &, strategy::signal)> &c : consumers)
+            c(bar, sig);
+    }
+
+    replay::replay(const std::string &path)
+    {
+        if (ends_with(path, ".csv"))
+        {
+            ingest::table &t = owner.emplace<ingest::table>(ingest::parse_file(path));
+            if (t.ok && t.has_date)
+                data = t.view();
+        }
+        else
+        {
+            store::mapped &m = owner.emplace<store::mapped>(path);
+            if (m.ok())
+                data = m.view();
+        }
+    }
+
+    replay::replay(const store::columns &data, const std::int64_t &unit) : data(data), unit(unit) {}
+
+    std::size_t replay::play(engine &sink, const double &speed) const
+    {
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        std::int64_t first = ingest::NO_DATE;
+        const store::columns &c = data;
+        for (std::size_t i = 0; i < c.date.size(); i++)
+        {
+            // rows without a date are pushed right away
+            const std::int64_t date = c.date[i];
+            if (speed > 0 && date != ingest::NO_DATE)
+            {
+                if (first == ingest::NO_DATE)
+                    first = date;
+                const double due = (double)(date - first) * (double)unit / speed;
+                std::this_thread::sleep_until(start + std::chrono::nanoseconds((std::int64_t)due));
+            }
+            event e;
+            e.time = date == ingest::NO_DATE ? date : date * unit;
+            e.open = cell(c[store::field::OPEN], i);
+            e.high = cell(c[store::field::HIGH], i);
+            e.low = cell(c[store::field::LOW], i);
+            e.close = cell(c[store::field::CLOSE], i);
+            e.volume = cell(c[store::field::VOLUME], i);
+            sink.push_wait(e);
+        }
+        return c.date.size();
+    }
+
+    report run(engine &sink, const replay &source, const double &speed)
+    {
+        if (!sink.ok())
+            return {};
+        // ticks make fewer bars than rows
+        sink.reserve(source.rows());
+        sink.start();
+        std::thread producer([&]
+                             { source.play(sink, speed); });
+        producer.join();
+        return sink.stop();
+    }
+}
@@ -0,0 +1,323 @@
+/**
+ * @file live.hh
+ * @license This file is licensed under the GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007. You may obtain a copy of this license at https://www.gnu.org/licenses/gpl-3.0.en.html.
+ * @author Tushar Chaurasia (Dark-CodeX)
+ */
+
+#ifndef QUANTZ_LIVE_HH
+#define QUANTZ_LIVE_HH
+
+#include <vector>
+#include <span>
+#include <string>
+#include <array>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <functional>
+#include <variant>
+#include <bit>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+#include "../indicators/stream.hh"
+#include "../indicators/universe.hh"
+#include "../strategy/strategy.hh"
+#include "../store/store.hh"
+#include "../ingest/ingest.hh"
+#include "../bars/bars.hh"
+
+/**
+ * Live evaluation of a strategy graph. A producer (a feed handler, or `replay`) pushes events into a
+ * single-producer single-consumer ring; the consumer thread of an `engine` pops them, updates the streaming
+ * indicators, runs the compiled strategy on the new bar and records how long the event took from push to
+ * signal. Nothing on the hot path locks, and nothing allocates while the bars fit in what `engine::reserve`
+ * set aside for their signals.
+ *
+ *     producer --push--> ring --pop--> [ticks -> bars::aggregator] -> stream indicators -> strategy::step
+ */
+namespace core::live
+{
+    // nanoseconds in a day, the timestamp unit of store files and parsed CSVs
+    constexpr std::int64_t DAY_NS = 86400LL * 1000000000LL;
+
+    struct event
+    {
+        // nanoseconds since 1970-01-01
+        std::int64_t time = 0;
+        // a tick carries its price in `close` and its size in `volume`
+        double open = 0.0, high = 0.0, low = 0.0, close = 0.0, volume = 0.0;
+        // steady clock nanoseconds when the event was pushed, set by `engine::push`
+        std::int64_t pushed = 0;
+    };
+
+    /**
+     * @brief Bounded single-producer single-consumer queue
+     *
+     * Each side writes only its own index and reads the other one, the indices live on separate cache lines
+     * and each side keeps the last value it saw of the other's, so the shared line is only read again when
+     * the ring looks full (producer) or empty (consumer).
+     */
+    template <typename T>
+    class ring
+    {
+    public:
+        // capacity is rounded up to a power of two
+        explicit ring(const std::size_t &capacity)
+            : mask(std::bit_ceil(std::max<std::size_t>(capacity, 2)) - 1), slots(mask + 1) {}
+
+        ring(const ring &) = delete;
+        ring &operator=(const ring &) = delete;
+
+        /**
+         * @brief Producer side
+         *
+         * @return false if the ring is full
+         */
+        bool push(const T &item)
+        {
+            const std::size_t h = head.load(std::memory_order_relaxed);
+            if (h - tail_seen > mask)
+            {
+                tail_seen = tail.load(std::memory_order_acquire);
+                if (h - tail_seen > mask)
+                    return false;
+            }
+            slots[h & mask] = item;
+            head.store(h + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief Consumer side
+         *
+         * @return false if the ring is empty
+         */
+        bool pop(T &item)
+        {
+            const std::size_t t = tail.load(std::memory_order_relaxed);
+            if (t == head_seen)
+            {
+                head_seen = head.load(std::memory_order_acquire);
+                if (t == head_seen)
+                    return false;
+            }
+            item = slots[t & mask];
+            tail.store(t + 1, std::memory_order_release);
+            return true;
+        }
+
+        std::size_t capacity() const { return mask + 1; }
+
+    private:
+        static constexpr std::size_t LINE = 64;
+
+        const std::size_t mask;
+        std::vector<T> slots;
+        // written by the producer
+        alignas(LINE) std::atomic<std::size_t> head{0};
+        std::size_t tail_seen = 0;
+        // written by the consumer
+        alignas(LINE) std::atomic<std::size_t> tail{0};
+        std::size_t head_seen = 0;
+    };
+
+    /**
+     * @brief Latency histogram with log-linear buckets: 32 per power of two, so a percentile is within 3%
+     * of the true value, in constant memory and O(1) per sample
+     */
+    class histogram
+    {
+    public:
+        void record(const std::int64_t &ns);
+        std::size_t count() const { return samples; }
+
+        /**
+         * @brief Value below which `q` percent of the samples fall, 0 without samples
+         */
+        double percentile(const double &q) const;
+        double max() const { return (double)largest; }
+
+    private:
+        static constexpr std::size_t SUB_BITS = 5, SUB = std::size_t(1) << SUB_BITS;
+
+        std::array<std::uint64_t, 64 * SUB> buckets{};
+        std::size_t samples = 0;
+        std::int64_t largest = 0;
+    };
+
+    /**
+     * @brief Indicator node of the graph and how to compute it from the bars
+     */
+    struct indicator_node
+    {
+        // index into `dag::nodes`
+        std::size_t node = 0;
+        indicators::universe::spec spec;
+        // bar field the indicator reads; ATR, Stochastic and WilliamsR read the high and low as well (Donchian
+        // and Aroon only those), VWMA the volume
+        store::field price = store::field::CLOSE;
+        // row of a multi-row indicator the node reads (see `universe::resolve_line`), the first by default
+        std::size_t row = 0;
+    };
+
+    struct options
+    {
+        // events the ring holds, rounded up to a power of two
+        std::size_t capacity = std::size_t(1) << 16;
+        // events are ticks, aggregated into bars by `by` and `threshold` (see `bars::aggregator`, TIME
+        // thresholds in nanoseconds) before they reach the indicators
+        bool ticks = false;
+        bars::rule by = bars::rule::TIME;
+        double threshold = 60e9;
+    };
+
+    struct report
+    {
+        std::size_t events = 0;
+        // bars the strategy was evaluated on, the events themselves unless `options::ticks`
+        std::size_t bars = 0;
+        std::size_t buys = 0, sells = 0;
+        // pushes that found the ring full and had to wait
+        std::size_t stalls = 0;
+        // from `start` to `stop`
+        double seconds = 0.0;
+        // push to signal, in nanoseconds
+        double p50 = 0.0, p90 = 0.0, p99 = 0.0, p999 = 0.0, max = 0.0;
+        // signal of every bar
+        std::vector<strategy::signal> signals;
+    };
+
+    class engine
+    {
+    public:
+        /**
+         * @brief Compiles the graph, wiring the indicator nodes to their streaming indicators
+         *
+         * WMA has no streaming form, its nodes read NaN (their comparisons never pass). A multi-row indicator
+         * node reads its `row`, as in the backtest: the middle band, %K, Aroon up unless another is chosen.
+         *
+         * @param graph Strategy graph
+         * @param indicators Indicator nodes of the graph
+         * @param opts Ring size and bar aggregation
+         */
+        engine(strategy::dag graph, std::span<const indicator_node> indicators, const options &opts = {});
+        ~engine();
+
+        engine(const engine &) = delete;
+        engine &operator=(const engine &) = delete;
+
+        /**
+         * @brief false if the graph has a cycle, `start` then does nothing
+         */
+        bool ok() const { return prog.ok; }
+
+        /**
+         * @brief Calls `consumer` on the consumer thread with every evaluated bar and its signal; subscribe
+         * before `start`
+         */
+        void subscribe(std::function<void(const event &, strategy::signal)> consumer);
+
+        /**
+         * @brief Sets aside room for the signals of `bars` bars, so recording them does not allocate on the
+         * consumer thread; call before `start`
+         */
+        void reserve(const std::size_t &bars);
+
+        /**
+         * @brief Starts the consumer thread
+         */
+        void start();
+
+        /**
+         * @brief Queues one event, from the producer thread only
+         *
+         * @return false if the ring is full, the event was not queued
+         */
+        bool push(event e);
+
+        /**
+         * @brief Queues one event, spinning (then yielding) while the ring is full
+         */
+        void push_wait(const event &e);
+
+        /**
+         * @brief Lets the consumer drain the ring, stops it and returns what it saw; in tick mode the bar in
+         * progress is closed and evaluated first
+         */
+        report stop();
+
+    private:
+        using state = std::variant<std::monostate, indicators::stream::SMA, indicators::stream::EMA, indicators::stream::VWMA,
+                                   indicators::stream::MACD, indicators::stream::RSI, indicators::stream::BollingerBands,
+                                   indicators::stream::ATR, indicators::stream::Momentum, indicators::stream::Donchian,
+                                   indicators::stream::Stochastic, indicators::stream::WilliamsR, indicators::stream::Aroon>;
+
+        strategy::program prog;
+        options opts;
+        ring<event> queue;
+        std::vector<indicator_node> nodes;
+        std::vector<state> states;
+        std::vector<double> values, slots;
+        bars::aggregator ticks;
+        std::vector<std::function<void(const event &, strategy::signal)>> consumers;
+
+        std::thread consumer;
+        std::atomic<bool> done{false};
+        std::size_t stalls = 0;
+        std::chrono::steady_clock::time_point started;
+        histogram latency;
+        report seen;
+
+        void run();
+        void handle(const event &e);
+        void evaluate(const event &bar);
+    };
+
+    /**
+     * @brief Replays recorded bars (or ticks) into an engine as if they arrived live
+     */
+    class replay
+    {
+    public:
+        /**
+         * @brief Opens a store file, or a CSV if the path ends in ".csv"; `ok()` is false if it could not
+         * be read. Their dates are days, so `unit` is `DAY_NS`.
+         */
+        explicit replay(const std::string &path);
+
+        /**
+         * @brief Rows already in memory, they must outlive the replay
+         *
+         * @param data Columns, `date` holds the timestamps (ticks put the price in CLOSE and the size in VOLUME)
+         * @param unit Nanoseconds per timestamp unit
+         */
+        replay(const store::columns &data, const std::int64_t &unit);
+
+        bool ok() const { return !data.date.empty(); }
+        std::size_t rows() const { return data.date.size(); }
+
+        /**
+         * @brief Pushes every row into `sink` from the calling thread, in order
+         *
+         * @param sink Started engine
+         * @param speed Playback rate: 1 replays in real time, 60 a minute per second; 0 or less pushes as
+         * fast as the consumer drains the ring
+         * @return Rows pushed
+         */
+        std::size_t play(engine &sink, const double &speed = 0.0) const;
+
+    private:
+        std::variant<std::monostate, store::mapped, ingest::table> owner;
+        store::columns data;
+        std::int64_t unit = DAY_NS;
+    };
+
+    /**
+     * @brief Starts `sink`, plays `source` into it from a producer thread and stops it
+     */
+    report run(engine &sink, const replay &source, const double &speed = 0.0);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,158 @@
+/**
+ * @file unit_test.cc
+ * @license This file is licensed under the GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007. You may obtain a copy of this license at https://www.gnu.org/licenses/gpl-3.0.en.html.
+ * @author Tushar Chaurasia (Dark-CodeX)
+ */
+
+#include <cassert>
+#include <cstdio>
+#include "./live.hh"
+
+namespace
+{
+    using namespace core;
+
+    struct graph_builder
+    {
+        strategy::dag g;
+        std::vector<live::indicator_node> indicators;
+
+        graph_builder()
+        {
+            g.nodes.emplace_back();
+            g.start = 0;
+        }
+
+        std::size_t add(const strategy::node &n, const std::size_t &parent)
+        {
+            g.nodes.emplace_back(n);
+            g.nodes[parent].children.emplace_back(g.nodes.size() - 1);
+            return g.nodes.size() - 1;
+        }
+
+        // Start -> indicator (its `row`) -> (`op` threshold) -> action
+        void rule(const indicators::universe::kind &kd, const std::size_t &n, const std::size_t &row, const strategy::opcode &op, const double &threshold, const strategy::signal &action)
+        {
+            strategy::node ind, cmp, act;
+            ind.kind = strategy::node_kind::INDICATOR;
+            cmp.kind = strategy::node_kind::OPERATOR;
+            cmp.op = op;
+            cmp.threshold = threshold;
+            cmp.has_threshold = true;
+            act.kind = strategy::node_kind::ACTION;
+            act.action = action;
+            const std::size_t i = add(ind, 0);
+            add(act, add(cmp, i));
+
+            live::indicator_node in;
+            in.node = i;
+            in.spec.indicator = kd;
+            in.spec.n = n;
+            in.spec.slow = kd == indicators::universe::kind::MACD ? 2 * n : 3;
+            in.row = row;
+            indicators.emplace_back(in);
+        }
+
+        // the batch signals: every node reads its row of the batch indicator, WMA (no streaming form) NaN
+        std::vector<strategy::signal> batch(const indicators::universe::series &s, std::vector<std::vector<double>> &kept) const
+        {
+            strategy::dag copy = g;
+            std::vector<std::span<const double>> columns;
+            const std::size_t len = s.prices.size();
+            kept.clear();
+            kept.reserve(indicators.size());
+            for (std::size_t i = 0; i < indicators.size(); i++)
+            {
+                std::vector<double> res = indicators[i].spec.indicator == indicators::universe::kind::WMA ? std::vector<double>() : indicators::universe::compute(s, indicators[i].spec);
+                if (res.empty())
+                    res.assign(len, std::numeric_limits<double>::quiet_NaN());
+                kept.emplace_back(res.begin() + indicators[i].row * len, res.begin() + (indicators[i].row + 1) * len);
+                columns.emplace_back(kept.back());
+                copy.nodes[indicators[i].node].column = i;
+            }
+            return strategy::signals(copy, columns, len);
+        }
+    };
+}
+
+int main()
+{
+    using indicators::universe::kind;
+    using strategy::opcode;
+    using strategy::signal;
+
+    // daily bars with a NaN close
+    const std::size_t len = 3000;
+    std::vector<std::int64_t> dates(len);
+    std::vector<double> open(len), high(len), low(len), close(len), volume(len);
+    double p = 100.0;
+    for (std::size_t i = 0; i < len; i++)
+    {
+        p *= 1.0 + 0.01 * std::sin(0.37 * (double)i) + 0.002 * std::cos(1.91 * (double)i);
+        dates[i] = (std::int64_t)i;
+        open[i] = p * (1.0 + 0.001 * std::sin(0.9 * (double)i));
+        close[i] = p;
+        high[i] = p * (1.0 + 0.004 * (1.0 + std::sin(0.71 * (double)i)));
+        low[i] = p * (1.0 - 0.004 * (1.0 + std::cos(0.53 * (double)i)));
+        volume[i] = 1000.0 + 500.0 * std::sin(0.11 * (double)i);
+    }
+    close[1234] = std::numeric_limits<double>::quiet_NaN();
+
+    // rules in priority order over several kinds and rows (the last rule added is tried first)
+    graph_builder b;
+    b.rule(kind::SMA, 20, 0, opcode::GT, 101.0, signal::BUY);
+    b.rule(kind::RSI, 14, 0, opcode::GT, 70.0, signal::SELL);
+    b.rule(kind::DONCHIAN, 10, 1, opcode::LT, 99.0, signal::BUY);
+    b.rule(kind::STOCHASTIC, 14, 1, opcode::LT, 20.0, signal::BUY);
+    b.rule(kind::AROON, 25, 1, opcode::GE, 90.0, signal::SELL);
+    b.rule(kind::BOLLINGER_BANDS, 20, 2, opcode::GT, 100.0, signal::SELL);
+    b.rule(kind::MACD, 6, 0, opcode::GT, 0.5, signal::BUY);
+    b.rule(kind::WMA, 10, 0, opcode::LT, 1e9, signal::SELL);
+
+    // bars replayed through the engine give the batch signals
+    store::columns data;
+    data.date = dates;
+    data.fields = {open, high, low, close, volume};
+    live::engine bar_engine(b.g, b.indicators);
+    assert(bar_engine.ok());
+    std::size_t delivered = 0;
+    bar_engine.subscribe([&](const live::event &, signal)
+                         { delivered++; });
+    const live::report bar_report = live::run(bar_engine, live::replay(data, live::DAY_NS));
+    std::vector<std::vector<double>> columns;
+    const std::vector<signal> expected = b.batch({close, high, low, volume}, columns);
+    assert(bar_report.events == len && bar_report.bars == len && delivered == len);
+    assert(bar_report.signals == expected);
+    std::size_t buys = 0, sells = 0;
+    for (const signal &s : expected)
+    {
+        buys += s == signal::BUY;
+        sells += s == signal::SELL;
+    }
+    assert(bar_report.buys == buys && bar_report.sells == sells && buys > 0 && sells > 0);
+
+    // ticks aggregated into 7-tick bars by the engine give the signals of the batch bars
+    live::options tick_opts;
+    tick_opts.ticks = true;
+    tick_opts.by = bars::rule::TICK;
+    tick_opts.threshold = 7;
+    tick_opts.capacity = 64;
+    live::engine tick_engine(b.g, b.indicators, tick_opts);
+    store::columns ticks;
+    ticks.date = dates;
+    ticks.fields[(std::size_t)store::field::CLOSE] = close;
+    ticks.fields[(std::size_t)store::field::VOLUME] = volume;
+    const live::report tick_report = live::run(tick_engine, live::replay(ticks, 1));
+    const bars::table t = bars::aggregate(dates, close, volume, bars::rule::TICK, 7);
+    assert(tick_report.events == len && tick_report.bars == t.size());
+    assert(tick_report.signals == b.batch({t.close, t.high, t.low, t.volume}, columns));
+
+    // a graph with a cycle never starts
+    strategy::dag cyclic = b.g;
+    cyclic.nodes[b.g.nodes.size() - 1].children = {0};
+    live::engine stuck(cyclic, b.indicators);
+    assert(!stuck.ok() && live::run(stuck, live::replay(data, live::DAY_NS)).signals.empty());
+    printf("live replay signals match the batch signals\n");
+
+    return 0;
+}
@@ -0,0 +1,193 @@
+/**
+ * @file optimizer.cc
+ * @license This file is licensed under the GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007. You may obtain a copy of this license at https://www.gnu.org/licenses/gpl-3.0.en.html.
+ * @author Tushar Chaurasia (Dark-CodeX)
+ */
+
+#include "./optimizer.hh"
+
+namespace core::optimizer
+{
+    namespace
+    {
+        std::size_t as_count(const double &v)
+        {
+            return v > 0 ? (std::size_t)v : 0;
+        }
+
+        double score(const backtest::metrics &m, const rank_by &rank)
+        {
+            switch (rank)
+            {
+            case rank_by::TOTAL_RETURN:
+                return m.total_return;
+            case rank_by::MAX_DRAWDOWN:
+                return m.max_drawdown;
+            case rank_by::WIN_RATE:
+                return m.win_rate;
+            default:
+                return m.sharpe;
+            }
+        }
+    }
+
+    std::size_t grid_size(std::span<const parameter> parameters)
+    {
+        std::size_t total = 1;
+        for (const parameter &p : parameters)
+        {
+            if (p.values.empty())
+                return 0;
+            if (total > std::numeric_limits<std::size_t>::max() / p.values.size())
+                return 0;
+            total *= p.values.size();
+        }
+        return total;
+    }
+
+    std::vector<candidate> optimize(const problem &prob, const options &opts, thread_pool::pool &workers)
+    {
+        const std::size_t P = prob.parameters.size(), I = prob.indicators.size();
+        if (!strategy::is_acyclic(prob.graph) || opts.top_k == 0)
+            return {};
+        const std::size_t grid = grid_size(prob.parameters);
+        if (grid == 0)
+            return {};
+        for (const indicator_node &in : prob.indicators)
+        {
+            if (in.node >= prob.graph.nodes.size())
+                return {};
+        }
+        for (const parameter &param : prob.parameters)
+        {
+            if (param.what != target::ALLOCATION && param.node >= prob.graph.nodes.size())
+                return {};
+        }
+
+        // value index of every parameter for every candidate, the last parameter varies fastest on a grid
+        const std::size_t C = opts.method == search::GRID ? grid : opts.samples;
+        if (C > MAX_CANDIDATES)
+            return {};
+        std::vector<std::uint32_t> picks(C * P);
+        if (opts.method == search::GRID)
+        {
+            for (std::size_t c = 0; c < C; c++)
+            {
+                std::size_t rest = c;
+                for (std::size_t p = P; p-- > 0;)
+                {
+                    picks[c * P + p] = rest % prob.parameters[p].values.size();
+                    rest /= prob.parameters[p].values.size();
+                }
+            }
+        }
+        else
+        {
+            std::mt19937_64 rng(opts.seed);
+            for (std::size_t c = 0; c < C; c++)
+            {
+                for (std::size_t p = 0; p < P; p++)
+                    picks[c * P + p] = std::uniform_int_distribution<std::size_t>(0, prob.parameters[p].values.size() - 1)(rng);
+            }
+        }
+
+        // parameters of every indicator node for every candidate, deduplicated into shared columns
+        std::vector<std::size_t> owner(prob.graph.nodes.size(), I);
+        for (std::size_t i = 0; i < I; i++)
+            owner[prob.indicators[i].node] = i;
+
+        std::map<std::tuple<std::size_t, std::size_t, std::size_t, std::uint64_t>, std::size_t> unique;
+        std::vector<std::pair<std::size_t, indicators::universe::spec>> jobs;
+        std::vector<std::size_t> column_of(C * I);
+        for (std::size_t c = 0; c < C; c++)
+        {
+            for (std::size_t i = 0; i < I; i++)
+            {
+                indicators::universe::spec sp = prob.indicators[i].spec;
+                for (std::size_t p = 0; p < P; p++)
+                {
+                    const parameter &param = prob.parameters[p];
+                    if (param.node != prob.indicators[i].node)
+                        continue;
+                    const double v = param.values[picks[c * P + p]];
+                    if (param.what == target::PERIOD)
+                        sp.n = as_count(v);
+                    else if (param.what == target::SLOW)
+                        sp.slow = as_count(v);
+                    else if (param.what == target::MULTIPLIER)
+                        sp.k = v;
+                }
+                auto [it, inserted] = unique.try_emplace({i, sp.n, sp.slow, std::bit_cast<std::uint64_t>(sp.k)}, jobs.size());
+                if (inserted)
+                    jobs.emplace_back(i, sp);
+                column_of[c * I + i] = it->second;
+            }
+        }
+
+        std::vector<std::vector<double>> columns(jobs.size());
+        workers.parallel_for(jobs.size(), [&](std::size_t j)
+                             {
+                                 const indicator_node &in = prob.indicators[jobs[j].first];
+                                 std::vector<double> &col = columns[j];
+                                 col = indicators::universe::compute(in.input, jobs[j].second);
+                                 // a multi-row node's value is its row (the middle band, %K, Aroon up unless chosen)
+                                 const std::size_t len = col.size() / indicators::universe::rows(jobs[j].second.indicator);
+                                 if (in.row != 0 && (in.row + 1) * len <= col.size())
+                                     std::copy(col.begin() + in.row * len, col.begin() + (in.row + 1) * len, col.begin());
+                                 col.resize(len); });
+
+        std::vector<candidate> results(C);
+        workers.parallel_for(C, [&](std::size_t c)
+                             {
+                                 strategy::dag graph = prob.graph;
+                                 double allocation = prob.allocation_fraction;
+                                 for (std::size_t p = 0; p < P; p++)
+                                 {
+                                     const parameter &param = prob.parameters[p];
+                                     const double v = param.values[picks[c * P + p]];
+                                     results[c].values.emplace_back(v);
+                                     if (param.what == target::ALLOCATION)
+                                         allocation = v;
+                                     else if (param.what == target::THRESHOLD)
+                                     {
+                                         graph.nodes[param.node].threshold = v;
+                                         graph.nodes[param.node].has_threshold = true;
+                                     }
+                                 }
+
+                                 std::vector<std::span<const double>> cols;
+                                 for (std::size_t n = 0; n < graph.nodes.size(); n++)
+                                 {
+                                     if (graph.nodes[n].kind != strategy::node_kind::INDICATOR)
+                                         continue;
+                                     graph.nodes[n].column = -1;
+                                     // columns the batch functions rejected stay None, like a node without a column
+                                     if (owner[n] < I && !columns[column_of[c * I + owner[n]]].empty())
+                                     {
+                                         graph.nodes[n].column = cols.size();
+                                         cols.emplace_back(columns[column_of[c * I + owner[n]]]);
+                                     }
+                                 }
+
+                                 std::vector<strategy::signal> sig = strategy::signals(graph, cols, prob.closes.size());
+                                 if (sig.size() < prob.closes.size())
+                                     return;
+                                 results[c].metrics = backtest::summarize(backtest::run(prob.closes, sig, prob.initial_capital, allocation, prob.commission)); });
+
+        // best first, NaN last, ties in search order
+        std::vector<std::size_t> order(C);
+        std::iota(order.begin(), order.end(), 0);
+        const std::size_t k = std::min(opts.top_k, C);
+        std::partial_sort(order.begin(), order.begin() + k, order.end(), [&](const std::size_t &a, const std::size_t &b)
+                          {
+                              double sa = score(results[a].metrics, opts.rank), sb = score(results[b].metrics, opts.rank);
+                              if (std::isnan(sa) || std::isnan(sb))
+                                  return !std::isnan(sa) || (std::isnan(sb) && a < b);
+                              return sa > sb || (sa == sb && a < b); });
+
+        std::vector<candidate> top;
+        for (std::size_t i = 0; i < k; i++)
+            top.emplace_back(std::move(results[order[i]]));
+        return top;
+    }
+}
@@ -0,0 +1,139 @@
+/**
+ * @file optimizer.hh
+ * @license This file is licensed under the GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007. You may obtain a copy of this license at https://www.gnu.org/licenses/gpl-3.0.en.html.
+ * @author Tushar Chaurasia (Dark-CodeX)
+ */
+
+#ifndef QUANTZ_OPTIMIZER_HH
+#define QUANTZ_OPTIMIZER_HH
+
+#include <vector>
+#include <span>
+#include <map>
+#include <tuple>
+#include <random>
+#include <cmath>
+#include <limits>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <numeric>
+
+#include "../strategy/strategy.hh"
+#include "../backtest/backtest.hh"
+#include "../indicators/universe.hh"
+#include "../thread_pool/thread_pool.hh"
+
+/**
+ * Parameter search over one strategy graph. Every candidate is a full backtest (signals, state machine
+ * and metrics); candidates run in parallel, and an indicator column is computed once for every distinct
+ * (node, parameters) pair no matter how many candidates use it.
+ */
+namespace core::optimizer
+{
+    /**
+     * @brief Indicator node of the graph, with its input columns and default parameters
+     */
+    struct indicator_node
+    {
+        // index into `dag::nodes`
+        std::size_t node = 0;
+        indicators::universe::series input;
+        indicators::universe::spec spec;
+        // row of a multi-row indicator the node reads (see `universe::resolve_line`), the first by default
+        std::size_t row = 0;
+    };
+
+    enum class target : std::uint8_t
+    {
+        // period (fast period of MACD) of an indicator node
+        PERIOD,
+        // slow period of a MACD node
+        SLOW,
+        // band width of a BollingerBands node
+        MULTIPLIER,
+        // threshold of an operator node
+        THRESHOLD,
+        // allocation fraction of the backtest, `node` is ignored
+        ALLOCATION
+    };
+
+    struct parameter
+    {
+        target what = target::PERIOD;
+        // index into `dag::nodes`
+        std::size_t node = 0;
+        // values tried, in order
+        std::vector<double> values;
+    };
+
+    struct problem
+    {
+        // `column` of the indicator nodes is ignored, each node of `indicators` gets its computed column
+        strategy::dag graph;
+        std::vector<indicator_node> indicators;
+        std::vector<parameter> parameters;
+        std::span<const double> closes;
+        double initial_capital = 0.0;
+        double allocation_fraction = 0.0;
+        double commission = 0.0;
+    };
+
+    enum class rank_by : std::uint8_t
+    {
+        TOTAL_RETURN,
+        SHARPE,
+        // the shallowest drawdown first
+        MAX_DRAWDOWN,
+        WIN_RATE
+    };
+
+    enum class search : std::uint8_t
+    {
+        // every combination of the parameter values
+        GRID,
+        // `samples` combinations drawn uniformly (with replacement) from the parameter values
+        RANDOM
+    };
+
+    // most candidates one search runs; each is a full backtest, and their picks and results are held at once
+    constexpr std::size_t MAX_CANDIDATES = std::size_t(1) << 20;
+
+    struct options
+    {
+        search method = search::GRID;
+        std::size_t samples = 1000;
+        std::uint64_t seed = 0;
+        std::size_t top_k = 10;
+        rank_by rank = rank_by::SHARPE;
+    };
+
+    struct candidate
+    {
+        // one value per `problem::parameters` entry
+        std::vector<double> values;
+        backtest::metrics metrics;
+    };
+
+    /**
+     * @brief Number of combinations a grid search runs
+     *
+     * @param parameters Parameters of the problem
+     * @return Product of the value counts, 0 if it overflows
+     */
+    std::size_t grid_size(std::span<const parameter> parameters);
+
+    /**
+     * @brief Runs the search and ranks the candidates
+     *
+     * @param prob Graph, data and parameter ranges
+     * @param opts Search method, ranking metric and number of results
+     * @param workers Pool running the indicator columns and the backtests
+     * @return The best `opts.top_k` candidates, best first (NaN metrics rank last, ties keep search order);
+     * empty if the graph has a cycle, a parameter has no values, an indicator or parameter node is not in the
+     * graph, or the search has more than `MAX_CANDIDATES` candidates
+     */
+    std::vector<candidate> optimize(const problem &prob, const options &opts, thread_pool::pool &workers = thread_pool::shared());
+}
+
+#endif
\ No newline at end of file
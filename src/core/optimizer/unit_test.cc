@@ -0,0 +1,177 @@
+/**
+ * @file unit_test.cc
+ * @license This file is licensed under the GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007. You may obtain a copy of this license at https://www.gnu.org/licenses/gpl-3.0.en.html.
+ * @author Tushar Chaurasia (Dark-CodeX)
+ */
+
+#include <cassert>
+#include <cstdio>
+#include "./optimizer.hh"
+
+namespace
+{
+    using namespace core;
+
+    /**
+     * Runs `optimize` over the whole grid and checks it against every candidate backtested serially, stably
+     * sorted best first with NaN last. The grid reads an SMA node (`indicators[0]`), the threshold of an
+     * operator node (`parameters[1]`) and the allocation; returns how many candidates scored NaN.
+     */
+    std::size_t against_brute_force(const optimizer::problem &prob, const optimizer::rank_by &rank)
+    {
+        const std::size_t s = prob.indicators[0].node, a = prob.parameters[1].node;
+        const std::span<const double> closes = prob.closes;
+
+        // brute force: every grid candidate backtested in order, the last parameter varying fastest
+        std::vector<optimizer::candidate> all;
+        for (const double &period : prob.parameters[0].values)
+        {
+            for (const double &threshold : prob.parameters[1].values)
+            {
+                for (const double &allocation : prob.parameters[2].values)
+                {
+                    indicators::universe::spec sp = prob.indicators[0].spec;
+                    sp.n = (std::size_t)period;
+                    const std::vector<double> column = indicators::universe::compute(prob.indicators[0].input, sp);
+                    strategy::dag g = prob.graph;
+                    g.nodes[a].threshold = threshold;
+                    std::vector<std::span<const double>> cols;
+                    if (!column.empty())
+                    {
+                        g.nodes[s].column = 0;
+                        cols.emplace_back(column);
+                    }
+                    const std::vector<strategy::signal> sig = strategy::signals(g, cols, closes.size());
+                    all.push_back({{period, threshold, allocation}, backtest::summarize(backtest::run(closes, sig, prob.initial_capital, allocation, prob.commission))});
+                }
+            }
+        }
+        auto score = [&](const backtest::metrics &m)
+        {
+            return rank == optimizer::rank_by::TOTAL_RETURN ? m.total_return : rank == optimizer::rank_by::MAX_DRAWDOWN ? m.max_drawdown
+                                                                           : rank == optimizer::rank_by::WIN_RATE       ? m.win_rate
+                                                                                                                        : m.sharpe;
+        };
+        // best first, NaN last, ties in search order
+        std::stable_sort(all.begin(), all.end(), [&](const optimizer::candidate &x, const optimizer::candidate &y)
+                         {
+                             const double sx = score(x.metrics), sy = score(y.metrics);
+                             if (std::isnan(sx) || std::isnan(sy))
+                                 return !std::isnan(sx) && std::isnan(sy);
+                             return sx > sy; });
+
+        optimizer::options opts;
+        opts.rank = rank;
+        opts.top_k = all.size();
+        const std::vector<optimizer::candidate> top = optimizer::optimize(prob, opts);
+        assert(top.size() == all.size());
+        std::size_t nans = 0, ties = 0;
+        for (std::size_t i = 0; i < top.size(); i++)
+        {
+            for (std::size_t v = 0; v < 3; v++)
+                assert(top[i].values[v] == all[i].values[v] || (std::isnan(top[i].values[v]) && std::isnan(all[i].values[v])));
+            const double x = score(top[i].metrics), y = score(all[i].metrics);
+            assert(x == y || (std::isnan(x) && std::isnan(y)));
+            nans += std::isnan(x);
+            // NaN candidates tie among themselves too
+            ties += i > 0 && (x == score(top[i - 1].metrics) || (std::isnan(x) && std::isnan(score(top[i - 1].metrics))));
+        }
+        assert(ties > 0);
+
+        // a shorter list is the head of the full one
+        opts.top_k = 5;
+        const std::vector<optimizer::candidate> five = optimizer::optimize(prob, opts);
+        assert(five.size() == 5);
+        for (std::size_t i = 0; i < five.size(); i++)
+            assert(five[i].values == top[i].values || std::isnan(five[i].values[2]));
+        return nans;
+    }
+}
+
+int main()
+{
+    using namespace core;
+
+    std::vector<double> closes(2000);
+    double p = 100.0;
+    for (std::size_t i = 0; i < closes.size(); i++)
+    {
+        p *= 1.0 + 0.01 * std::sin(0.37 * (double)i) + 0.002 * std::cos(1.91 * (double)i);
+        closes[i] = p;
+    }
+
+    // Start -> SMA -> (> threshold) -> Buy, SMA -> (< 98) -> Sell
+    strategy::dag graph;
+    auto add = [&](const strategy::node &n)
+    {
+        graph.nodes.emplace_back(n);
+        return graph.nodes.size() - 1;
+    };
+    strategy::node start, ind, above, below, buy, sell;
+    start.kind = strategy::node_kind::CONTROL;
+    ind.kind = strategy::node_kind::INDICATOR;
+    above.kind = below.kind = strategy::node_kind::OPERATOR;
+    above.op = strategy::opcode::GT;
+    below.op = strategy::opcode::LT;
+    above.has_threshold = below.has_threshold = true;
+    above.threshold = 100.0;
+    below.threshold = 98.0;
+    buy.kind = sell.kind = strategy::node_kind::ACTION;
+    buy.action = strategy::signal::BUY;
+    sell.action = strategy::signal::SELL;
+    graph.start = add(start);
+    const std::size_t s = add(ind), a = add(above), b = add(below), by = add(buy), se = add(sell);
+    graph.nodes[graph.start].children = {s};
+    graph.nodes[s].children = {a, b};
+    graph.nodes[a].children = {by};
+    graph.nodes[b].children = {se};
+
+    indicators::universe::spec sma;
+    sma.n = 10;
+    optimizer::problem prob;
+    prob.graph = graph;
+    prob.indicators.push_back({s, {closes, {}, {}, {}}, sma});
+    prob.closes = closes;
+    prob.initial_capital = 10000.0;
+    prob.allocation_fraction = 0.5;
+    prob.commission = 0.001;
+    // a period longer than the data leaves the node without a column, and a NaN allocation never buys: both
+    // give tied metrics
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    prob.parameters.push_back({optimizer::target::PERIOD, s, {5, 20, 5000, 40}});
+    prob.parameters.push_back({optimizer::target::THRESHOLD, a, {95, 100, 1000, 105}});
+    prob.parameters.push_back({optimizer::target::ALLOCATION, 0, {0.5, nan, 1.0}});
+
+    const optimizer::rank_by ranks[] = {optimizer::rank_by::SHARPE, optimizer::rank_by::TOTAL_RETURN, optimizer::rank_by::MAX_DRAWDOWN, optimizer::rank_by::WIN_RATE};
+    for (const optimizer::rank_by &rank : ranks)
+        against_brute_force(prob, rank);
+
+    // a bad last print of +inf: candidates still holding end at +inf equity, flat ones at 0 * inf, so the total
+    // return is NaN next to finite and infinite ones
+    std::vector<double> spiked = closes;
+    spiked.back() = std::numeric_limits<double>::infinity();
+    optimizer::problem bad_print = prob;
+    bad_print.indicators[0].input = {spiked, {}, {}, {}};
+    bad_print.closes = spiked;
+    for (const optimizer::rank_by &rank : ranks)
+    {
+        const std::size_t nans = against_brute_force(bad_print, rank);
+        assert(rank != optimizer::rank_by::TOTAL_RETURN || (nans > 0 && nans < optimizer::grid_size(bad_print.parameters)));
+    }
+
+    // nodes outside the graph and oversized searches are refused before anything runs
+    optimizer::problem bad = prob;
+    bad.indicators[0].node = graph.nodes.size();
+    assert(optimizer::optimize(bad, optimizer::options()).empty());
+    bad = prob;
+    bad.parameters[1].node = graph.nodes.size() + 7;
+    assert(optimizer::optimize(bad, optimizer::options()).empty());
+    bad = prob;
+    bad.parameters[0].values.assign(2048, 10.0);
+    bad.parameters[1].values.assign(1024, 100.0);
+    assert(optimizer::grid_size(bad.parameters) > optimizer::MAX_CANDIDATES);
+    assert(optimizer::optimize(bad, optimizer::options()).empty());
+    printf("optimizer top-k matches a serial brute force\n");
+
+    return 0;
+}
@@ -0,0 +1,149 @@
+/**
+ * @file parallel.cc
+ * @license This file is licensed under the GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007. You may obtain a copy of this license at https://www.gnu.org/licenses/gpl-3.0.en.html.
+ * @author Tushar Chaurasia (Dark-CodeX)
+ */
+
+#include "./parallel.hh"
+
+namespace core::simd_math::parallel
+{
+    namespace
+    {
+        double kernel_sum(const double *vec, const std::size_t &len) { return vector_sum(vec, len); }
+        double kernel_sum(const float *vec, const std::size_t &len) { return vector_sumf(vec, len); }
+        double kernel_multiply(const double *vec, const std::size_t &len) { return vector_multiply(vec, len); }
+        double kernel_multiply(const float *vec, const std::size_t &len) { return vector_multiplyf(vec, len); }
+        double kernel_moments(const double *vec, const std::size_t &len, double *mean) { return vector_moments(vec, len, mean); }
+        double kernel_moments(const float *vec, const std::size_t &len, double *mean) { return vector_momentsf(vec, len, mean); }
+        double kernel_dot_product(const double *vec1, const double *vec2, const std::size_t &len) { return vector_dot_product(vec1, vec2, len); }
+        double kernel_dot_product(const float *vec1, const float *vec2, const std::size_t &len) { return vector_dot_productf(vec1, vec2, len); }
+
+        bool single(const std::size_t &len, const std::size_t &threads)
+        {
+            return threads == 1 || len <= SIMD_SLICE || (threads == AUTOMATIC && len < THRESHOLD);
+        }
+
+        // runs fn(slice, first element, length) for every slice, neighbouring slices go to the same task
+        template <typename F>
+        void slices(const std::size_t &len, const std::size_t &threads, thread_pool::pool &workers, F &&fn)
+        {
+            const std::size_t count = (len + SIMD_SLICE - 1) / SIMD_SLICE;
+            // the caller runs tasks as well
+            const std::size_t tasks = std::min(count, threads == AUTOMATIC ? workers.size() + 1 : threads);
+            workers.parallel_for(tasks, [&](std::size_t t)
+                                 {
+                                     for (std::size_t s = t * count / tasks; s < (t + 1) * count / tasks; s++)
+                                         fn(s, s * SIMD_SLICE, std::min(SIMD_SLICE, len - s * SIMD_SLICE)); }, 1);
+        }
+
+        template <typename T>
+        double sum_of(std::span<const T> vec, const std::size_t &threads, thread_pool::pool &workers)
+        {
+            if (single(vec.size(), threads))
+                return kernel_sum(vec.data(), vec.size());
+            std::vector<double> partial((vec.size() + SIMD_SLICE - 1) / SIMD_SLICE);
+            slices(vec.size(), threads, workers, [&](std::size_t s, std::size_t i, std::size_t n)
+                   { partial[s] = kernel_sum(vec.data() + i, n); });
+            return combine_sums(partial.data(), vec.size());
+        }
+
+        template <typename T>
+        double multiply_of(std::span<const T> vec, const std::size_t &threads, thread_pool::pool &workers)
+        {
+            if (single(vec.size(), threads))
+                return kernel_multiply(vec.data(), vec.size());
+            std::vector<double> partial((vec.size() + SIMD_SLICE - 1) / SIMD_SLICE);
+            slices(vec.size(), threads, workers, [&](std::size_t s, std::size_t i, std::size_t n)
+                   { partial[s] = kernel_multiply(vec.data() + i, n); });
+            double product = 1.0;
+            for (const double &p : partial)
+                product *= p;
+            return product;
+        }
+
+        template <typename T>
+        double variance_of(std::span<const T> vec, const std::size_t &threads, thread_pool::pool &workers)
+        {
+            double mean;
+            if (single(vec.size(), threads))
+                return kernel_moments(vec.data(), vec.size(), &mean) / (double)vec.size();
+            std::vector<double> means((vec.size() + SIMD_SLICE - 1) / SIMD_SLICE), m2s(means.size());
+            slices(vec.size(), threads, workers, [&](std::size_t s, std::size_t i, std::size_t n)
+                   { m2s[s] = kernel_moments(vec.data() + i, n, &means[s]); });
+            return combine_moments(means.data(), m2s.data(), vec.size(), &mean) / (double)vec.size();
+        }
+
+        template <typename T>
+        double dot_product_of(std::span<const T> vec1, std::span<const T> vec2, const std::size_t &threads, thread_pool::pool &workers)
+        {
+            const std::size_t len = std::min(vec1.size(), vec2.size());
+            if (single(len, threads))
+                return kernel_dot_product(vec1.data(), vec2.data(), len);
+            std::vector<double> partial((len + SIMD_SLICE - 1) / SIMD_SLICE);
+            slices(len, threads, workers, [&](std::size_t s, std::size_t i, std::size_t n)
+                   { partial[s] = kernel_dot_product(vec1.data() + i, vec2.data() + i, n); });
+            return combine_sums(partial.data(), len);
+        }
+    }
+
+    double sum(std::span<const double> vec, const std::size_t &threads, thread_pool::pool &workers)
+    {
+        return sum_of(vec, threads, workers);
+    }
+
+    double sum(std::span<const float> vec, const std::size_t &threads, thread_pool::pool &workers)
+    {
+        return sum_of(vec, threads, workers);
+    }
+
+    double mean(std::span<const double> vec, const std::size_t &threads, thread_pool::pool &workers)
+    {
+        return sum_of(vec, threads, workers) / (double)vec.size();
+    }
+
+    double mean(std::span<const float> vec, const std::size_t &threads, thread_pool::pool &workers)
+    {
+        return sum_of(vec, threads, workers) / (double)vec.size();
+    }
+
+    double multiply(std::span<const double> vec, const std::size_t &threads, thread_pool::pool &workers)
+    {
+        return multiply_of(vec, threads, workers);
+    }
+
+    double multiply(std::span<const float> vec, const std::size_t &threads, thread_pool::pool &workers)
+    {
+        return multiply_of(vec, threads, workers);
+    }
+
+    double variance(std::span<const double> vec, const std::size_t &threads, thread_pool::pool &workers)
+    {
+        return variance_of(vec, threads, workers);
+    }
+
+    double variance(std::span<const float> vec, const std::size_t &threads, thread_pool::pool &workers)
+    {
+        return variance_of(vec, threads, workers);
+    }
+
+    double std_deviation(std::span<const double> vec, const std::size_t &threads, thread_pool::pool &workers)
+    {
+        return std::sqrt(variance_of(vec, threads, workers));
+    }
+
+    double std_deviation(std::span<const float> vec, const std::size_t &threads, thread_pool::pool &workers)
+    {
+        return std::sqrt(variance_of(vec, threads, workers));
+    }
+
+    double dot_product(std::span<const double> vec1, std::span<const double> vec2, const std::size_t &threads, thread_pool::pool &workers)
+    {
+        return dot_product_of(vec1, vec2, threads, workers);
+    }
+
+    double dot_product(std::span<const float> vec1, std::span<const float> vec2, const std::size_t &threads, thread_pool::pool &workers)
+    {
+        return dot_product_of(vec1, vec2, threads, workers);
+    }
+}
@@ -0,0 +1,67 @@
+/**
+ * @file parallel.hh
+ * @license This file is licensed under the GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007. You may obtain a copy of this license at https://www.gnu.org/licenses/gpl-3.0.en.html.
+ * @author Tushar Chaurasia (Dark-CodeX)
+ */
+
+#ifndef QUANTZ_SIMD_MATH_PARALLEL_HH
+#define QUANTZ_SIMD_MATH_PARALLEL_HH
+
+#include <vector>
+#include <span>
+#include <cmath>
+#include <algorithm>
+#include <cstddef>
+
+extern "C"
+{
+#include "./simd_math.h"
+}
+#include "../thread_pool/thread_pool.hh"
+
+/**
+ * The reductions of simd_math spread over a thread pool, for arrays far larger than the caches where one core
+ * cannot saturate the memory bandwidth. The array is cut into fixed `SIMD_SLICE` slices, whatever the number of
+ * threads, each slice runs the SIMD kernel and the partial results are combined in slice order. Sum, mean,
+ * variance, standard deviation and dot product are bit for bit the single-threaded results; the product is
+ * reproducible for a given input but may differ from `vector_multiply` in the last bits.
+ */
+namespace core::simd_math::parallel
+{
+    // with `threads` = AUTOMATIC, arrays of at least this many elements (32 MiB of doubles) use the whole pool
+    constexpr std::size_t THRESHOLD = std::size_t(1) << 22;
+    constexpr std::size_t AUTOMATIC = 0;
+
+    /**
+     * @brief Sum of the elements
+     *
+     * @param vec Input
+     * @param threads AUTOMATIC, 1 to stay on the calling thread, or the number of tasks the slices are split into
+     * @param workers Pool running the tasks
+     */
+    double sum(std::span<const double> vec, const std::size_t &threads = AUTOMATIC, thread_pool::pool &workers = thread_pool::shared());
+    double sum(std::span<const float> vec, const std::size_t &threads = AUTOMATIC, thread_pool::pool &workers = thread_pool::shared());
+
+    double mean(std::span<const double> vec, const std::size_t &threads = AUTOMATIC, thread_pool::pool &workers = thread_pool::shared());
+    double mean(std::span<const float> vec, const std::size_t &threads = AUTOMATIC, thread_pool::pool &workers = thread_pool::shared());
+
+    double multiply(std::span<const double> vec, const std::size_t &threads = AUTOMATIC, thread_pool::pool &workers = thread_pool::shared());
+    double multiply(std::span<const float> vec, const std::size_t &threads = AUTOMATIC, thread_pool::pool &workers = thread_pool::shared());
+
+    /**
+     * @brief Population variance, NaN for an empty input
+     */
+    double variance(std::span<const double> vec, const std::size_t &threads = AUTOMATIC, thread_pool::pool &workers = thread_pool::shared());
+    double variance(std::span<const float> vec, const std::size_t &threads = AUTOMATIC, thread_pool::pool &workers = thread_pool::shared());
+
+    double std_deviation(std::span<const double> vec, const std::size_t &threads = AUTOMATIC, thread_pool::pool &workers = thread_pool::shared());
+    double std_deviation(std::span<const float> vec, const std::size_t &threads = AUTOMATIC, thread_pool::pool &workers = thread_pool::shared());
+
+    /**
+     * @brief Dot product of two arrays of the same length
+     */
+    double dot_product(std::span<const double> vec1, std::span<const double> vec2, const std::size_t &threads = AUTOMATIC, thread_pool::pool &workers = thread_pool::shared());
+    double dot_product(std::span<const float> vec1, std::span<const float> vec2, const std::size_t &threads = AUTOMATIC, thread_pool::pool &workers = thread_pool::shared());
+}
+
+#endif
\ No newline at end of file
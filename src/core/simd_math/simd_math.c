@@ -6,93 +6,314 @@
 
 #include "./simd_math.h"
 
-double vector_sum(const double *__restrict vec, size_t len)
+/* elements per block of the reductions, 8 KiB of doubles: a block is re-read from L1 by the variance */
+#define SIMD_BLOCK 1024
+
+_Static_assert(SIMD_SLICE % SIMD_BLOCK == 0 && ((SIMD_SLICE / SIMD_BLOCK) & (SIMD_SLICE / SIMD_BLOCK - 1)) == 0,
+               "a slice must be a power-of-two number of blocks");
+
+/* block results combined pairwise: block k is merged with its left sibling as soon as both exist (a binary counter) */
+typedef struct
 {
-    DOUBLE vsum = SET_ZERO;
+    double sums[64];
+    size_t count, blocks;
+} pairwise_sum;
 
-    size_t i = 0;
-    for (; i + SIMD_VEC_LEN - 1 < len; i += SIMD_VEC_LEN)
-    {
-        DOUBLE v = LOAD(&vec[i]);
-        vsum = ADD(vsum, v);
-    }
+static inline void pairwise_push(pairwise_sum *p, double x)
+{
+    for (size_t b = p->blocks++; b & 1; b >>= 1)
+        x = p->sums[--p->count] + x;
+    p->sums[p->count++] = x;
+}
+
+static inline double pairwise_total(const pairwise_sum *p)
+{
+    double total = 0.0;
+    for (size_t i = p->count; i-- > 0;)
+        total = p->sums[i] + total;
+    return total;
+}
 
-    double temp[SIMD_VEC_LEN];
-    STORE(temp, vsum);
+/* count, mean and sum of squared deviations from the mean */
+typedef struct
+{
+    double n, mean, m2;
+} moments;
 
-    double result = 0;
-    for (int j = 0; j < SIMD_VEC_LEN; j++)
-        result += temp[j];
+/* Chan et al. combination of two disjoint parts */
+static inline moments moments_merge(moments a, moments b)
+{
+    if (a.n == 0)
+        return b;
+    if (b.n == 0)
+        return a;
+    double n = a.n + b.n, delta = b.mean - a.mean;
+    moments m = {n, a.mean + delta * (b.n / n), a.m2 + b.m2 + delta * delta * (a.n * b.n / n)};
+    return m;
+}
 
-    for (; i < len; i++)
-        result += vec[i];
+typedef struct
+{
+    moments parts[64];
+    size_t count, blocks;
+} pairwise_moments;
 
-    return result;
+static inline void pairwise_merge(pairwise_moments *p, moments m)
+{
+    for (size_t b = p->blocks++; b & 1; b >>= 1)
+        m = moments_merge(p->parts[--p->count], m);
+    p->parts[p->count++] = m;
 }
 
-double vector_mean(const double *__restrict vec, size_t len)
+static inline moments moments_total(const pairwise_moments *p)
 {
-    return vector_sum(vec, len) / (double)len;
+    moments total = {0.0, 0.0, 0.0};
+    for (size_t i = p->count; i-- > 0;)
+        total = moments_merge(p->parts[i], total);
+    return total;
 }
 
-double vector_multiply(const double *__restrict vec, size_t len)
+/* AVX-512 */
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+#define DOUBLE __m512d
+#define SET_ZERO _mm512_setzero_pd()
+#define SET_X(__x) _mm512_set1_pd(__x)
+#define LOAD(p) _mm512_loadu_pd(p)
+#define STORE(p, v) _mm512_storeu_pd(p, v)
+#define ADD(a, b) _mm512_add_pd(a, b)
+#define SUBTRACT(a, b) _mm512_sub_pd(a, b)
+#define MULTIPLY(a, b) _mm512_mul_pd(a, b)
+#define DIVIDE(a, b) _mm512_div_pd(a, b)
+#define FMA(a, b, c) _mm512_fmadd_pd(a, b, c)
+#define SIMD_VEC_LEN 8
+#define SIMD_FN(name) name##_512
+#define SCALAR double
+#define LOAD_SCALAR(p) LOAD(p)
+#include "./simd_math_kernels.h"
+#undef SIMD_FN
+#undef SCALAR
+#undef LOAD_SCALAR
+#define SIMD_FN(name) name##f_512
+#define SCALAR float
+#define LOAD_SCALAR(p) _mm512_cvtps_pd(_mm256_loadu_ps(p))
+#include "./simd_math_kernels.h"
+#undef SCALAR
+#undef LOAD_SCALAR
+#undef DOUBLE
+#undef SET_ZERO
+#undef SET_X
+#undef LOAD
+#undef STORE
+#undef ADD
+#undef SUBTRACT
+#undef MULTIPLY
+#undef DIVIDE
+#undef FMA
+#undef SIMD_VEC_LEN
+#undef SIMD_FN
+#pragma GCC pop_options
+
+/* AVX2 + FMA */
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+#define DOUBLE __m256d
+#define SET_ZERO _mm256_setzero_pd()
+#define SET_X(__x) _mm256_set1_pd(__x)
+#define LOAD(p) _mm256_loadu_pd(p)
+#define STORE(p, v) _mm256_storeu_pd(p, v)
+#define ADD(a, b) _mm256_add_pd(a, b)
+#define SUBTRACT(a, b) _mm256_sub_pd(a, b)
+#define MULTIPLY(a, b) _mm256_mul_pd(a, b)
+#define DIVIDE(a, b) _mm256_div_pd(a, b)
+#define FMA(a, b, c) _mm256_fmadd_pd(a, b, c)
+#define SIMD_VEC_LEN 4
+#define SIMD_FN(name) name##_256
+#define SCALAR double
+#define LOAD_SCALAR(p) LOAD(p)
+#include "./simd_math_kernels.h"
+#undef SIMD_FN
+#undef SCALAR
+#undef LOAD_SCALAR
+#define SIMD_FN(name) name##f_256
+#define SCALAR float
+#define LOAD_SCALAR(p) _mm256_cvtps_pd(_mm_loadu_ps(p))
+#include "./simd_math_kernels.h"
+#undef SCALAR
+#undef LOAD_SCALAR
+#undef DOUBLE
+#undef SET_ZERO
+#undef SET_X
+#undef LOAD
+#undef STORE
+#undef ADD
+#undef SUBTRACT
+#undef MULTIPLY
+#undef DIVIDE
+#undef FMA
+#undef SIMD_VEC_LEN
+#undef SIMD_FN
+#pragma GCC pop_options
+
+/* SSE2, baseline of every x86-64 CPU: no FMA, so it is a multiply then an add */
+#define DOUBLE __m128d
+#define SET_ZERO _mm_setzero_pd()
+#define SET_X(__x) _mm_set1_pd(__x)
+#define LOAD(p) _mm_loadu_pd(p)
+#define STORE(p, v) _mm_storeu_pd(p, v)
+#define ADD(a, b) _mm_add_pd(a, b)
+#define SUBTRACT(a, b) _mm_sub_pd(a, b)
+#define MULTIPLY(a, b) _mm_mul_pd(a, b)
+#define DIVIDE(a, b) _mm_div_pd(a, b)
+#define FMA(a, b, c) _mm_add_pd(_mm_mul_pd(a, b), c)
+#define SIMD_VEC_LEN 2
+#define SIMD_FN(name) name##_128
+#define SCALAR double
+#define LOAD_SCALAR(p) LOAD(p)
+#include "./simd_math_kernels.h"
+#undef SIMD_FN
+#undef SCALAR
+#undef LOAD_SCALAR
+#define SIMD_FN(name) name##f_128
+#define SCALAR float
+#define LOAD_SCALAR(p) _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64((const __m128i *)(p))))
+#include "./simd_math_kernels.h"
+#undef SCALAR
+#undef LOAD_SCALAR
+#undef DOUBLE
+#undef SET_ZERO
+#undef SET_X
+#undef LOAD
+#undef STORE
+#undef ADD
+#undef SUBTRACT
+#undef MULTIPLY
+#undef DIVIDE
+#undef FMA
+#undef SIMD_VEC_LEN
+#undef SIMD_FN
+
+typedef struct
 {
-    DOUBLE vprod = SET_X(1.0);
+    double (*sum)(const double *__restrict, size_t);
+    double (*multiply)(const double *__restrict, size_t);
+    double (*moments)(const double *__restrict, size_t, double *);
+    double (*dot_product)(const double *__restrict, const double *__restrict, size_t);
+    double (*sumf)(const float *__restrict, size_t);
+    double (*multiplyf)(const float *__restrict, size_t);
+    double (*momentsf)(const float *__restrict, size_t, double *);
+    double (*dot_productf)(const float *__restrict, const float *__restrict, size_t);
+    const char *mode;
+} simd_dispatch;
 
-    size_t i = 0;
-    for (; i + SIMD_VEC_LEN - 1 < len; i += SIMD_VEC_LEN)
-    {
-        DOUBLE v = LOAD(&vec[i]);
-        vprod = MULTIPLY(vprod, v);
-    }
+static const simd_dispatch dispatch_512 = {vector_sum_512, vector_multiply_512, vector_moments_512, vector_dot_product_512,
+                                           vector_sumf_512, vector_multiplyf_512, vector_momentsf_512, vector_dot_productf_512, "512"};
+static const simd_dispatch dispatch_256 = {vector_sum_256, vector_multiply_256, vector_moments_256, vector_dot_product_256,
+                                           vector_sumf_256, vector_multiplyf_256, vector_momentsf_256, vector_dot_productf_256, "256"};
+static const simd_dispatch dispatch_128 = {vector_sum_128, vector_multiply_128, vector_moments_128, vector_dot_product_128,
+                                           vector_sumf_128, vector_multiplyf_128, vector_momentsf_128, vector_dot_productf_128, "128"};
 
-    double temp[SIMD_VEC_LEN];
-    STORE(temp, vprod);
+// SSE2 until the constructor has run, so callers from other static initializers are still safe
+static const simd_dispatch *dispatch = &dispatch_128;
 
-    double result = 1;
-    for (int j = 0; j < SIMD_VEC_LEN; j++)
-        result *= temp[j];
+static int simd_supports(int bits)
+{
+    __builtin_cpu_init();
+    if (bits == 512)
+        return __builtin_cpu_supports("avx512f");
+    if (bits == 256)
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    return bits == 128;
+}
 
-    for (; i < len; i++)
-        result *= vec[i];
+int simd_select(int bits)
+{
+    if (!simd_supports(bits))
+        return -1;
+    dispatch = bits == 512 ? &dispatch_512 : bits == 256 ? &dispatch_256 : &dispatch_128;
+    return 0;
+}
 
-    return result;
+__attribute__((constructor)) static void simd_init(void)
+{
+    if (simd_select(512) != 0 && simd_select(256) != 0)
+        simd_select(128);
 }
 
-double vector_variance(const double *__restrict vec, size_t len)
+const char *simd_mode(void)
 {
-    DOUBLE vsum = SET_ZERO, vsqsum = SET_ZERO;
+    return dispatch->mode;
+}
 
-    size_t i = 0;
-    for (; i + SIMD_VEC_LEN - 1 < len; i += SIMD_VEC_LEN)
-    {
-        // fma(a,b,c) = a * b + c
-        DOUBLE v = LOAD(&vec[i]);
-        vsum = ADD(vsum, v);
-        vsqsum = FMA(v, v, vsqsum);
-    }
+double vector_moments(const double *__restrict vec, size_t len, double *mean)
+{
+    return dispatch->moments(vec, len, mean);
+}
 
-    double temp_vsum[SIMD_VEC_LEN], temp_vsqsum[SIMD_VEC_LEN];
-    STORE(temp_vsum, vsum);
-    STORE(temp_vsqsum, vsqsum);
+double vector_momentsf(const float *__restrict vec, size_t len, double *mean)
+{
+    return dispatch->momentsf(vec, len, mean);
+}
 
-    double sum = 0, sqsum = 0;
-    for (int j = 0; j < SIMD_VEC_LEN; j++)
+/*
+ * A full slice is a whole subtree of the block counter, so pushing the slices one level up builds the same tree as
+ * the single-threaded kernel; a partial last slice is the top of its stack and the rest is folded onto its total.
+ */
+double combine_sums(const double *slices, size_t len)
+{
+    size_t count = (len + SIMD_SLICE - 1) / SIMD_SLICE, full = len / SIMD_SLICE;
+    pairwise_sum p = {0};
+    for (size_t i = 0; i < full; i++)
+        pairwise_push(&p, slices[i]);
+
+    double total = full < count ? slices[full] : 0.0;
+    for (size_t i = p.count; i-- > 0;)
+        total = p.sums[i] + total;
+    return total;
+}
+
+double combine_moments(const double *means, const double *m2s, size_t len, double *mean)
+{
+    size_t count = (len + SIMD_SLICE - 1) / SIMD_SLICE, full = len / SIMD_SLICE;
+    pairwise_moments p = {0};
+    for (size_t i = 0; i < full; i++)
     {
-        sum += temp_vsum[j];
-        sqsum += temp_vsqsum[j];
+        moments m = {(double)SIMD_SLICE, means[i], m2s[i]};
+        pairwise_merge(&p, m);
     }
 
-    for (; i < len; ++i)
+    moments total = {0.0, 0.0, 0.0};
+    if (full < count)
     {
-        sum += vec[i];
-        sqsum += vec[i] * vec[i];
+        moments last = {(double)(len - full * SIMD_SLICE), means[full], m2s[full]};
+        total = last;
     }
+    for (size_t i = p.count; i-- > 0;)
+        total = moments_merge(p.parts[i], total);
+    *mean = total.mean;
+    return total.m2;
+}
+
+double vector_sum(const double *__restrict vec, size_t len)
+{
+    return dispatch->sum(vec, len);
+}
 
-    double mean = sum / len;
-    double variance = (sqsum / len) - (mean * mean);
+double vector_mean(const double *__restrict vec, size_t len)
+{
+    return vector_sum(vec, len) / (double)len;
+}
 
-    return variance;
+double vector_multiply(const double *__restrict vec, size_t len)
+{
+    return dispatch->multiply(vec, len);
+}
+
+double vector_variance(const double *__restrict vec, size_t len)
+{
+    // population variance, NaN for an empty array
+    double mean;
+    return vector_moments(vec, len, &mean) / (double)len;
 }
 
 double vector_std_deviation(const double *__restrict vec, size_t len)
@@ -102,26 +323,36 @@ double vector_std_deviation(const double *__restrict vec, size_t len)
 
 double vector_dot_product(const double *__restrict vec1, const double *__restrict vec2, size_t len)
 {
-    DOUBLE vsum = SET_ZERO;
+    return dispatch->dot_product(vec1, vec2, len);
+}
 
-    size_t i = 0;
-    for (; i + SIMD_VEC_LEN - 1 < len; i += SIMD_VEC_LEN)
-    {
-        DOUBLE v1 = LOAD(&vec1[i]);
-        DOUBLE v2 = LOAD(&vec2[i]);
+double vector_sumf(const float *__restrict vec, size_t len)
+{
+    return dispatch->sumf(vec, len);
+}
 
-        vsum = FMA(v1, v2, vsum);
-    }
+double vector_meanf(const float *__restrict vec, size_t len)
+{
+    return vector_sumf(vec, len) / (double)len;
+}
 
-    double temp[SIMD_VEC_LEN];
-    STORE(temp, vsum);
+double vector_multiplyf(const float *__restrict vec, size_t len)
+{
+    return dispatch->multiplyf(vec, len);
+}
 
-    double result = 0;
-    for (size_t j = 0; j < SIMD_VEC_LEN; j++)
-        result += temp[j];
+double vector_variancef(const float *__restrict vec, size_t len)
+{
+    double mean;
+    return vector_momentsf(vec, len, &mean) / (double)len;
+}
 
-    for (; i < len; i++)
-        result += vec1[i] * vec2[i];
+double vector_std_deviationf(const float *__restrict vec, size_t len)
+{
+    return sqrt(vector_variancef(vec, len));
+}
 
-    return result;
+double vector_dot_productf(const float *__restrict vec1, const float *__restrict vec2, size_t len)
+{
+    return dispatch->dot_productf(vec1, vec2, len);
 }
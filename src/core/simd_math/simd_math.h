@@ -19,51 +19,10 @@ extern "C"
 #define almost_equal(a, b) \
     fabs(a - b) < 1e-7
 
-#ifdef __AVX512F__
-#define DOUBLE __m512d
-#define SET_ZERO _mm512_setzero_pd()
-#define SET_X(__x) _mm512_set1_pd(__x)
-#define LOAD(p) _mm512_loadu_pd(p)
-#define STORE(p, v) _mm512_storeu_pd(p, v)
-#define ADD(a, b) _mm512_add_pd(a, b)
-#define SUBTRACT(a, b) _mm512_sub_pd(a, b)
-#define MULTIPLY(a, b) _mm512_mul_pd(a, b)
-#define DIVIDE(a, b) _mm512_div_pd(a, b)
-#define FMA(a, b, c) _mm512_fmadd_pd(a, b, c)
-#define SIMD_VEC_LEN 8
-#define SIMD_MODE "512"
-
-#elif defined(__AVX2__)
-#define DOUBLE __m256d
-#define SET_ZERO _mm256_setzero_pd()
-#define SET_X(__x) _mm256_set1_pd(__x)
-#define LOAD(p) _mm256_loadu_pd(p)
-#define STORE(p, v) _mm256_storeu_pd(p, v)
-#define ADD(a, b) _mm256_add_pd(a, b)
-#define SUBTRACT(a, b) _mm256_sub_pd(a, b)
-#define MULTIPLY(a, b) _mm256_mul_pd(a, b)
-#define DIVIDE(a, b) _mm256_div_pd(a, b)
-#define FMA(a, b, c) _mm256_fmadd_pd(a, b, c)
-#define SIMD_VEC_LEN 4
-#define SIMD_MODE "256"
-
-#elif defined(__SSE2__)
-#define DOUBLE __m128d
-#define SET_ZERO _mm_setzero_pd()
-#define SET_X(__x) _mm_set1_pd(__x)
-#define LOAD(p) _mm_loadu_pd(p)
-#define STORE(p, v) _mm_storeu_pd(p, v)
-#define ADD(a, b) _mm_add_pd(a, b)
-#define SUBTRACT(a, b) _mm_sub_pd(a, b)
-#define MULTIPLY(a, b) _mm_mul_pd(a, b)
-#define DIVIDE(a, b) _mm_div_pd(a, b)
-#define FMA(a, b, c) _mm_fmadd_pd(a, b, c)
-#define SIMD_VEC_LEN 2
-#define SIMD_MODE "128"
-
-#else
-#error "No supported SIMD instruction set found."
-#endif
+    /*
+     * Every kernel is compiled for AVX-512, AVX2+FMA and SSE2 in the same binary. The widest level the CPU
+     * (and OS) supports is selected once when the library is loaded, using CPUID.
+     */
 
     double vector_sum(const double *__restrict vec, size_t len);
     double vector_mean(const double *__restrict vec, size_t len);
@@ -72,6 +31,70 @@ extern "C"
     double vector_std_deviation(const double *__restrict vec, size_t len);
     double vector_dot_product(const double *__restrict vec1, const double *__restrict vec2, size_t len);
 
+    /*
+     * float32 inputs, half the memory traffic of the double kernels. Every element is widened to double on
+     * load, so the result equals the double kernel run on the same values widened to double.
+     */
+
+    double vector_sumf(const float *__restrict vec, size_t len);
+    double vector_meanf(const float *__restrict vec, size_t len);
+    double vector_multiplyf(const float *__restrict vec, size_t len);
+    double vector_variancef(const float *__restrict vec, size_t len);
+    double vector_std_deviationf(const float *__restrict vec, size_t len);
+    double vector_dot_productf(const float *__restrict vec1, const float *__restrict vec2, size_t len);
+
+    /*
+     * Slices of `SIMD_SLICE` elements (the last one may be shorter) reduced separately, e.g. on several threads,
+     * then combined in order: the result is bit for bit the one of the kernel run over the whole array.
+     */
+
+#define SIMD_SLICE ((size_t)1 << 18)
+
+    /**
+     * @brief Mean and sum of squared deviations from it, the population variance is their ratio to `len`
+     *
+     * @param vec Input
+     * @param len Number of elements
+     * @param mean Receives the mean (0 for an empty input)
+     * @return Sum of squared deviations
+     */
+    double vector_moments(const double *__restrict vec, size_t len, double *mean);
+    double vector_momentsf(const float *__restrict vec, size_t len, double *mean);
+
+    /**
+     * @brief Total of per-slice sums (or dot products), as `vector_sum` would add them
+     *
+     * @param slices One sum per slice
+     * @param len Number of elements of the whole array
+     */
+    double combine_sums(const double *slices, size_t len);
+
+    /**
+     * @brief Moments of the whole array from per-slice moments, as `vector_moments` would merge them
+     *
+     * @param means Mean of every slice
+     * @param m2s Sum of squared deviations of every slice
+     * @param len Number of elements of the whole array
+     * @param mean Receives the mean of the whole array
+     * @return Sum of squared deviations of the whole array
+     */
+    double combine_moments(const double *means, const double *m2s, size_t len, double *mean);
+
+    /**
+     * @brief Vector width of the selected kernels
+     *
+     * @return "512", "256" or "128"
+     */
+    const char *simd_mode(void);
+
+    /**
+     * @brief Forces a narrower (or the widest supported) kernel set, mainly for testing
+     *
+     * @param bits 512, 256 or 128
+     * @return 0 on success, -1 if the CPU does not support `bits`
+     */
+    int simd_select(int bits);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,165 @@
+/**
+ * @file simd_math_kernels.h
+ * @license This file is licensed under the GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007. You may obtain a copy of this license at https://www.gnu.org/licenses/gpl-3.0.en.html.
+ * @author Tushar Chaurasia (Dark-CodeX)
+ */
+
+/*
+ * Kernel bodies shared by every ISA level. This file has no include guard: simd_math.c includes it twice
+ * per level, with DOUBLE/LOAD/... bound to that level's intrinsics and SIMD_FN(name) appending the
+ * level's suffix, inside a `#pragma GCC target` region. SCALAR is the element type (double, or float
+ * widened to double lanes by LOAD_SCALAR), the accumulators are always double.
+ *
+ * The arrays are cut into SIMD_BLOCK-element blocks. Inside a block four independent accumulators hide the
+ * add/FMA latency; the block results are then combined pairwise, so the rounding error grows with the log
+ * of the length instead of the length.
+ */
+
+// sum of the lanes, pairwise
+static double SIMD_FN(horizontal_sum)(DOUBLE v)
+{
+    double temp[SIMD_VEC_LEN];
+    STORE(temp, v);
+    for (int w = SIMD_VEC_LEN / 2; w > 0; w /= 2)
+    {
+        for (int j = 0; j < w; j++)
+            temp[j] += temp[j + w];
+    }
+    return temp[0];
+}
+
+static double SIMD_FN(block_sum)(const SCALAR *__restrict vec, size_t len)
+{
+    DOUBLE a0 = SET_ZERO, a1 = SET_ZERO, a2 = SET_ZERO, a3 = SET_ZERO;
+
+    size_t i = 0;
+    for (; i + 4 * SIMD_VEC_LEN <= len; i += 4 * SIMD_VEC_LEN)
+    {
+        a0 = ADD(a0, LOAD_SCALAR(&vec[i]));
+        a1 = ADD(a1, LOAD_SCALAR(&vec[i + SIMD_VEC_LEN]));
+        a2 = ADD(a2, LOAD_SCALAR(&vec[i + 2 * SIMD_VEC_LEN]));
+        a3 = ADD(a3, LOAD_SCALAR(&vec[i + 3 * SIMD_VEC_LEN]));
+    }
+    for (; i + SIMD_VEC_LEN <= len; i += SIMD_VEC_LEN)
+        a0 = ADD(a0, LOAD_SCALAR(&vec[i]));
+
+    double result = SIMD_FN(horizontal_sum)(ADD(ADD(a0, a1), ADD(a2, a3)));
+    for (; i < len; i++)
+        result += (double)vec[i];
+
+    return result;
+}
+
+static double SIMD_FN(vector_sum)(const SCALAR *__restrict vec, size_t len)
+{
+    pairwise_sum total = {0};
+    for (size_t i = 0; i < len; i += SIMD_BLOCK)
+        pairwise_push(&total, SIMD_FN(block_sum)(&vec[i], len - i < SIMD_BLOCK ? len - i : SIMD_BLOCK));
+    return pairwise_total(&total);
+}
+
+static double SIMD_FN(vector_multiply)(const SCALAR *__restrict vec, size_t len)
+{
+    DOUBLE p0 = SET_X(1.0), p1 = SET_X(1.0), p2 = SET_X(1.0), p3 = SET_X(1.0);
+
+    size_t i = 0;
+    for (; i + 4 * SIMD_VEC_LEN <= len; i += 4 * SIMD_VEC_LEN)
+    {
+        p0 = MULTIPLY(p0, LOAD_SCALAR(&vec[i]));
+        p1 = MULTIPLY(p1, LOAD_SCALAR(&vec[i + SIMD_VEC_LEN]));
+        p2 = MULTIPLY(p2, LOAD_SCALAR(&vec[i + 2 * SIMD_VEC_LEN]));
+        p3 = MULTIPLY(p3, LOAD_SCALAR(&vec[i + 3 * SIMD_VEC_LEN]));
+    }
+    for (; i + SIMD_VEC_LEN <= len; i += SIMD_VEC_LEN)
+        p0 = MULTIPLY(p0, LOAD_SCALAR(&vec[i]));
+
+    double temp[SIMD_VEC_LEN];
+    STORE(temp, MULTIPLY(MULTIPLY(p0, p1), MULTIPLY(p2, p3)));
+
+    double result = 1;
+    for (int j = 0; j < SIMD_VEC_LEN; j++)
+        result *= temp[j];
+
+    for (; i < len; i++)
+        result *= (double)vec[i];
+
+    return result;
+}
+
+// count, mean and sum of squared deviations of one block, two passes over the (L1-resident) block
+static moments SIMD_FN(block_moments)(const SCALAR *__restrict vec, size_t len)
+{
+    moments m = {(double)len, SIMD_FN(block_sum)(vec, len) / (double)len, 0.0};
+
+    DOUBLE mean = SET_X(m.mean);
+    DOUBLE a0 = SET_ZERO, a1 = SET_ZERO, a2 = SET_ZERO, a3 = SET_ZERO;
+
+    size_t i = 0;
+    for (; i + 4 * SIMD_VEC_LEN <= len; i += 4 * SIMD_VEC_LEN)
+    {
+        // fma(a,b,c) = a * b + c
+        DOUBLE d0 = SUBTRACT(LOAD_SCALAR(&vec[i]), mean);
+        DOUBLE d1 = SUBTRACT(LOAD_SCALAR(&vec[i + SIMD_VEC_LEN]), mean);
+        DOUBLE d2 = SUBTRACT(LOAD_SCALAR(&vec[i + 2 * SIMD_VEC_LEN]), mean);
+        DOUBLE d3 = SUBTRACT(LOAD_SCALAR(&vec[i + 3 * SIMD_VEC_LEN]), mean);
+        a0 = FMA(d0, d0, a0);
+        a1 = FMA(d1, d1, a1);
+        a2 = FMA(d2, d2, a2);
+        a3 = FMA(d3, d3, a3);
+    }
+    for (; i + SIMD_VEC_LEN <= len; i += SIMD_VEC_LEN)
+    {
+        DOUBLE d = SUBTRACT(LOAD_SCALAR(&vec[i]), mean);
+        a0 = FMA(d, d, a0);
+    }
+
+    m.m2 = SIMD_FN(horizontal_sum)(ADD(ADD(a0, a1), ADD(a2, a3)));
+    for (; i < len; i++)
+    {
+        double d = (double)vec[i] - m.mean;
+        m.m2 += d * d;
+    }
+
+    return m;
+}
+
+static double SIMD_FN(vector_moments)(const SCALAR *__restrict vec, size_t len, double *mean)
+{
+    pairwise_moments total = {0};
+    for (size_t i = 0; i < len; i += SIMD_BLOCK)
+        pairwise_merge(&total, SIMD_FN(block_moments)(&vec[i], len - i < SIMD_BLOCK ? len - i : SIMD_BLOCK));
+
+    moments m = moments_total(&total);
+    *mean = m.mean;
+    return m.m2;
+}
+
+static double SIMD_FN(block_dot_product)(const SCALAR *__restrict vec1, const SCALAR *__restrict vec2, size_t len)
+{
+    DOUBLE a0 = SET_ZERO, a1 = SET_ZERO, a2 = SET_ZERO, a3 = SET_ZERO;
+
+    size_t i = 0;
+    for (; i + 4 * SIMD_VEC_LEN <= len; i += 4 * SIMD_VEC_LEN)
+    {
+        a0 = FMA(LOAD_SCALAR(&vec1[i]), LOAD_SCALAR(&vec2[i]), a0);
+        a1 = FMA(LOAD_SCALAR(&vec1[i + SIMD_VEC_LEN]), LOAD_SCALAR(&vec2[i + SIMD_VEC_LEN]), a1);
+        a2 = FMA(LOAD_SCALAR(&vec1[i + 2 * SIMD_VEC_LEN]), LOAD_SCALAR(&vec2[i + 2 * SIMD_VEC_LEN]), a2);
+        a3 = FMA(LOAD_SCALAR(&vec1[i + 3 * SIMD_VEC_LEN]), LOAD_SCALAR(&vec2[i + 3 * SIMD_VEC_LEN]), a3);
+    }
+    for (; i + SIMD_VEC_LEN <= len; i += SIMD_VEC_LEN)
+        a0 = FMA(LOAD_SCALAR(&vec1[i]), LOAD_SCALAR(&vec2[i]), a0);
+
+    double result = SIMD_FN(horizontal_sum)(ADD(ADD(a0, a1), ADD(a2, a3)));
+    for (; i < len; i++)
+        result += (double)vec1[i] * vec2[i];
+
+    return result;
+}
+
+static double SIMD_FN(vector_dot_product)(const SCALAR *__restrict vec1, const SCALAR *__restrict vec2, size_t len)
+{
+    pairwise_sum total = {0};
+    for (size_t i = 0; i < len; i += SIMD_BLOCK)
+        pairwise_push(&total, SIMD_FN(block_dot_product)(&vec1[i], &vec2[i], len - i < SIMD_BLOCK ? len - i : SIMD_BLOCK));
+    return pairwise_total(&total);
+}
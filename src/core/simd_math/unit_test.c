@@ -8,37 +8,103 @@
 #include "./simd_math.h"
 #include <stdio.h>
 
+static double level[1000], tenths[1 << 20], sliced[3 * SIMD_SLICE + 1000];
+
 int main(void)
 {
     double vector[] = {3.14, 7.29, 1.67, 9.85, 0.42, 6.38, 4.71, 8.93, 2.56, 5.30, 0.77, 9.12, 3.63, 1.45, 6.96, 8.02, 2.38, 7.71, 5.69, 4.04, 6.47, 0.88, 1.23, 3.86, 8.58, 7.04, 2.14, 9.67, 5.81, 4.35, 1.98, 6.23, 3.51, 0.64, 8.79, 2.92, 7.49, 9.01, 4.18, 5.56, 3.25, 1.09, 6.73, 7.95, 2.67, 0.35, 8.36, 9.76, 5.43, 4.80, 0.91, 6.11, 3.84, 2.20, 7.62, 9.32, 4.94, 5.18, 1.36, 8.87, 6.66, 3.10, 0.73, 2.05, 9.48, 7.24, 5.97, 4.07, 8.42, 1.75, 6.85, 0.19, 3.47, 2.88, 7.13, 9.95, 4.60, 5.39, 1.02, 8.25, 0.58, 3.69, 6.59, 2.34, 7.83, 4.50, 9.19, 5.02, 8.10, 1.41, 6.28, 3.93, 2.46, 0.27, 7.99, 5.74, 9.08, 4.31, 1.14, 8.63};
     double vector2[] = {4.13, 7.72, 2.86, 9.45, 1.24, 5.89, 3.61, 8.57, 0.93, 6.30, 1.78, 9.34, 4.02, 2.13, 7.46, 8.19, 0.81, 6.62, 5.18, 3.79, 6.91, 0.47, 1.69, 4.95, 8.06, 7.31, 2.09, 9.12, 5.36, 3.40, 2.27, 6.78, 1.85, 0.52, 9.03, 3.19, 7.60, 8.75, 4.07, 5.93, 2.65, 1.17, 6.49, 7.68, 3.30, 0.26, 8.94, 9.58, 5.07, 4.66, 1.53, 6.40, 2.79, 3.01, 7.85, 9.14, 4.29, 5.11, 0.98, 8.48, 6.34, 2.44, 1.12, 0.84, 9.71, 7.16, 5.43, 3.67, 8.26, 1.59, 6.96, 0.32, 2.38, 3.76, 7.07, 9.89, 4.51, 5.87, 1.25, 8.03, 0.69, 4.17, 6.12, 2.68, 7.99, 3.53, 9.36, 5.49, 8.75, 1.03, 6.57, 2.96, 3.21, 0.45, 7.64, 5.70, 9.25, 4.41, 1.30, 8.82};
     size_t len = sizeof(vector) / sizeof(*vector);
 
-    printf("Using %s-bit mode\n", SIMD_MODE);
+    // float32 copies, and the same values widened back to double for the reference results
+    float vectorf[sizeof(vector) / sizeof(*vector)], vector2f[sizeof(vector2) / sizeof(*vector2)];
+    double widened[sizeof(vector) / sizeof(*vector)], widened2[sizeof(vector2) / sizeof(*vector2)];
+    for (size_t i = 0; i < len; i++)
+    {
+        vectorf[i] = (float)vector[i];
+        vector2f[i] = (float)vector2[i];
+        widened[i] = vectorf[i];
+        widened2[i] = vector2f[i];
+    }
+
+    printf("Selected %s-bit mode\n", simd_mode());
+
+    int modes[] = {512, 256, 128};
+    for (size_t m = 0; m < sizeof(modes) / sizeof(*modes); m++)
+    {
+        if (simd_select(modes[m]) != 0)
+        {
+            printf("Skipping %d-bit mode (not supported)\n", modes[m]);
+            continue;
+        }
+        printf("Using %s-bit mode\n", simd_mode());
+
+        double sum = vector_sum(vector, len);
+        assert(almost_equal(sum, 499.38));
+        puts("Test Case 1 passed!");
+
+        double mean = vector_mean(vector, len);
+        assert(almost_equal(mean, 4.9938));
+        puts("Test Case 2 passed!");
+
+        // the rounding of a 1e57 product depends on how many lanes share the work, compare relatively
+        double multiply = vector_multiply(vector, len);
+        assert(fabs(multiply / (double)4800056080175515710579377398391183313388782673931194597376.000000 - 1.0) < 1e-12);
+        puts("Test Case 3 passed!");
+
+        double variance = vector_variance(vector, len);
+        assert(almost_equal(variance, 8.31462956));
+        puts("Test Case 4 passed!");
 
-    double sum = vector_sum(vector, len);
-    assert(almost_equal(sum, 499.38));
-    puts("Test Case 1 passed!");
+        double std_deviation = vector_std_deviation(vector, len);
+        assert(almost_equal(std_deviation, 2.8835099375587387));
+        puts("Test Case 5 passed!");
 
-    double mean = vector_mean(vector, len);
-    assert(almost_equal(mean, 4.9938));
-    puts("Test Case 2 passed!");
+        double dot_product = vector_dot_product(vector, vector2, len);
+        assert(almost_equal(dot_product, 3289.7791999999995));
+        puts("Test Case 6 passed!");
 
-    double multiply = vector_multiply(vector, len);
-    assert(almost_equal(multiply, (double)4800056080175515710579377398391183313388782673931194597376.000000));
-    puts("Test Case 3 passed!");
+        // float32 kernels accumulate in double, exactly like the double kernels on the widened values
+        assert(vector_sumf(vectorf, len) == vector_sum(widened, len));
+        assert(vector_meanf(vectorf, len) == vector_mean(widened, len));
+        assert(vector_multiplyf(vectorf, len) == vector_multiply(widened, len));
+        assert(vector_variancef(vectorf, len) == vector_variance(widened, len));
+        assert(vector_std_deviationf(vectorf, len) == vector_std_deviation(widened, len));
+        assert(vector_dot_productf(vectorf, vector2f, len) == vector_dot_product(widened, widened2, len));
+        assert(fabs(vector_sumf(vectorf, len) - 499.38) < 1e-4);
+        puts("Test Case 7 passed!");
 
-    double variance = vector_variance(vector, len);
-    assert(almost_equal(variance, 8.31462956));
-    puts("Test Case 4 passed!");
+        // price-level data: the deviations are tiny next to the level, 0..9 repeated has variance 8.25
+        for (size_t i = 0; i < sizeof(level) / sizeof(*level); i++)
+            level[i] = 1e9 + (double)(i % 10);
+        assert(almost_equal(vector_variance(level, sizeof(level) / sizeof(*level)), 8.25));
+        puts("Test Case 8 passed!");
 
-    double std_deviation = vector_std_deviation(vector, len);
-    assert(almost_equal(std_deviation, 2.8835099375587387));
-    puts("Test Case 5 passed!");
+        // 2^20 x 0.1, the pairwise sum stays within a few ulps of the exact total
+        for (size_t i = 0; i < sizeof(tenths) / sizeof(*tenths); i++)
+            tenths[i] = 0.1;
+        assert(fabs(vector_sum(tenths, sizeof(tenths) / sizeof(*tenths)) - 104857.6) < 1e-9);
+        assert(fabs(vector_dot_product(tenths, tenths, sizeof(tenths) / sizeof(*tenths)) - 10485.76) < 1e-10);
+        puts("Test Case 9 passed!");
 
-    double dot_product = vector_dot_product(vector,vector2 , len);
-    assert(almost_equal(dot_product, 3289.7791999999995));
-    puts("Test Case 6 passed!");
+        // slices reduced one by one and combined give exactly the whole-array result
+        size_t n = sizeof(sliced) / sizeof(*sliced), slices = (n + SIMD_SLICE - 1) / SIMD_SLICE;
+        double sums[4], dots[4], means[4], m2s[4], combined_mean, whole_mean;
+        for (size_t i = 0; i < n; i++)
+            sliced[i] = 1e6 + (double)(i * 7919 % 1000) * 1e-3;
+        for (size_t s = 0; s < slices; s++)
+        {
+            size_t count = n - s * SIMD_SLICE < SIMD_SLICE ? n - s * SIMD_SLICE : SIMD_SLICE;
+            sums[s] = vector_sum(&sliced[s * SIMD_SLICE], count);
+            dots[s] = vector_dot_product(&sliced[s * SIMD_SLICE], &tenths[s * SIMD_SLICE], count);
+            m2s[s] = vector_moments(&sliced[s * SIMD_SLICE], count, &means[s]);
+        }
+        assert(combine_sums(sums, n) == vector_sum(sliced, n));
+        assert(combine_sums(dots, n) == vector_dot_product(sliced, tenths, n));
+        assert(combine_moments(means, m2s, n, &combined_mean) == vector_moments(sliced, n, &whole_mean));
+        assert(combined_mean == whole_mean);
+        puts("Test Case 10 passed!");
+    }
 
     return 0;
 }
\ No newline at end of file
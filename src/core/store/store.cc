@@ -0,0 +1,173 @@
+/**
+ * @file store.cc
+ * @license This file is licensed under the GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007. You may obtain a copy of this license at https://www.gnu.org/licenses/gpl-3.0.en.html.
+ * @author Tushar Chaurasia (Dark-CodeX)
+ */
+
+#include "./store.hh"
+
+namespace core::store
+{
+    namespace
+    {
+        constexpr char MAGIC[8] = {'Q', 'Z', 'O', 'H', 'L', 'C', 'V', '\0'};
+        constexpr std::uint32_t ORDER_MARK = 0x01020304;
+        constexpr std::uint32_t VERSION = 1;
+        constexpr std::size_t ALIGN = 64;
+
+        std::uint64_t align_up(const std::uint64_t &v)
+        {
+            return (v + ALIGN - 1) / ALIGN * ALIGN;
+        }
+
+        bool write_padding(std::FILE *f, const std::uint64_t &pos, const std::uint64_t &target)
+        {
+            static const char zeros[ALIGN] = {};
+            return target == pos || std::fwrite(zeros, 1, target - pos, f) == target - pos;
+        }
+    }
+
+    std::int64_t days_from_civil(std::int64_t y, const unsigned &m, const unsigned &d)
+    {
+        // shifts the year to start in March, so the leap day is the last day of the year
+        y -= m <= 2;
+        const std::int64_t era = (y >= 0 ? y : y - 399) / 400;
+        const std::int64_t yoe = y - era * 400;
+        const std::int64_t doy = (153 * ((std::int64_t)m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+        const std::int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + doe - 719468;
+    }
+
+    bool write(const std::string &path, const std::string &symbol, const columns &data)
+    {
+        const std::uint64_t rows = data.date.size();
+        for (const std::span<const double> &col : data.fields)
+        {
+            if (!col.empty() && col.size() != rows)
+                return false;
+        }
+
+        header h{};
+        std::memcpy(h.magic, MAGIC, sizeof(MAGIC));
+        h.byte_order = ORDER_MARK;
+        h.version = VERSION;
+        h.rows = rows;
+        std::memcpy(h.symbol, symbol.data(), std::min(symbol.size(), SYMBOL_SIZE - 1));
+        h.date_offset = HEADER_SIZE;
+        std::uint64_t pos = align_up(h.date_offset + rows * sizeof(std::int64_t));
+        for (std::size_t f = 0; f < FIELDS; f++)
+        {
+            h.offsets[f] = pos;
+            pos = align_up(pos + rows * sizeof(double));
+        }
+
+        // written next to the target and renamed over it, a reader never maps a half written file
+        const std::string tmp = path + ".tmp." + std::to_string(::getpid());
+        std::FILE *f = std::fopen(tmp.c_str(), "wb");
+        if (!f)
+            return false;
+
+        bool good = std::fwrite(&h, sizeof(h), 1, f) == 1 && write_padding(f, sizeof(h), HEADER_SIZE);
+        good = good && std::fwrite(data.date.data(), sizeof(std::int64_t), rows, f) == rows;
+        pos = h.date_offset + rows * sizeof(std::int64_t);
+        for (std::size_t c = 0; c < FIELDS && good; c++)
+        {
+            good = write_padding(f, pos, h.offsets[c]);
+            if (!data.fields[c].empty())
+                good = good && std::fwrite(data.fields[c].data(), sizeof(double), rows, f) == rows;
+            else
+            {
+                // a missing field is stored as NaN, a chunk at a time
+                std::vector<double> nan(std::min<std::uint64_t>(rows, 4096), std::numeric_limits<double>::quiet_NaN());
+                for (std::uint64_t done = 0; done < rows && good; done += nan.size())
+                {
+                    std::size_t n = std::min<std::uint64_t>(nan.size(), rows - done);
+                    good = std::fwrite(nan.data(), sizeof(double), n, f) == n;
+                }
+            }
+            pos = h.offsets[c] + rows * sizeof(double);
+        }
+
+        good = std::fclose(f) == 0 && good;
+        if (!good || std::rename(tmp.c_str(), path.c_str()) != 0)
+        {
+            std::remove(tmp.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    mapped::mapped(const std::string &path)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return;
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || (std::size_t)st.st_size < HEADER_SIZE)
+        {
+            ::close(fd);
+            return;
+        }
+        size = st.st_size;
+        void *p = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        // the mapping keeps the file alive on its own
+        ::close(fd);
+        if (p == MAP_FAILED)
+            return;
+        base = p;
+
+        const header &h = *static_cast<const header *>(base);
+        auto fits = [&](const std::uint64_t &offset, const std::uint64_t &elem)
+        {
+            return offset % ALIGN == 0 && offset <= size && h.rows <= (size - offset) / elem;
+        };
+        bool valid = std::memcmp(h.magic, MAGIC, sizeof(MAGIC)) == 0 && h.byte_order == ORDER_MARK && h.version == VERSION &&
+                     fits(h.date_offset, sizeof(std::int64_t));
+        for (std::size_t f = 0; f < FIELDS && valid; f++)
+            valid = fits(h.offsets[f], sizeof(double));
+        if (!valid)
+        {
+            release();
+            return;
+        }
+
+        const char *bytes = static_cast<const char *>(base);
+        name = std::string_view(h.symbol, strnlen(h.symbol, SYMBOL_SIZE));
+        data.date = std::span<const std::int64_t>(reinterpret_cast<const std::int64_t *>(bytes + h.date_offset), h.rows);
+        for (std::size_t f = 0; f < FIELDS; f++)
+            data.fields[f] = std::span<const double>(reinterpret_cast<const double *>(bytes + h.offsets[f]), h.rows);
+    }
+
+    mapped::~mapped()
+    {
+        release();
+    }
+
+    mapped::mapped(mapped &&other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    mapped &mapped::operator=(mapped &&other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+            std::swap(base, other.base);
+            std::swap(size, other.size);
+            std::swap(name, other.name);
+            std::swap(data, other.data);
+        }
+        return *this;
+    }
+
+    void mapped::release()
+    {
+        if (base)
+            ::munmap(base, size);
+        base = nullptr;
+        size = 0;
+        name = {};
+        data = columns{};
+    }
+}
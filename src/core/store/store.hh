@@ -0,0 +1,128 @@
+/**
+ * @file store.hh
+ * @license This file is licensed under the GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007. You may obtain a copy of this license at https://www.gnu.org/licenses/gpl-3.0.en.html.
+ * @author Tushar Chaurasia (Dark-CodeX)
+ */
+
+#ifndef QUANTZ_STORE_HH
+#define QUANTZ_STORE_HH
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <span>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <cstdio>
+#include <algorithm>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/**
+ * Columnar OHLCV files. Layout (native byte order):
+ *
+ *     header (4096 bytes) | date (int64 days since 1970-01-01) | open | high | low | close | volume (float64)
+ *
+ * Every column starts on a 64-byte boundary. Files are opened with a read-only shared mapping, so any
+ * number of processes reading the same file share one copy in the page cache and opening costs no parse.
+ */
+namespace core::store
+{
+    enum class field : std::uint8_t
+    {
+        OPEN,
+        HIGH,
+        LOW,
+        CLOSE,
+        VOLUME
+    };
+
+    constexpr std::size_t FIELDS = 5;
+    constexpr std::size_t HEADER_SIZE = 4096;
+    constexpr std::size_t SYMBOL_SIZE = 64;
+
+    struct header
+    {
+        // "QZOHLCV\0"
+        char magic[8];
+        // 0x01020304 as written, anything else is a foreign byte order
+        std::uint32_t byte_order;
+        std::uint32_t version;
+        std::uint64_t rows;
+        char symbol[SYMBOL_SIZE];
+        // byte offset of the date column, then of each `field`
+        std::uint64_t date_offset;
+        std::uint64_t offsets[FIELDS];
+    };
+
+    /**
+     * @brief Columns of one symbol, a field may be empty (it is stored as NaN)
+     */
+    struct columns
+    {
+        std::span<const std::int64_t> date;
+        std::array<std::span<const double>, FIELDS> fields;
+
+        std::span<const double> operator[](const field &f) const { return fields[(std::size_t)f]; }
+    };
+
+    /**
+     * @brief Days since 1970-01-01 of a proleptic Gregorian date
+     *
+     * @param y Year
+     * @param m Month [1, 12]
+     * @param d Day [1, 31]
+     * @return Day number, negative before 1970
+     */
+    std::int64_t days_from_civil(std::int64_t y, const unsigned &m, const unsigned &d);
+
+    /**
+     * @brief Writes a store file, atomically: readers keep the previous version until the rename
+     *
+     * @param path Destination file
+     * @param symbol Symbol recorded in the header (truncated to 63 bytes)
+     * @param data Columns, `date` gives the row count and non-empty fields must have as many rows
+     * @return false if a field has the wrong length or the file could not be written
+     */
+    bool write(const std::string &path, const std::string &symbol, const columns &data);
+
+    /**
+     * @brief Read-only mapping of a store file, the spans stay valid for the lifetime of the object
+     */
+    class mapped
+    {
+    public:
+        /**
+         * @brief Maps `path`, `ok()` is false if it is missing or not a valid store file
+         */
+        explicit mapped(const std::string &path);
+        ~mapped();
+
+        mapped(const mapped &) = delete;
+        mapped &operator=(const mapped &) = delete;
+        mapped(mapped &&other) noexcept;
+        mapped &operator=(mapped &&other) noexcept;
+
+        bool ok() const { return base != nullptr; }
+        std::size_t rows() const { return data.date.size(); }
+        std::string_view symbol() const { return name; }
+        const columns &view() const { return data; }
+
+    private:
+        void *base = nullptr;
+        std::size_t size = 0;
+        std::string_view name;
+        columns data;
+
+        void release();
+    };
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,358 @@
+/**
+ * @file strategy.cc
+ * @license This file is licensed under the GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007. You may obtain a copy of this license at https://www.gnu.org/licenses/gpl-3.0.en.html.
+ * @author Tushar Chaurasia (Dark-CodeX)
+ */
+
+#include "./strategy.hh"
+
+namespace core::strategy
+{
+    namespace
+    {
+        constexpr std::size_t FALSE_SLOT = 0;
+        constexpr std::size_t TRUE_SLOT = 1;
+        // bars evaluated per pass, fixed so that every kernel loop has a constant trip count
+        constexpr std::size_t BLOCK = 1024;
+
+        // values flowing through the graph: None, a float column or a bool column
+        enum class value_type : std::uint8_t
+        {
+            NONE,
+            NUMBER,
+            BOOL
+        };
+
+        struct operand
+        {
+            value_type t = value_type::NONE;
+            std::size_t slot = FALSE_SLOT;
+        };
+
+        bool compare(const opcode &op, const double &a, const double &b)
+        {
+            switch (op)
+            {
+            case opcode::GE:
+                return a >= b;
+            case opcode::LE:
+                return a <= b;
+            case opcode::EQ:
+                return a == b;
+            case opcode::NE:
+                return a != b;
+            case opcode::GT:
+                return a > b;
+            case opcode::LT:
+                return a < b;
+            default:
+                return false;
+            }
+        }
+
+        template <typename F>
+        void cmp_block(double *__restrict dst, const double *__restrict a, const double t, F f)
+        {
+            for (std::size_t j = 0; j < BLOCK; j++)
+                dst[j] = f(a[j], t) ? 1.0 : 0.0;
+        }
+
+        bool is_const(const std::size_t &slot)
+        {
+            return slot == FALSE_SLOT || slot == TRUE_SLOT;
+        }
+    }
+
+    opcode resolve_operator(const std::string &label)
+    {
+        if (label == "More Than or Equals To (≥)" || label == ">=")
+            return opcode::GE;
+        if (label == "Less Than or Equals To (≤)" || label == "<=")
+            return opcode::LE;
+        if (label == "Equals (=)" || label == "==")
+            return opcode::EQ;
+        if (label == "Not Equals (≠)" || label == "≠")
+            return opcode::NE;
+        if (label == "More Than (>)" || label == ">")
+            return opcode::GT;
+        if (label == "Less Than (<)" || label == "<")
+            return opcode::LT;
+        return opcode::NONE;
+    }
+
+    signal resolve_action(const std::string &label)
+    {
+        if (label == "Buy")
+            return signal::BUY;
+        if (label == "Sell")
+            return signal::SELL;
+        return signal::NONE;
+    }
+
+    bool is_acyclic(const dag &graph)
+    {
+        if (graph.start < 0)
+            return true;
+
+        // 0 = unvisited, 1 = on the current path, 2 = done
+        std::vector<std::uint8_t> state(graph.nodes.size(), 0);
+        std::vector<std::pair<std::size_t, std::size_t>> stack{{(std::size_t)graph.start, 0}};
+        state[graph.start] = 1;
+
+        while (!stack.empty())
+        {
+            auto &[id, next] = stack.back();
+            const std::vector<std::size_t> &children = graph.nodes[id].children;
+            if (next == children.size())
+            {
+                state[id] = 2;
+                stack.pop_back();
+                continue;
+            }
+            std::size_t child = children[next++];
+            if (state[child] == 1)
+                return false;
+            if (state[child] == 0)
+            {
+                state[child] = 1;
+                stack.emplace_back(child, 0);
+            }
+        }
+        return true;
+    }
+
+    program compile(const dag &graph)
+    {
+        program prog;
+        if (!is_acyclic(graph))
+            return prog;
+        prog.ok = true;
+        if (graph.start < 0)
+            return prog;
+
+        std::map<std::tuple<instr_code, opcode, std::size_t, std::size_t, std::uint64_t>, std::size_t> cse;
+        auto emit = [&](const instr_code code, const opcode op, const std::size_t a, const std::size_t b, const double t) -> std::size_t
+        {
+            auto [it, inserted] = cse.try_emplace({code, op, a, b, std::bit_cast<std::uint64_t>(t)}, prog.slots);
+            if (inserted)
+            {
+                prog.code.push_back(instruction{code, op, prog.slots, a, b, t, signal::NONE});
+                prog.slots++;
+            }
+            return it->second;
+        };
+        auto land = [&](std::size_t a, std::size_t b) -> std::size_t
+        {
+            if (a == FALSE_SLOT || b == FALSE_SLOT)
+                return FALSE_SLOT;
+            if (a == TRUE_SLOT || a == b)
+                return b;
+            if (b == TRUE_SLOT)
+                return a;
+            return emit(instr_code::AND, opcode::NONE, std::min(a, b), std::max(a, b), 0.0);
+        };
+        auto lnot = [&](std::size_t a) -> std::size_t
+        {
+            if (is_const(a))
+                return a == FALSE_SLOT ? TRUE_SLOT : FALSE_SLOT;
+            return emit(instr_code::NOT, opcode::NONE, a, 0, 0.0);
+        };
+
+        // the subtree of a state depends only on (node, input, reachability); its EMITs already precede
+        // any later visit of the same state, so expanding it again could never change a signal
+        std::set<std::tuple<std::size_t, value_type, std::size_t, std::size_t>> seen;
+        std::set<std::size_t> emitted;
+
+        struct state
+        {
+            std::size_t id;
+            operand in;
+            std::size_t alive;
+        };
+        std::vector<state> stack{{(std::size_t)graph.start, operand{}, TRUE_SLOT}};
+
+        while (!stack.empty())
+        {
+            auto [id, output, alive] = stack.back();
+            stack.pop_back();
+            if (!seen.emplace(id, output.t, output.slot, alive).second)
+                continue;
+            const node &curr = graph.nodes[id];
+
+            switch (curr.kind)
+            {
+            case node_kind::INDICATOR:
+                if (curr.column < 0)
+                    output = operand{};
+                else
+                    output = operand{value_type::NUMBER, emit(instr_code::LOAD, opcode::NONE, curr.column, 0, 0.0)};
+                break;
+
+            case node_kind::OPERATOR:
+                if (output.t == value_type::NONE || !curr.has_threshold || curr.op == opcode::NONE)
+                    output = operand{value_type::BOOL, FALSE_SLOT};
+                else if (output.t == value_type::BOOL && is_const(output.slot))
+                    output = operand{value_type::BOOL, compare(curr.op, output.slot == TRUE_SLOT ? 1.0 : 0.0, curr.threshold) ? TRUE_SLOT : FALSE_SLOT};
+                else
+                    output = operand{value_type::BOOL, emit(instr_code::CMP, curr.op, output.slot, 0, curr.threshold)};
+                break;
+
+            case node_kind::LOGIC:
+                // only pass forward where the logic node matches the boolean input
+                if (!curr.logic_valid || output.t != value_type::BOOL)
+                    continue;
+                alive = land(alive, curr.logic_value ? output.slot : lnot(output.slot));
+                if (alive == FALSE_SLOT)
+                    continue;
+                output = operand{value_type::BOOL, TRUE_SLOT};
+                break;
+
+            case node_kind::ACTION:
+            {
+                if (output.t != value_type::BOOL)
+                    continue;
+                std::size_t fire = land(alive, output.slot);
+                if (fire == FALSE_SLOT || !emitted.insert(fire).second)
+                    continue;
+                prog.code.push_back(instruction{instr_code::EMIT, opcode::NONE, 0, fire, 0, 0.0, curr.action});
+                // every bar is decided from here on, nothing later can fire
+                if (fire == TRUE_SLOT)
+                    return prog;
+                continue;
+            }
+
+            default:
+                // control nodes fall through (no value change)
+                break;
+            }
+
+            for (const std::size_t &child : curr.children)
+                stack.push_back(state{child, output, alive});
+        }
+        return prog;
+    }
+
+    std::vector<signal> evaluate(const program &prog, const std::vector<std::span<const double>> &columns, const std::size_t &len)
+    {
+        if (!prog.ok)
+            return {};
+        for (const instruction &ins : prog.code)
+        {
+            if (ins.code == instr_code::LOAD && (ins.a >= columns.size() || columns[ins.a].size() < len))
+                return {};
+        }
+
+        std::vector<signal> res(len, signal::NONE);
+        std::vector<double> slots(prog.slots * BLOCK, 0.0);
+        std::fill_n(slots.begin() + TRUE_SLOT * BLOCK, BLOCK, 1.0);
+        std::vector<std::uint8_t> decided(BLOCK);
+
+        for (std::size_t base = 0; base < len; base += BLOCK)
+        {
+            const std::size_t m = std::min(BLOCK, len - base);
+            std::fill(decided.begin(), decided.end(), 0);
+
+            for (const instruction &ins : prog.code)
+            {
+                double *dst = slots.data() + ins.dst * BLOCK;
+                const double *a = slots.data() + ins.a * BLOCK;
+                const double *b = slots.data() + ins.b * BLOCK;
+
+                switch (ins.code)
+                {
+                case instr_code::LOAD:
+                    std::copy_n(columns[ins.a].data() + base, m, dst);
+                    std::fill(dst + m, dst + BLOCK, std::numeric_limits<double>::quiet_NaN());
+                    break;
+
+                case instr_code::CMP:
+                    switch (ins.op)
+                    {
+                    case opcode::GE:
+                        cmp_block(dst, a, ins.threshold, std::greater_equal<double>());
+                        break;
+                    case opcode::LE:
+                        cmp_block(dst, a, ins.threshold, std::less_equal<double>());
+                        break;
+                    case opcode::EQ:
+                        cmp_block(dst, a, ins.threshold, std::equal_to<double>());
+                        break;
+                    case opcode::NE:
+                        cmp_block(dst, a, ins.threshold, std::not_equal_to<double>());
+                        break;
+                    case opcode::GT:
+                        cmp_block(dst, a, ins.threshold, std::greater<double>());
+                        break;
+                    case opcode::LT:
+                        cmp_block(dst, a, ins.threshold, std::less<double>());
+                        break;
+                    default:
+                        std::fill_n(dst, BLOCK, 0.0);
+                        break;
+                    }
+                    break;
+
+                case instr_code::AND:
+                    for (std::size_t j = 0; j < BLOCK; j++)
+                        dst[j] = a[j] * b[j];
+                    break;
+
+                case instr_code::NOT:
+                    for (std::size_t j = 0; j < BLOCK; j++)
+                        dst[j] = 1.0 - a[j];
+                    break;
+
+                case instr_code::EMIT:
+                    for (std::size_t j = 0; j < m; j++)
+                    {
+                        if (!decided[j] && a[j] != 0.0)
+                        {
+                            res[base + j] = ins.action;
+                            decided[j] = 1;
+                        }
+                    }
+                    break;
+                }
+            }
+        }
+        return res;
+    }
+
+    signal step(const program &prog, std::span<const double> values, std::vector<double> &slots)
+    {
+        if (!prog.ok)
+            return signal::NONE;
+        slots.assign(prog.slots, 0.0);
+        slots[TRUE_SLOT] = 1.0;
+
+        for (const instruction &ins : prog.code)
+        {
+            switch (ins.code)
+            {
+            case instr_code::LOAD:
+                slots[ins.dst] = ins.a < values.size() ? values[ins.a] : std::numeric_limits<double>::quiet_NaN();
+                break;
+            case instr_code::CMP:
+                slots[ins.dst] = compare(ins.op, slots[ins.a], ins.threshold) ? 1.0 : 0.0;
+                break;
+            case instr_code::AND:
+                slots[ins.dst] = slots[ins.a] * slots[ins.b];
+                break;
+            case instr_code::NOT:
+                slots[ins.dst] = 1.0 - slots[ins.a];
+                break;
+            case instr_code::EMIT:
+                // EMITs are in priority order, the first one that fires decides
+                if (slots[ins.a] != 0.0)
+                    return ins.action;
+                break;
+            }
+        }
+        return signal::NONE;
+    }
+
+    std::vector<signal> signals(const dag &graph, const std::vector<std::span<const double>> &columns, const std::size_t &len)
+    {
+        return evaluate(compile(graph), columns, len);
+    }
+}
@@ -0,0 +1,185 @@
+/**
+ * @file strategy.hh
+ * @license This file is licensed under the GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007. You may obtain a copy of this license at https://www.gnu.org/licenses/gpl-3.0.en.html.
+ * @author Tushar Chaurasia (Dark-CodeX)
+ */
+
+#ifndef QUANTZ_STRATEGY_HH
+#define QUANTZ_STRATEGY_HH
+
+#include <vector>
+#include <string>
+#include <span>
+#include <cmath>
+#include <limits>
+#include <cstdint>
+#include <cstddef>
+#include <map>
+#include <set>
+#include <tuple>
+#include <algorithm>
+#include <functional>
+#include <bit>
+
+namespace core::strategy
+{
+    enum class signal : std::int8_t
+    {
+        NONE = 0,
+        BUY = 1,
+        SELL = -1
+    };
+
+    enum class node_kind : std::uint8_t
+    {
+        CONTROL,
+        INDICATOR,
+        OPERATOR,
+        LOGIC,
+        ACTION
+    };
+
+    enum class opcode : std::uint8_t
+    {
+        NONE,
+        GE,
+        LE,
+        EQ,
+        NE,
+        GT,
+        LT
+    };
+
+    /**
+     * @brief Node of the strategy graph built by the FlowCanvas editor, with its label already resolved
+     */
+    struct node
+    {
+        node_kind kind = node_kind::CONTROL;
+        // OPERATOR: comparison, `NONE` for labels the editor does not know about
+        opcode op = opcode::NONE;
+        // OPERATOR: right hand side, `has_threshold` is false when it is missing or not a number
+        double threshold = std::numeric_limits<double>::quiet_NaN();
+        bool has_threshold = false;
+        // LOGIC: true for "TRUE", false for "FALSE"; any other label never passes
+        bool logic_value = false;
+        bool logic_valid = false;
+        // ACTION: signal emitted, `NONE` for unknown labels (they still stop the traversal)
+        signal action = signal::NONE;
+        // INDICATOR: index into the indicator columns, -1 when it was not computed
+        std::ptrdiff_t column = -1;
+        std::vector<std::size_t> children;
+    };
+
+    struct dag
+    {
+        std::vector<node> nodes;
+        // index of the first node labelled "Start", -1 if there is none
+        std::ptrdiff_t start = -1;
+    };
+
+    /**
+     * @brief Resolves an operator label to its opcode
+     *
+     * @param label Operator label {"More Than or Equals To (≥)", ">=", "Less Than or Equals To (≤)", "<=", "Equals (=)", "==", "Not Equals (≠)", "≠", "More Than (>)", ">", "Less Than (<)", "<"}
+     * @return Opcode of `label`, `opcode::NONE` if unknown
+     */
+    opcode resolve_operator(const std::string &label);
+
+    /**
+     * @brief Resolves an action label to its signal
+     *
+     * @param label Action label {"Buy", "Sell"}
+     * @return Signal of `label`, `signal::NONE` if unknown
+     */
+    signal resolve_action(const std::string &label);
+
+    /**
+     * @brief Checks that no cycle is reachable from the Start node
+     *
+     * @param graph Strategy graph
+     * @return true if the traversal from Start terminates
+     */
+    bool is_acyclic(const dag &graph);
+
+    enum class instr_code : std::uint8_t
+    {
+        // dst = columns[a] (block of the indicator column, NaN padded)
+        LOAD,
+        // dst = slot[a] `op` threshold ? 1 : 0
+        CMP,
+        // dst = slot[a] && slot[b]
+        AND,
+        // dst = !slot[a]
+        NOT,
+        // signal = action where slot[a] is true and no earlier EMIT fired
+        EMIT
+    };
+
+    struct instruction
+    {
+        instr_code code;
+        opcode op = opcode::NONE;
+        std::size_t dst = 0;
+        std::size_t a = 0;
+        std::size_t b = 0;
+        double threshold = 0.0;
+        signal action = signal::NONE;
+    };
+
+    /**
+     * @brief Strategy graph flattened into a topologically ordered instruction list over column slots
+     */
+    struct program
+    {
+        std::vector<instruction> code;
+        // slot 0 is constant false, slot 1 is constant true
+        std::size_t slots = 2;
+        // false if the graph could not be compiled (cycle reachable from Start)
+        bool ok = false;
+    };
+
+    /**
+     * @brief Compiles the strategy graph into a flat program
+     *
+     * Every path from Start is unfolded in the same depth-first order as the per-bar traversal, so the
+     * EMIT instructions appear in priority order. Identical sub-expressions and already expanded
+     * (node, input, reachability) states are emitted only once, and constant comparisons are folded.
+     *
+     * @param graph Strategy graph
+     * @return Compiled program, `ok` is false if a cycle is reachable from Start
+     */
+    program compile(const dag &graph);
+
+    /**
+     * @brief Runs a compiled program over every bar, one column block at a time
+     *
+     * @param prog Compiled program
+     * @param columns Precomputed indicator columns, indexed by `node::column`
+     * @param len Number of bars
+     * @return Signal per bar, empty if the program is not ok or a column is shorter than `len`
+     */
+    std::vector<signal> evaluate(const program &prog, const std::vector<std::span<const double>> &columns, const std::size_t &len);
+
+    /**
+     * @brief Runs a compiled program on one bar, for live data where the bars arrive one at a time
+     *
+     * @param prog Compiled program
+     * @param values Latest value of every indicator column, indexed by `node::column` (NaN if missing)
+     * @param slots Scratch space reused between calls, it only allocates while smaller than `program::slots`
+     * @return Signal of the bar, the same `evaluate` gives for it
+     */
+    signal step(const program &prog, std::span<const double> values, std::vector<double> &slots);
+
+    /**
+     * @brief Evaluates the strategy graph for every bar, same as `evaluate(compile(graph), columns, len)`
+     *
+     * @param graph Strategy graph
+     * @param columns Precomputed indicator columns, indexed by `node::column`
+     * @param len Number of bars
+     * @return Signal per bar, empty if the graph has a cycle or a column is shorter than `len`
+     */
+    std::vector<signal> signals(const dag &graph, const std::vector<std::span<const double>> &columns, const std::size_t &len);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,223 @@
+/**
+ * @file unit_test.cc
+ * @license This file is licensed under the GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007. You may obtain a copy of this license at https://www.gnu.org/licenses/gpl-3.0.en.html.
+ * @author Tushar Chaurasia (Dark-CodeX)
+ */
+
+#include <cassert>
+#include <cstdio>
+#include "./strategy.hh"
+
+namespace
+{
+    using namespace core::strategy;
+
+    // the per-bar walk the compiled program replaces: None, a float or a bool flows from Start, the first
+    // action reached with a true input decides the bar
+    signal walk(const dag &graph, const std::vector<std::span<const double>> &columns, const std::size_t &bar)
+    {
+        struct value
+        {
+            enum class type : std::uint8_t
+            {
+                NONE,
+                NUMBER,
+                BOOL
+            } t = type::NONE;
+            double x = 0.0;
+        };
+        if (graph.start < 0)
+            return signal::NONE;
+
+        std::vector<std::pair<std::size_t, value>> stack{{(std::size_t)graph.start, value{}}};
+        while (!stack.empty())
+        {
+            auto [id, output] = stack.back();
+            stack.pop_back();
+            const node &curr = graph.nodes[id];
+            switch (curr.kind)
+            {
+            case node_kind::INDICATOR:
+                output = curr.column < 0 ? value{} : value{value::type::NUMBER, columns[curr.column][bar]};
+                break;
+            case node_kind::OPERATOR:
+            {
+                bool r = false;
+                if (output.t != value::type::NONE && curr.has_threshold)
+                {
+                    const double a = output.x, b = curr.threshold;
+                    r = curr.op == opcode::GE ? a >= b : curr.op == opcode::LE ? a <= b
+                                                     : curr.op == opcode::EQ   ? a == b
+                                                     : curr.op == opcode::NE   ? a != b
+                                                     : curr.op == opcode::GT   ? a > b
+                                                     : curr.op == opcode::LT   ? a < b
+                                                                               : false;
+                }
+                output = value{value::type::BOOL, r ? 1.0 : 0.0};
+                break;
+            }
+            case node_kind::LOGIC:
+                if (!curr.logic_valid || output.t != value::type::BOOL || (output.x != 0.0) != curr.logic_value)
+                    continue;
+                output = value{value::type::BOOL, 1.0};
+                break;
+            case node_kind::ACTION:
+                if (output.t == value::type::BOOL && output.x != 0.0)
+                    return curr.action;
+                continue;
+            default:
+                break;
+            }
+            for (const std::size_t &child : curr.children)
+                stack.emplace_back(child, output);
+        }
+        return signal::NONE;
+    }
+
+    // xorshift, the graphs are the same on every run
+    struct rng
+    {
+        std::uint64_t s = 0x9E3779B97F4A7C15ULL;
+        std::size_t operator()(const std::size_t &n)
+        {
+            s ^= s << 13;
+            s ^= s >> 7;
+            s ^= s << 17;
+            return (std::size_t)(s % n);
+        }
+    };
+
+    // a random graph whose edges only point to the next few nodes, Start is node 0
+    dag random_graph(rng &r, const std::size_t &size, const std::size_t &columns)
+    {
+        dag g;
+        g.nodes.resize(size);
+        g.start = 0;
+        const opcode ops[] = {opcode::NONE, opcode::GE, opcode::LE, opcode::EQ, opcode::NE, opcode::GT, opcode::LT};
+        const double thresholds[] = {0.0, 1.0, 2.0, 0.5, 3.0};
+        for (std::size_t i = 1; i < size; i++)
+        {
+            node &n = g.nodes[i];
+            // mostly indicator -> comparison -> condition -> action runs, so conditions chain along a path
+            const node_kind pattern[] = {node_kind::ACTION, node_kind::INDICATOR, node_kind::OPERATOR, node_kind::LOGIC};
+            n.kind = r(4) == 0 ? (node_kind)r(5) : pattern[i % 4];
+            n.op = ops[r(7)];
+            n.has_threshold = r(8) != 0;
+            n.threshold = thresholds[r(5)];
+            n.logic_value = r(2) != 0;
+            n.logic_valid = r(8) != 0;
+            n.action = r(3) == 0 ? signal::SELL : r(8) != 0 ? signal::BUY
+                                                              : signal::NONE;
+            n.column = r(6) == 0 ? -1 : (std::ptrdiff_t)r(columns);
+        }
+        for (std::size_t i = 0; i + 1 < size; i++)
+        {
+            for (std::size_t c = r(4); c != 0; c--)
+                g.nodes[i].children.emplace_back(i + 1 + r(std::min<std::size_t>(5, size - i - 1)));
+        }
+        return g;
+    }
+}
+
+int main()
+{
+    // small integer columns (so EQ/NE and the 0/1 of booleans meet the thresholds) with NaN bars
+    const std::size_t len = 2500, width = 3;
+    std::vector<std::vector<double>> data(width, std::vector<double>(len));
+    rng r;
+    for (std::vector<double> &c : data)
+    {
+        for (double &v : c)
+            v = r(11) == 0 ? std::numeric_limits<double>::quiet_NaN() : (double)r(4);
+    }
+    const std::vector<std::span<const double>> columns(data.begin(), data.end());
+
+    // compiled signals, the batch evaluation and the bar by bar step all give the per-bar walk
+    std::size_t fired = 0, negated = 0, conjunctions = 0;
+    std::vector<double> slots, latest(width);
+    for (std::size_t t = 0; t < 2000; t++)
+    {
+        const dag g = random_graph(r, 3 + r(24), width);
+        const program prog = compile(g);
+        assert(prog.ok && is_acyclic(g));
+        for (const instruction &ins : prog.code)
+        {
+            negated += ins.code == instr_code::NOT;
+            conjunctions += ins.code == instr_code::AND;
+        }
+        const std::vector<signal> res = signals(g, columns, len), batch = evaluate(prog, columns, len);
+        assert(res.size() == len && batch == res);
+        for (std::size_t i = 0; i < len; i++)
+        {
+            assert(res[i] == walk(g, columns, i));
+            for (std::size_t c = 0; c < width; c++)
+                latest[c] = data[c][i];
+            assert(step(prog, latest, slots) == res[i]);
+            fired += res[i] != signal::NONE;
+        }
+    }
+    // the graphs do reach actions through negated and chained conditions
+    assert(fired > 0 && negated > 0 && conjunctions > 0);
+
+    // Start -> ind -> (> 1) -> FALSE -> Buy: a NOT of the comparison, and a cycle back from Buy
+    dag g;
+    g.nodes.resize(5);
+    g.start = 0;
+    g.nodes[0].children = {1};
+    g.nodes[1].kind = node_kind::INDICATOR;
+    g.nodes[1].column = 0;
+    g.nodes[1].children = {2};
+    g.nodes[2].kind = node_kind::OPERATOR;
+    g.nodes[2].op = opcode::GT;
+    g.nodes[2].threshold = 1.0;
+    g.nodes[2].has_threshold = true;
+    g.nodes[2].children = {3};
+    g.nodes[3].kind = node_kind::LOGIC;
+    g.nodes[3].logic_valid = true;
+    g.nodes[3].logic_value = false;
+    g.nodes[3].children = {4};
+    g.nodes[4].kind = node_kind::ACTION;
+    g.nodes[4].action = signal::BUY;
+    const std::vector<signal> not_gt = signals(g, columns, len);
+    for (std::size_t i = 0; i < len; i++)
+        assert(not_gt[i] == (data[0][i] > 1.0 ? signal::NONE : signal::BUY));
+
+    // ... -> TRUE -> ind -> (< 2) -> Sell ahead of it: an AND of both comparisons, first in priority
+    g.nodes.resize(9);
+    g.nodes[2].children = {3, 5};
+    g.nodes[5].kind = node_kind::LOGIC;
+    g.nodes[5].logic_valid = true;
+    g.nodes[5].logic_value = true;
+    g.nodes[5].children = {6};
+    g.nodes[6].kind = node_kind::INDICATOR;
+    g.nodes[6].column = 1;
+    g.nodes[6].children = {7};
+    g.nodes[7].kind = node_kind::OPERATOR;
+    g.nodes[7].op = opcode::LT;
+    g.nodes[7].threshold = 2.0;
+    g.nodes[7].has_threshold = true;
+    g.nodes[7].children = {8};
+    g.nodes[8].kind = node_kind::ACTION;
+    g.nodes[8].action = signal::SELL;
+    const std::vector<signal> both = signals(g, columns, len);
+    for (std::size_t i = 0; i < len; i++)
+        assert(both[i] == (data[0][i] > 1.0 && data[1][i] < 2.0 ? signal::SELL : not_gt[i]));
+    g.nodes.resize(5);
+    g.nodes[2].children = {3};
+
+    g.nodes[4].children = {1};
+    assert(!is_acyclic(g) && !compile(g).ok && signals(g, columns, len).empty());
+    assert(step(compile(g), latest, slots) == signal::NONE);
+    // a cycle Start cannot reach is never walked
+    g.nodes[4].children.clear();
+    g.nodes.emplace_back();
+    g.nodes.back().children = {g.nodes.size() - 1};
+    assert(is_acyclic(g) && signals(g, columns, len) == not_gt);
+
+    // a column shorter than the bars refuses the whole evaluation
+    const std::vector<std::span<const double>> short_columns = {columns[0].first(len - 1)};
+    assert(signals(g, short_columns, len).empty());
+    printf("compiled strategy programs match the per-bar graph walk\n");
+
+    return 0;
+}
@@ -0,0 +1,158 @@
+/**
+ * @file thread_pool.cc
+ * @license This file is licensed under the GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007. You may obtain a copy of this license at https://www.gnu.org/licenses/gpl-3.0.en.html.
+ * @author Tushar Chaurasia (Dark-CodeX)
+ */
+
+#include "./thread_pool.hh"
+
+namespace core::thread_pool
+{
+    namespace
+    {
+        // pool and deque index of the calling thread, so that submits from a task stay local
+        thread_local const pool *current_pool = nullptr;
+        thread_local std::size_t current_id = 0;
+    }
+
+    pool::pool(std::size_t threads)
+    {
+        if (threads == 0)
+            threads = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+        for (std::size_t i = 0; i < threads; i++)
+            queues.emplace_back(std::make_unique<queue>());
+        for (std::size_t i = 0; i < threads; i++)
+            workers.emplace_back(&pool::worker, this, i);
+    }
+
+    pool::~pool()
+    {
+        {
+            std::lock_guard<std::mutex> guard(sleep_lock);
+            stop = true;
+        }
+        sleep.notify_all();
+        for (std::thread &t : workers)
+            t.join();
+    }
+
+    void pool::submit(std::function<void()> task)
+    {
+        std::size_t q = current_pool == this ? current_id : next_queue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+        {
+            std::lock_guard<std::mutex> guard(queues[q]->lock);
+            queues[q]->tasks.emplace_back(std::move(task));
+        }
+        {
+            // taken so that a worker between its predicate check and its wait cannot miss the wake-up
+            std::lock_guard<std::mutex> guard(sleep_lock);
+            pending.fetch_add(1, std::memory_order_release);
+        }
+        sleep.notify_one();
+    }
+
+    bool pool::try_run(const std::size_t &self)
+    {
+        std::function<void()> task;
+        for (std::size_t k = 0; k < queues.size() && !task; k++)
+        {
+            queue &q = *queues[(self + k) % queues.size()];
+            std::lock_guard<std::mutex> guard(q.lock);
+            if (q.tasks.empty())
+                continue;
+            // own deque LIFO, victims FIFO (their oldest, usually largest, piece of work)
+            if (k == 0)
+            {
+                task = std::move(q.tasks.back());
+                q.tasks.pop_back();
+            }
+            else
+            {
+                task = std::move(q.tasks.front());
+                q.tasks.pop_front();
+            }
+        }
+        if (!task)
+            return false;
+        pending.fetch_sub(1, std::memory_order_acq_rel);
+        task();
+        return true;
+    }
+
+    void pool::worker(const std::size_t id)
+    {
+        current_pool = this;
+        current_id = id;
+        while (true)
+        {
+            if (try_run(id))
+                continue;
+            std::unique_lock<std::mutex> guard(sleep_lock);
+            sleep.wait(guard, [&]
+                       { return stop || pending.load(std::memory_order_acquire) != 0; });
+            if (stop && pending.load(std::memory_order_acquire) == 0)
+                return;
+        }
+    }
+
+    void pool::parallel_for(const std::size_t &count, const std::function<void(std::size_t)> &fn, std::size_t grain)
+    {
+        if (count == 0)
+            return;
+        if (grain == 0)
+            grain = std::max<std::size_t>(1, count / (size() * 8));
+        const std::size_t tasks = (count + grain - 1) / grain;
+
+        struct job
+        {
+            std::atomic<std::size_t> remaining;
+            std::mutex lock;
+            std::condition_variable done;
+            std::exception_ptr error;
+        } state;
+        state.remaining.store(tasks);
+
+        for (std::size_t t = 0; t < tasks; t++)
+        {
+            submit([&, t]
+                   {
+                       try
+                       {
+                           for (std::size_t i = t * grain; i < std::min(count, (t + 1) * grain); i++)
+                               fn(i);
+                       }
+                       catch (...)
+                       {
+                           std::lock_guard<std::mutex> guard(state.lock);
+                           if (!state.error)
+                               state.error = std::current_exception();
+                       }
+                       // decremented under the lock, so the caller cannot free `state` while this task still uses it
+                       std::lock_guard<std::mutex> guard(state.lock);
+                       if (state.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                           state.done.notify_all(); });
+        }
+
+        // help instead of blocking, then wait for the tasks other workers are still running
+        const std::size_t self = current_pool == this ? current_id : 0;
+        while (state.remaining.load(std::memory_order_acquire) != 0)
+        {
+            if (try_run(self))
+                continue;
+            std::unique_lock<std::mutex> guard(state.lock);
+            state.done.wait(guard, [&]
+                            { return state.remaining.load(std::memory_order_acquire) == 0; });
+        }
+
+        // waits for the last task to release the lock before `state` goes away
+        std::lock_guard<std::mutex> guard(state.lock);
+        if (state.error)
+            std::rethrow_exception(state.error);
+    }
+
+    pool &shared()
+    {
+        static pool instance;
+        return instance;
+    }
+}
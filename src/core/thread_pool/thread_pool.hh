@@ -0,0 +1,106 @@
+/**
+ * @file thread_pool.hh
+ * @license This file is licensed under the GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007. You may obtain a copy of this license at https://www.gnu.org/licenses/gpl-3.0.en.html.
+ * @author Tushar Chaurasia (Dark-CodeX)
+ */
+
+#ifndef QUANTZ_THREAD_POOL_HH
+#define QUANTZ_THREAD_POOL_HH
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <future>
+#include <type_traits>
+#include <exception>
+#include <algorithm>
+#include <cstddef>
+
+namespace core::thread_pool
+{
+    /**
+     * Fixed set of workers, each owning a task deque. A worker pops its own deque from the back (newest
+     * first, still hot in cache) and, once empty, steals from the front of the others, so uneven tasks
+     * (long and short series) balance themselves without a central queue.
+     */
+    class pool
+    {
+    public:
+        /**
+         * @brief Starts the workers
+         *
+         * @param threads Number of workers, 0 means one per hardware thread
+         */
+        explicit pool(std::size_t threads = 0);
+        ~pool();
+
+        pool(const pool &) = delete;
+        pool &operator=(const pool &) = delete;
+
+        std::size_t size() const { return workers.size(); }
+
+        /**
+         * @brief Queues a task, on the calling worker's own deque when called from inside the pool
+         *
+         * @param task Task to run, it must not throw
+         */
+        void submit(std::function<void()> task);
+
+        /**
+         * @brief Runs `fn(i)` for every i in [0, count) and returns once all of them finished. The caller
+         * executes tasks too, so nesting `parallel_for` inside a task cannot deadlock
+         *
+         * @param count Number of indices
+         * @param fn Body, the first exception it throws is rethrown here after every index ran
+         * @param grain Indices per task, 0 picks one so that every worker gets several tasks to steal
+         */
+        void parallel_for(const std::size_t &count, const std::function<void(std::size_t)> &fn, std::size_t grain = 0);
+
+        /**
+         * @brief Queues `fn` and returns a future of its result, an exception it throws is stored in the future.
+         * A task must not wait on such a future: with every worker waiting, nothing would run it
+         *
+         * @param fn Callable taking no argument
+         */
+        template <typename F>
+        std::future<std::invoke_result_t<F>> async(F &&fn)
+        {
+            using R = std::invoke_result_t<F>;
+            // std::function needs a copyable task, the packaged_task is shared instead
+            auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(fn));
+            std::future<R> result = task->get_future();
+            submit([task]
+                   { (*task)(); });
+            return result;
+        }
+
+    private:
+        struct queue
+        {
+            std::mutex lock;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        std::vector<std::unique_ptr<queue>> queues;
+        std::vector<std::thread> workers;
+        std::mutex sleep_lock;
+        std::condition_variable sleep;
+        std::atomic<std::size_t> pending{0}, next_queue{0};
+        bool stop = false;
+
+        bool try_run(const std::size_t &self);
+        void worker(const std::size_t id);
+    };
+
+    /**
+     * @brief Process-wide pool, one worker per hardware thread, started on first use
+     */
+    pool &shared();
+}
+
+#endif
\ No newline at end of file
@@ -4,40 +4,103 @@
  @author Tushar Chaurasia (Dark-CodeX)
 """
 
-from io import StringIO
 from flask import Flask, request, jsonify
 import pandas as pd
+import numpy as np
 from flask_cors import CORS
 import quantzlib as qz
 import json
-from backtest import run_backtest, calculate_metrics
+import os
+import io
+import logging
+from backtest import run_backtest, run_optimizer, calculate_metrics, line_row
 
 global_df = None  # better to use None
+# bumped whenever global_df is replaced, cached indicators of older data are never served
+dataset_version = 0
+indicator_cache = qz.IndicatorCache(int(os.environ.get("QUANTZ_CACHE_MB", "512")) * 1024 * 1024)
 
+# columnar copy of the last upload, mapped back in at startup instead of re-parsing the CSV
+STORE_PATH = os.environ.get("QUANTZ_STORE", "./data/latest.qzc")
 
-def CleanCSV(data):
-    global global_df
-    df = pd.read_csv(StringIO(data))
-    df.rename(columns={
-        'Date': 'date',
-        'Close': 'close',
-        'Close/Last': 'close',
-        'Open': 'open',
-        'High': 'high',
-        'Low': 'low',
-        'Volume': 'volume'
-    }, inplace=True)
-    df['date'] = pd.to_datetime(
-        df['date'], format='%m/%d/%Y').dt.strftime('%Y-%m-%d')
-    for col in ['close', 'open', 'high', 'low']:
-        df[col] = pd.to_numeric(df[col].replace(
-            {r'\$': ''}, regex=True), errors='coerce')
-    df['volume'] = pd.to_numeric(df['volume'], errors='coerce')
-    df = df.iloc[::-1].reset_index(drop=True)
+
+def SaveStore(cols, symbol):
+    os.makedirs(os.path.dirname(STORE_PATH) or ".", exist_ok=True)
+    fields = {col: cols[col] for col in ['open', 'high', 'low', 'close', 'volume'] if col in cols}
+    qz.StoreWrite(STORE_PATH, symbol, cols['date'].astype(np.int64), **fields)
+
+
+def LoadStore():
+    global global_df, dataset_version
+    if not os.path.exists(STORE_PATH):
+        return
+    try:
+        store = qz.Store(STORE_PATH)
+    except (RuntimeError, OSError) as e:
+        # a corrupt or foreign file only costs the startup cache, the API starts without data
+        logging.warning("Ignoring store %s: %s", STORE_PATH, e)
+        return
+    dataset_version += 1
+    # same columns and order as CleanCSV gives for the broker export; copy=False keeps the price columns
+    # as read-only views of the mapping (they hold the Store open), so the indicators read it zero-copy
+    global_df = pd.DataFrame({
+        'date': np.datetime_as_string(store.date, unit='D'),
+        'close': store.close,
+        'volume': store.volume,
+        'open': store.open,
+        'high': store.high,
+        'low': store.low
+    }, copy=False)
+
+
+def CleanCSV(data, symbol=""):
+    global global_df, dataset_version
+    # parsed natively: header aliases, $ prices and %m/%d/%Y dates, rows already reversed to oldest first
+    cols = qz.ReadCSV(data)
+    if 'date' in cols:
+        try:
+            SaveStore(cols, symbol)
+        except (RuntimeError, OSError) as e:
+            # the store is only a startup cache, a read-only or full disk must not fail the upload
+            logging.warning("Could not write store %s: %s", STORE_PATH, e)
+        cols['date'] = np.datetime_as_string(cols['date'], unit='D')
+    df = pd.DataFrame(cols)
     global_df = df
+    dataset_version += 1
     return jsonify(df.to_dict(orient='records'))
 
 
+def TicksToBars(data, by="time", threshold=60.0):
+    global global_df, dataset_version
+    # trade prints: a time column (datetime text, or epoch seconds), a price and a size column
+    ticks = pd.read_csv(io.BytesIO(data))
+    names = {str(c).strip().lower(): c for c in ticks.columns}
+    time_col = next((names[n] for n in ("timestamp", "time", "date", "datetime") if n in names), None)
+    price_col = next((names[n] for n in ("price", "last", "close") if n in names), None)
+    size_col = next((names[n] for n in ("size", "qty", "quantity", "volume") if n in names), None)
+    if time_col is None or price_col is None or size_col is None:
+        return "Tick file needs time, price and size columns", 400
+
+    times = ticks[time_col]
+    times = pd.to_datetime(times, unit="s") if pd.api.types.is_numeric_dtype(times) else pd.to_datetime(times)
+    # time bars are given in seconds, timestamps are nanoseconds
+    bars = qz.AggregateTicks(times.to_numpy(dtype="datetime64[ns]").astype(np.int64),
+                             ticks[price_col].to_numpy(dtype=np.float64),
+                             ticks[size_col].to_numpy(dtype=np.float64),
+                             by, threshold * 1e9 if by == "time" else threshold)
+    # same columns and order as CleanCSV gives for the broker export
+    global_df = pd.DataFrame({
+        'date': np.datetime_as_string(bars['time'].astype("datetime64[ns]"), unit='s'),
+        'close': bars['close'],
+        'volume': bars['volume'],
+        'open': bars['open'],
+        'high': bars['high'],
+        'low': bars['low']
+    })
+    dataset_version += 1
+    return jsonify(global_df.to_dict(orient='records'))
+
+
 app = Flask(__name__)
 CORS(
     app,
@@ -51,8 +114,16 @@ def upload(type):
     if type == "csv":
         file = request.files.get("file")
         if file:
-            content = file.read().decode("utf-8")
-            return CleanCSV(content)
+            content = file.read()
+            return CleanCSV(content, os.path.splitext(file.filename or "")[0])
+    elif type == "ticks":
+        file = request.files.get("file")
+        if file:
+            by = request.args.get("by", "time")
+            try:
+                return TicksToBars(file.read(), by, float(request.args.get("threshold", 60)))
+            except (ValueError, RuntimeError) as e:
+                return str(e), 400
     return "No file received or unknown type", 400
 
 
@@ -71,7 +142,8 @@ def backtest():
     comm = conf.get("backtest").get("commission")
 
     equity, trades = run_backtest(
-        global_df, conf, initial_capital=initial_cap, allocation_fraction=pos_size, commission=comm)
+        global_df, conf, initial_capital=initial_cap, allocation_fraction=pos_size, commission=comm,
+        cache=indicator_cache, version=dataset_version)
     metrics = calculate_metrics(equity_df=equity, trades_df=trades)
 
     equity = equity.to_dict(orient='records')
@@ -79,6 +151,59 @@ def backtest():
     return {"equity": equity, "trades": trades, "metrics": metrics}
 
 
+@app.route("/optimize", methods=["POST"])
+def optimize():
+    global global_df
+    if global_df is None:
+        return "Error: no historical data loaded, upload CSV first", 400
+
+    conf = request.get_json(force=True)
+    if not isinstance(conf, dict):
+        conf = json.loads(conf)
+    initial_cap = conf.get("backtest").get("capital")
+    pos_size = conf.get("backtest").get("positionSize")
+    comm = conf.get("backtest").get("commission")
+    opt = conf.get("optimize", {})
+
+    try:
+        results = run_optimizer(global_df, conf, opt.get("parameters", []), initial_capital=initial_cap,
+                                allocation_fraction=pos_size, commission=comm,
+                                method=opt.get("method", "grid"), samples=opt.get("samples", 1000),
+                                seed=opt.get("seed", 0), top_k=opt.get("top", 10), rank=opt.get("rank", "sharpe"))
+    except RuntimeError as e:
+        return f"Error: {e}", 400
+    return {"results": results}
+
+
+@app.route("/live/replay", methods=["POST"])
+def live_replay():
+    global global_df
+    if global_df is None:
+        return "Error: no historical data loaded, upload CSV first", 400
+
+    conf = request.get_json(force=True)
+    if not isinstance(conf, dict):
+        conf = json.loads(conf)
+    live = conf.get("live", {})
+
+    # the loaded bars (CSV upload, store or aggregated ticks) replayed through the live pipeline, speed 0 as
+    # fast as possible; rows without a date (NaT) are pushed right away
+    if "date" in global_df.columns:
+        times = pd.to_datetime(global_df["date"], format="ISO8601", errors="coerce").to_numpy(dtype="datetime64[ns]").astype(np.int64)
+    else:
+        times = np.zeros(len(global_df), dtype=np.int64)
+    rows = {"time": times}
+    rows.update({col: global_df[col].to_numpy(dtype=float)
+                 for col in ['open', 'high', 'low', 'close', 'volume'] if col in global_df.columns})
+    try:
+        res = qz.LiveReplay(rows, conf, speed=float(live.get("speed", 0)),
+                            capacity=int(live.get("capacity", 65536)))
+    except RuntimeError as e:
+        return f"Error: {e}", 400
+    res["signals"] = res["signals"].tolist()
+    return res
+
+
 @app.route("/indicators/<indicator>", methods=["POST"])
 def indicators(indicator):
     global global_df
@@ -87,46 +212,47 @@ def indicators(indicator):
 
     data = request.get_json(force=True)
     if indicator == "SMA":
-        period = data.get("period")
-        price = data.get("price").lower()
-        return str(qz.SMA(global_df[price], period))
+        spec = {"indicator": "SMA", "period": data.get("period")}
     elif indicator == "EMA":
-        period = data.get("period")
-        price = data.get("price").lower()
-        return str(qz.EMA(global_df[price], period))
+        spec = {"indicator": "EMA", "period": data.get("period")}
     elif indicator == "RSI":
-        period = data.get("period")
-        price = data.get("price").lower()
-        return str(qz.RSI(global_df[price], period))
+        spec = {"indicator": "RSI", "period": data.get("period")}
     elif indicator == "ATR":
-        period = data.get("period")
-        price = data.get("price").lower()
-        return str(qz.ATR(global_df["high"], global_df["low"], global_df[price], period))
+        spec = {"indicator": "ATR", "period": data.get("period")}
     elif indicator == "MACD":
-        fast = data.get("fast")
-        slow = data.get("slow")
-        price = data.get("price").lower()
-        return str(qz.MACD(global_df[price], fast, slow))
+        spec = {"indicator": "MACD", "fast": data.get("fast"), "slow": data.get("slow")}
     elif indicator == "VWMA":
-        period = data.get("period")
-        price = data.get("price").lower()
-        return str(qz.VWMA(global_df[price], global_df["volume"], period))
+        spec = {"indicator": "VWMA", "period": data.get("period")}
     elif indicator == "BollingerBands":
-        period = data.get("period")
-        multiplier = data.get("multiplier")
-        price = data.get("price").lower()
-        return str(qz.BollingerBands(global_df[price], period, multiplier))
+        spec = {"indicator": "BollingerBands", "period": data.get("period"), "multiplier": data.get("multiplier")}
     elif indicator == "Momentum":
-        period = data.get("period")
-        price = data.get("price").lower()
-        return str(qz.Momentum(global_df[price], period))
+        spec = {"indicator": "Momentum", "period": data.get("period")}
     elif indicator == "WMA":
-        period = data.get("period")
-        w = data.get("weights").lower()
-        price = data.get("price").lower()
-        return str(qz.WMA(global_df[price], w, period))
-    return f"Error: unknown indicator '{indicator}'", 400
+        spec = {"indicator": "WMA", "period": data.get("period"), "weights": data.get("weights").lower()}
+    elif indicator in ["Donchian", "WilliamsR", "Aroon"]:
+        spec = {"indicator": indicator, "period": data.get("period")}
+    elif indicator == "Stochastic":
+        spec = {"indicator": "Stochastic", "period": data.get("period"), "smoothing": data.get("smoothing", 3)}
+    else:
+        return f"Error: unknown indicator '{indicator}'", 400
+
+    # served from the result cache shared with the backtests on the same data; Donchian and Aroon read the
+    # highs and lows, not a price column
+    price = (data.get("price") or "close").lower()
+    extra = [global_df[c].to_numpy(dtype=float) if c in global_df.columns else None
+             for c in ["high", "low", "volume"]]
+    values = indicator_cache.get("global", dataset_version, spec, price,
+                                 global_df[price].to_numpy(dtype=float), *extra)
+    # the chart draws one line per node, the one the node reads
+    if indicator in ["Donchian", "Aroon"]:
+        try:
+            values = values[line_row(indicator, data.get("line"))]
+        except ValueError as e:
+            return f"Error: {e}", 400
+    return str(values.tolist())
+
 
+LoadStore()
 
 if __name__ == '__main__':
     app.run(host='0.0.0.0', port=10000)
@@ -3,238 +3,128 @@ import numpy as np
 import json
 import quantzlib as qz
 
+# lines of the multi-row indicators, in row order; a node's "Line" picks one, the first by default
+LINES = {
+    "BollingerBands": ["middle", "upper", "lower"],
+    "Donchian": ["middle", "upper", "lower"],
+    "Stochastic": ["k", "d"],
+    "Aroon": ["up", "down"],
+}
 
-def evaluate_operator(lhs, operator_label, rhs):
-    try:
-        lhs_val = float(lhs)
-        rhs_val = float(rhs)
-    except Exception:
-        return False
 
-    mapping = {
-        "More Than or Equals To (≥)": lambda a, b: a >= b,
-        ">=": lambda a, b: a >= b,
-        "Less Than or Equals To (≤)": lambda a, b: a <= b,
-        "<=": lambda a, b: a <= b,
-        "Equals (=)": lambda a, b: a == b,
-        "==": lambda a, b: a == b,
-        "Not Equals (≠)": lambda a, b: a != b,
-        "≠": lambda a, b: a != b,
-        "More Than (>)": lambda a, b: a > b,
-        ">": lambda a, b: a > b,
-        "Less Than (<)": lambda a, b: a < b,
-        "<": lambda a, b: a < b,
-    }
-
-    op = mapping.get(operator_label)
-    if not op:
-        return False
-    return op(lhs_val, rhs_val)
+def line_row(label, line):
+    line = (line or "").lower()
+    if not line:
+        return 0
+    if line not in LINES.get(label, []):
+        raise ValueError(f"Unknown line '{line}' of {label}")
+    return LINES[label].index(line)
 
 
 class DAGStrategy:
-    def __init__(self, dag_json, df):
+    def __init__(self, dag_json, df, cache=None, dataset="global", version=0):
         self.nodes = {n['id']: n for n in dag_json["nodes"]}
         self.edges = dag_json["edges"]
-        self.df = df.copy()
+        # shallow: the added indicator columns stay on this frame, the price columns (views of a mapped
+        # store after a restart) are not copied
+        self.df = df.copy(deep=False)
+        # qz.IndicatorCache shared with the other requests on the same data, None computes the columns here
+        self.cache = cache
+        self.dataset = dataset
+        self.version = version
         # adjacency list
         self.adj = {n["id"]: [] for n in dag_json["nodes"]}
         for edge in self.edges:
             self.adj[edge['src']].append(edge["dest"])
 
     def _precalc_indicators(self):
+        # (node, spec) of every indicator node, grouped by the price column it reads
+        jobs = {}
         for node_id, node in self.nodes.items():
             if node["data"].get("kind") == "indicator":
                 label = node["data"]["label"]
-                if label == "RSI":
+                price_col = (node["data"].get("Price") or "Close").lower()
+                if label in ["RSI", "SMA", "EMA", "ATR", "VWMA", "Momentum", "Donchian", "WilliamsR", "Aroon"]:
                     period = int(node["data"].get("Period"))
-                    price_col = node["data"].get("Price").lower()
+                    spec = {"indicator": label, "period": period}
                     col_name = f"{label}_{period}_{price_col}_{node_id}"
-
-                    self.df[col_name] = qz.RSI(self.df[price_col], period)
-                    node["temp_col"] = col_name
-                elif label == "SMA":
-                    period = int(node["data"].get("Period"))
-                    price_col = node["data"].get("Price").lower()
-                    col_name = f"{label}_{period}_{price_col}_{node_id}"
-
-                    self.df[col_name] = qz.SMA(self.df[price_col], period)
-                    node["temp_col"] = col_name
-                elif label == "EMA":
-                    period = int(node["data"].get("Period"))
-                    price_col = node["data"].get("Price").lower()
-                    col_name = f"{label}_{period}_{price_col}_{node_id}"
-
-                    self.df[col_name] = qz.EMA(self.df[price_col], period)
-                    node["temp_col"] = col_name
-                elif label == "ATR":
-                    period = int(node["data"].get("Period"))
-                    price_col = node["data"].get("Price").lower()
-                    col_name = f"{label}_{period}_{price_col}_{node_id}"
-
-                    self.df[col_name] = qz.ATR(
-                        self.df["high"], self.df["low"], self.df[price_col], period)
-                    node["temp_col"] = col_name
                 elif label == "MACD":
                     fast = int(node["data"].get("Fast"))
                     slow = int(node["data"].get("Slow"))
-                    price_col = node["data"].get("Price").lower()
+                    spec = {"indicator": label, "fast": fast, "slow": slow}
                     col_name = f"{label}_{fast}_{slow}_{price_col}_{node_id}"
-
-                    self.df[col_name] = qz.MACD(self.df[price_col], fast, slow)
-                    node["temp_col"] = col_name
-                elif label == "VWMA":
+                elif label == "Stochastic":
                     period = int(node["data"].get("Period"))
-                    price_col = node["data"].get("Price").lower()
-                    col_name = f"{label}_{period}_{price_col}_{node_id}"
-
-                    self.df[col_name] = qz.VWMA(
-                        self.df[price_col], self.df["volume"], period)
-                    node["temp_col"] = col_name
+                    smoothing = int(node["data"].get("Smoothing", 3))
+                    spec = {"indicator": label, "period": period, "smoothing": smoothing}
+                    col_name = f"{label}_{period}_{smoothing}_{price_col}_{node_id}"
                 elif label == "BollingerBands":
                     period = int(node["data"].get("Period"))
                     mulp = float(node["data"].get("Multiplier"))
-                    price_col = node["data"].get("Price").lower()
+                    spec = {"indicator": label, "period": period, "multiplier": mulp}
                     col_name = f"{label}_{period}_{price_col}_{node_id}"
-
-                    self.df[col_name] = qz.BollingerBands(
-                        self.df[price_col], period, mulp)
-                    node["temp_col"] = col_name
-                elif label == "Momentum":
-                    period = int(node["data"].get("Period"))
-                    price_col = node["data"].get("Price").lower()
-                    col_name = f"{label}_{period}_{price_col}_{node_id}"
-
-                    self.df[col_name] = qz.Momentum(self.df[price_col], period)
-                    node["temp_col"] = col_name
                 elif label == "WMA":
                     period = int(node["data"].get("Period"))
-                    price_col = node["data"].get("Price").lower()
                     weights = node["data"].get("Weights").lower()
+                    spec = {"indicator": label, "period": period, "weights": weights}
                     col_name = f"{label}_{period}_{price_col}_{weights}_{node_id}"
-
-                    self.df[col_name] = qz.WMA(
-                        self.df[price_col], weights, period)
-                    node["temp_col"] = col_name
-
-    def get_signal(self, current_row_index):
-        """Traverse DAG from Start and return 'Buy' or 'Sell' or None.
-
-        The traversal is depth-first but we only fire an action node if the input boolean reaching it is True.
-        """
-        start_node = next((n for n in self.nodes.values()
-                          if n["data"]["label"] == "Start"), None)
-        if not start_node:
-            return None
-
-        stack = [(start_node, None)]
-
-        while stack:
-            curr_node, input_val = stack.pop()
-            node_type = curr_node["data"].get("kind")
-            node_id = curr_node["id"]
-            output_val = input_val
-
-            if node_type == "indicator":
-                col = curr_node.get("temp_col")
-                if col is None or col not in self.df.columns:
-                    output_val = None
-                else:
-                    output_val = self.df.at[current_row_index, col]
-
-            elif node_type == "operator":
-                threshold = curr_node["data"].get("value")
-                label = curr_node["data"].get("label")
-                output_val = evaluate_operator(input_val, label, threshold)
-
-            elif node_type == "logic":
-                label = curr_node["data"].get("label")
-                # Only pass forward when the logic node matches the boolean input
-                if (label == "TRUE" and input_val is True) or (label == "FALSE" and input_val is False):
-                    output_val = True
                 else:
-                    # do not propagate to children
                     continue
-
-            elif node_type == "action":
-                # Only trigger action if the input boolean is True
-                if output_val is True:
-                    return curr_node["data"].get("label")
-                else:
-                    continue
-
-            # control nodes fall through (no value change)
-            children_ids = self.adj.get(node_id, [])
-            for child_id in children_ids:
-                # push child with the current output_val
-                stack.append((self.nodes[child_id], output_val))
-
-        return None
-
-
-def run_backtest(df, dag_json, initial_capital, allocation_fraction, commission):
+                jobs.setdefault(price_col, []).append((node, spec, col_name))
+
+        extra = [self.df[c].to_numpy(dtype=float) if c in self.df.columns else None
+                 for c in ["high", "low", "volume"]]
+        for price_col, group in jobs.items():
+            prices = self.df[price_col].to_numpy(dtype=float)
+            if self.cache is not None:
+                values = [self.cache.get(self.dataset, self.version, spec, price_col, prices, *extra)
+                          for _, spec, _ in group]
+            else:
+                # one pass over the column for all of its nodes, shared EMAs/sums are computed once
+                values = qz.Pipeline(prices, [spec for _, spec, _ in group], *extra)
+            for (node, spec, col_name), value in zip(group, values):
+                # BollingerBands and Donchian are 3 x N (middle, upper, lower), Stochastic (%K, %D) and Aroon
+                # (up, down) 2 x N; the node's value is the row of its line
+                row = line_row(node["data"]["label"], node["data"].get("Line"))
+                self.df[col_name] = value[row] if value.ndim == 2 else value
+                node["temp_col"] = col_name
+
+
+def run_backtest(df, dag_json, initial_capital, allocation_fraction, commission, cache=None, dataset="global", version=0):
     """Run backtest.
     - allocation_fraction: fraction of current equity to allocate on each entry (0.1 -> 10%).
     - commission: fraction of trade value taken as commission.
+    - cache: optional qz.IndicatorCache, indicator columns are looked up under (dataset, version).
     """
-    strategy = DAGStrategy(dag_json=dag_json, df=df)
+    strategy = DAGStrategy(dag_json=dag_json, df=df, cache=cache, dataset=dataset, version=version)
     strategy._precalc_indicators()
 
-    commission = float(commission)
-    allocation_fraction = float(allocation_fraction)
-
-    cash = float(initial_capital)
-    # quantity of shares currently held (start with zero)
-    position = 0.0
-    entry_price = None
-    equity_curve = []
-    trade_log = []
-
-    # Iterate using row index to access precomputed indicator columns
-    for i, row in df.iterrows():
-        curr_price = row["close"]
-        # use actual date column if present
-        date = row.get("date", None) if "date" in df.columns else row.name
-
-        equity = cash + (position * curr_price)
-        equity_curve.append({"Date": date, "Equity": equity})
-
-        signal = strategy.get_signal(i)
-
-        # BUY: only if no open position
-        if signal == "Buy" and position == 0:
-            max_amt = equity * allocation_fraction
-            qty = max_amt / curr_price if curr_price > 0 else 0
-            cost = qty * curr_price
-            comm_cost = cost * commission
-
-            if cash >= (cost + comm_cost) and qty > 0:
-                cash -= (cost + comm_cost)
-                position = qty
-                entry_price = curr_price
-                trade_log.append({
-                    'Date': date, 'Type': 'BUY', 'Price': curr_price,
-                    'Qty': qty, 'Comm': comm_cost, 'Balance': cash
-                })
-
-        # SELL: only if position > 0
-        elif signal == 'Sell' and position > 0:
-            revenue = position * curr_price
-            comm_cost = revenue * commission
-            cash += (revenue - comm_cost)
-
-            pnl = (curr_price - entry_price) * position - \
-                comm_cost if entry_price is not None else None
-
-            trade_log.append({
-                'Date': date, 'Type': 'SELL', 'Price': curr_price,
-                'Qty': position, 'Comm': comm_cost, 'Balance': cash, 'PnL': pnl
-            })
-            position = 0.0
-            entry_price = None
-
-    equity_df = pd.DataFrame(equity_curve)
-    trades_df = pd.DataFrame(trade_log)
+    columns = {node_id: strategy.df[node["temp_col"]].to_numpy(dtype=float)
+               for node_id, node in strategy.nodes.items() if "temp_col" in node}
+
+    # the DAG is evaluated and the Buy/Sell state machine run for every bar in quantzlib
+    res = qz.Backtest(df["close"].to_numpy(dtype=float), dag_json, columns,
+                      float(initial_capital), float(allocation_fraction), float(commission))
+
+    # use actual date column if present
+    dates = df["date"].to_numpy() if "date" in df.columns else df.index.to_numpy()
+    equity_df = pd.DataFrame({"Date": dates, "Equity": res["equity"]})
+
+    trades = res["trades"]
+    if len(trades["bar"]) == 0:
+        return equity_df, pd.DataFrame()
+
+    trades_df = pd.DataFrame({
+        'Date': dates[trades["bar"]],
+        'Type': np.where(trades["type"] > 0, 'BUY', 'SELL'),
+        'Price': trades["price"],
+        'Qty': trades["qty"],
+        'Comm': trades["comm"],
+        'Balance': trades["balance"],
+    })
+    # PnL only exists once a position has been closed
+    if (trades["type"] < 0).any():
+        trades_df['PnL'] = trades["pnl"]
     return equity_df, trades_df
 
 
@@ -242,32 +132,56 @@ def calculate_metrics(equity_df, trades_df):
     if equity_df.empty:
         return {}
 
-    initial = equity_df['Equity'].iloc[0]
-    final = equity_df['Equity'].iloc[-1]
-
-    total_return = (final - initial) / initial * 100
-    equity_df['Returns'] = equity_df['Equity'].pct_change()
+    # one pass in quantzlib, the per-bar columns are kept on the frame for the equity chart
+    equity = equity_df['Equity'].to_numpy(dtype=float)
+    curves = qz.EquityCurves(equity)
+    equity_df['Returns'] = curves["returns"]
+    equity_df['Peak'] = curves["peak"]
+    equity_df['Drawdown'] = curves["drawdown"]
 
-    mean_ret = equity_df['Returns'].mean()
-    std_ret = equity_df['Returns'].std()
-    sharpe = (mean_ret / std_ret) * (252 ** 0.5) if std_ret != 0 else 0
-
-    equity_df['Peak'] = equity_df['Equity'].cummax()
-    equity_df['Drawdown'] = (equity_df['Equity'] -
-                             equity_df['Peak']) / equity_df['Peak']
-    max_dd = equity_df['Drawdown'].min() * 100
-
-    win_rate = 0
+    pnl = None
     if not trades_df.empty and 'PnL' in trades_df.columns:
-        closed_trades = trades_df.dropna(subset=['PnL'])
-        wins = len(closed_trades[closed_trades['PnL'] > 0])
-        total_trades = len(closed_trades)
-        win_rate = (wins / total_trades * 100) if total_trades > 0 else 0
+        pnl = trades_df['PnL'].to_numpy(dtype=float)
+    m = qz.Metrics(equity, pnl)
 
+    # infinite without losing trades, which JSON cannot carry
+    profit_factor = float(m["profit_factor"])
     return {
-        "Total Return (%)": round(float(total_return), 2),
-        "Sharpe Ratio": round(float(sharpe), 2),
-        "Max Drawdown (%)": round(float(max_dd), 2),
-        "Win Rate (%)": round(round(win_rate, 2), 2),
-        "Final Equity": round(float(final), 2)
-    }
\ No newline at end of file
+        "Total Return (%)": round(float(m["total_return"]), 2),
+        "Sharpe Ratio": round(float(m["sharpe"]), 2),
+        "Sortino Ratio": round(float(m["sortino"]), 2),
+        "Max Drawdown (%)": round(float(m["max_drawdown"]), 2),
+        "Max DD Duration (bars)": int(m["max_drawdown_duration"]),
+        "Win Rate (%)": round(float(m["win_rate"]), 2),
+        "Profit Factor": round(profit_factor, 2) if np.isfinite(profit_factor) else "inf",
+        "Final Equity": round(float(m["final_equity"]), 2)
+    }
+
+
+def run_optimizer(df, dag_json, parameters, initial_capital, allocation_fraction, commission,
+                  method="grid", samples=1000, seed=0, top_k=10, rank="sharpe"):
+    """Search strategy parameters in parallel in quantzlib.
+    - parameters: [{"node": id, "param": "Period" | "Fast" | "Slow" | "Smoothing" | "Multiplier" | "value", "values": [...]}
+      or {"min", "max", "step"} instead of "values"; {"param": "allocation", ...} tunes the allocation fraction.
+    - rank: "return", "sharpe", "drawdown" or "win_rate".
+    Returns the best `top_k` candidates, each with its parameter values and calculate_metrics style metrics.
+    """
+    data = {col: df[col].to_numpy(dtype=float)
+            for col in ["open", "high", "low", "close", "volume"] if col in df.columns}
+    top = qz.Optimize(data, dag_json, parameters, float(initial_capital), float(allocation_fraction),
+                      float(commission), method, int(samples), int(seed), int(top_k), rank)
+
+    results = []
+    for cand in top:
+        m = cand["metrics"]
+        results.append({
+            "params": [dict(p, value=float(v)) for p, v in zip(parameters, cand["values"])],
+            "metrics": {
+                "Total Return (%)": round(float(m["total_return"]), 2),
+                "Sharpe Ratio": round(float(m["sharpe"]), 2),
+                "Max Drawdown (%)": round(float(m["max_drawdown"]), 2),
+                "Win Rate (%)": round(float(m["win_rate"]), 2),
+                "Final Equity": round(float(m["final_equity"]), 2)
+            }
+        })
+    return results
\ No newline at end of file
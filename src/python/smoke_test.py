@@ -0,0 +1,106 @@
+"""
+ @file smoke_test.py
+ @license This file is licensed under the GNU GENERAL PUBLIC LICENSE Version 3, 29 June 2007. You may obtain a copy of this license at https://www.gnu.org/licenses/gpl-3.0.en.html.
+ @author Tushar Chaurasia (Dark-CodeX)
+"""
+
+import numpy as np
+import quantzlib as qz
+
+
+def raises(fn, *args, **kwargs):
+    try:
+        fn(*args, **kwargs)
+    except RuntimeError:
+        return True
+    return False
+
+
+def test_out_buffers():
+    rng = np.random.default_rng(7)
+    prices = 100 * np.exp(np.cumsum(0.01 * rng.standard_normal(2000)))
+    highs, lows = prices * 1.01, prices * 0.99
+
+    # a separate buffer is filled with the vector form's values
+    out = np.empty_like(prices)
+    assert qz.RSI(prices, 14, out=out) is out
+    assert np.array_equal(qz.RSI(prices, 14), out, equal_nan=True)
+
+    # writing over an input the kernel still reads is refused, whole or in part
+    x = prices.copy()
+    assert raises(qz.RSI, x, 14, out=x)
+    assert raises(qz.MACD, x, 12, 26, out=x)
+    assert raises(qz.ATR, highs, lows, x, 14, out=x)
+    kd = np.empty(2 * len(x))
+    assert qz.Stochastic(highs, lows, x, 14, 3, out=kd) is kd
+    both = np.empty(2 * len(x))
+    both[:len(x)] = x
+    assert raises(qz.Stochastic, highs, lows, both[:len(x)], 14, 3, out=both)
+    buf = np.concatenate([prices, [0.0]])
+    assert raises(qz.SMA, buf[:-1], 10, out=buf[1:])
+    assert np.array_equal(x, prices)
+
+    cols = [np.empty(len(x)), np.empty(len(x))]
+    assert qz.Pipeline(x, [{"indicator": "SMA", "period": 5}, {"indicator": "EMA", "period": 5}], out=cols) == [True, True]
+    assert raises(qz.Pipeline, x, [{"indicator": "SMA", "period": 5}], out=[x])
+
+
+def test_futures():
+    rng = np.random.default_rng(11)
+    prices = 100 * np.exp(np.cumsum(0.01 * rng.standard_normal(5000)))
+
+    # waited on, polled and collected twice, the result matches the synchronous call
+    fut = qz.IndicatorAsync(prices, {"indicator": "SMA", "period": 20})
+    assert fut.wait() and fut.done()
+    assert np.array_equal(fut.result(), qz.SMA(prices, 20), equal_nan=True)
+    assert np.array_equal(fut.result(), qz.SMA(prices, 20), equal_nan=True)
+    assert fut.wait(0.0)
+
+    # a future dropped before it finishes waits for its task, which still reads the (now unreferenced) prices
+    qz.IndicatorAsync(100 * np.exp(np.cumsum(0.01 * rng.standard_normal(200000))), {"indicator": "EMA", "period": 50})
+    assert raises(qz.IndicatorAsync, prices, {"indicator": "NoSuchIndicator", "period": 5})
+
+    dag = {"nodes": [{"id": "s", "data": {"label": "Start"}},
+                     {"id": "i", "data": {"kind": "indicator", "label": "SMA"}},
+                     {"id": "o", "data": {"kind": "operator", "label": ">", "value": 100}},
+                     {"id": "b", "data": {"kind": "action", "label": "Buy"}}],
+           "edges": [{"src": "s", "dest": "i"}, {"src": "i", "dest": "o"}, {"src": "o", "dest": "b"}]}
+    columns = {"i": qz.SMA(prices, 20)}
+    res = qz.BacktestAsync(prices, dag, columns, 10000.0, 0.5, 0.001).result()
+    assert np.array_equal(res["equity"], qz.Backtest(prices, dag, columns, 10000.0, 0.5, 0.001)["equity"])
+    assert raises(qz.BacktestAsync, prices, dag, {"i": columns["i"][:-1]}, 10000.0, 0.5, 0.001)
+    bad = dict(dag, edges=dag["edges"] + [{"src": "b", "dest": "nowhere"}])
+    assert raises(qz.BacktestAsync, prices, bad, columns, 10000.0, 0.5, 0.001)
+
+
+def test_tick_bars():
+    rng = np.random.default_rng(3)
+    times = 1_700_000_000_000_000_000 + np.cumsum(rng.integers(0, 5_000_000, 20000))
+    prices = 100 * np.exp(np.cumsum(0.0005 * rng.standard_normal(len(times))))
+    sizes = rng.integers(1, 50, len(times)).astype(float)
+
+    # AggregateTicks gives the bars BarAggregator closes tick by tick, for every rule
+    for by, threshold in [("time", 1e9), ("tick", 100), ("volume", 2500), ("dollar", 250000)]:
+        batch = qz.AggregateTicks(times, prices, sizes, by, threshold)
+        agg = qz.BarAggregator(by, threshold)
+        handed = []
+        agg.subscribe(handed.append)
+        closed = sum(agg.update(int(t), float(p), float(s)) for t, p, s in zip(times, prices, sizes))
+        closed += agg.flush()
+        incremental = agg.take()
+        assert closed == len(batch["time"]) == len(handed)
+        for col in ("time", "open", "high", "low", "close", "volume", "vwap", "ticks"):
+            assert np.array_equal(batch[col], incremental[col])
+        assert [b["close"] for b in handed] == batch["close"].tolist()
+        assert batch["ticks"].sum() == len(times)
+
+    # a time interval under 1 ns would silently make one bar per timestamp
+    assert raises(qz.AggregateTicks, times, prices, sizes, "time", 0.5)
+    assert raises(qz.BarAggregator, "time", 0.5)
+
+
+if __name__ == "__main__":
+    test_out_buffers()
+    test_futures()
+    test_tick_bars()
+    print("smoke tests passed")
@@ -7,47 +7,169 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 #include <pybind11/numpy.h>
-extern "C"
-{
-#include "./core/simd_math/simd_math.h"
-}
+#include "./core/simd_math/parallel.hh"
 #include "./core/indicators/indicators.hh"
+#include "./core/indicators/stream.hh"
+#include "./core/indicators/universe.hh"
+#include "./core/indicators/cache.hh"
+#include "./core/indicators/pipeline.hh"
+#include "./core/indicators/scan.hh"
+#include "./core/strategy/strategy.hh"
+#include "./core/backtest/backtest.hh"
+#include "./core/optimizer/optimizer.hh"
+#include "./core/store/store.hh"
+#include "./core/ingest/ingest.hh"
+#include "./core/bars/bars.hh"
+#include "./core/live/live.hh"
+
+#include <string>
+#include <unordered_map>
+#include <type_traits>
+#include <future>
+#include <optional>
+#include <chrono>
+#include <cstdint>
+#include <initializer_list>
 
 namespace py = pybind11;
 
-double py_vector_sum(py::array_t<double, py::array::c_style | py::array::forcecast> arr)
+// Runs `fn` with the GIL released, so other Python threads (concurrent API requests) keep running. The NumPy
+// buffers it reads must be pinned by the caller's arguments and viewed beforehand, `fn` must not touch a
+// Python object
+template <typename F>
+auto py_nogil(F &&fn)
+{
+    py::gil_scoped_release release;
+    return fn();
+}
+
+// Result of a task started on the native pool from Python. The task runs without the GIL and returns a finisher
+// turning its output into Python objects, run by `result` with the GIL held. `inputs` pins the NumPy buffers the
+// task reads until it has finished
+class py_future
+{
+public:
+    using finisher = std::function<py::object()>;
+
+    py_future(std::future<finisher> &&pending, py::object inputs) : pending(pending.share()), inputs(std::move(inputs)) {}
+    py_future(py_future &&) = default;
+
+    ~py_future()
+    {
+        // a dropped future still has to outlive its task, which reads the pinned inputs
+        if (pending.valid())
+            py_nogil([this]
+                     { pending.wait(); });
+    }
+
+    bool done() const
+    {
+        return !pending.valid() || pending.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
+
+    // true once the task has finished, false if `timeout` (seconds) passed first. Every wait is on a copy of the
+    // shared state taken with the GIL held, so `result` on another thread may collect it meanwhile
+    bool wait(std::optional<double> timeout) const
+    {
+        if (!pending.valid())
+            return true;
+        const std::shared_future<finisher> task = pending;
+        return py_nogil([&]
+                        {
+                            if (!timeout)
+                            {
+                                task.wait();
+                                return true;
+                            }
+                            return task.wait_for(std::chrono::duration<double>(*timeout)) == std::future_status::ready; });
+    }
+
+    // waits for the task, then returns its result or raises its error, the same every time it is called
+    py::object result()
+    {
+        if (pending.valid())
+        {
+            const std::shared_future<finisher> task = pending;
+            py_nogil([&]
+                     { task.wait(); });
+        }
+        // another thread may have collected it while the GIL was released
+        if (pending.valid())
+        {
+            try
+            {
+                value = pending.get()();
+            }
+            catch (...)
+            {
+                error = std::current_exception();
+            }
+            pending = std::shared_future<finisher>();
+            inputs = py::none();
+        }
+        if (error)
+            std::rethrow_exception(error);
+        return value;
+    }
+
+private:
+    std::shared_future<finisher> pending;
+    py::object inputs, value = py::none();
+    std::exception_ptr error;
+};
+
+// float32 arrays (C-contiguous) run the float kernels, anything else is converted to float64. `threads` is 0 for
+// the automatic choice (the whole pool once the array is far larger than the caches), 1 for the calling thread only
+template <typename T>
+double py_vector_sum(py::array_t<T, py::array::c_style | py::array::forcecast> arr, std::size_t threads)
 {
     auto buf = arr.request();
-    return vector_sum(static_cast<double *>(buf.ptr), buf.shape[0]);
+    std::span<const T> vec(static_cast<const T *>(buf.ptr), buf.shape[0]);
+    return py_nogil([&]
+                    { return core::simd_math::parallel::sum(vec, threads); });
 }
 
-double py_vector_mean(py::array_t<double, py::array::c_style | py::array::forcecast> arr)
+template <typename T>
+double py_vector_mean(py::array_t<T, py::array::c_style | py::array::forcecast> arr, std::size_t threads)
 {
     auto buf = arr.request();
-    return vector_mean(static_cast<double *>(buf.ptr), buf.shape[0]);
+    std::span<const T> vec(static_cast<const T *>(buf.ptr), buf.shape[0]);
+    return py_nogil([&]
+                    { return core::simd_math::parallel::mean(vec, threads); });
 }
 
-double py_vector_variance(py::array_t<double, py::array::c_style | py::array::forcecast> arr)
+template <typename T>
+double py_vector_variance(py::array_t<T, py::array::c_style | py::array::forcecast> arr, std::size_t threads)
 {
     auto buf = arr.request();
-    return vector_variance(static_cast<double *>(buf.ptr), buf.shape[0]);
+    std::span<const T> vec(static_cast<const T *>(buf.ptr), buf.shape[0]);
+    return py_nogil([&]
+                    { return core::simd_math::parallel::variance(vec, threads); });
 }
 
-double py_vector_std_deviation(py::array_t<double, py::array::c_style | py::array::forcecast> arr)
+template <typename T>
+double py_vector_std_deviation(py::array_t<T, py::array::c_style | py::array::forcecast> arr, std::size_t threads)
 {
     auto buf = arr.request();
-    return vector_std_deviation(static_cast<double *>(buf.ptr), buf.shape[0]);
+    std::span<const T> vec(static_cast<const T *>(buf.ptr), buf.shape[0]);
+    return py_nogil([&]
+                    { return core::simd_math::parallel::std_deviation(vec, threads); });
 }
 
-double py_vector_multiply(py::array_t<double, py::array::c_style | py::array::forcecast> arr)
+template <typename T>
+double py_vector_multiply(py::array_t<T, py::array::c_style | py::array::forcecast> arr, std::size_t threads)
 {
     auto buf = arr.request();
-    return vector_multiply(static_cast<double *>(buf.ptr), buf.shape[0]);
+    std::span<const T> vec(static_cast<const T *>(buf.ptr), buf.shape[0]);
+    return py_nogil([&]
+                    { return core::simd_math::parallel::multiply(vec, threads); });
 }
 
+template <typename T>
 double py_vector_dot_product(
-    py::array_t<double, py::array::c_style | py::array::forcecast> a,
-    py::array_t<double, py::array::c_style | py::array::forcecast> b)
+    py::array_t<T, py::array::c_style | py::array::forcecast> a,
+    py::array_t<T, py::array::c_style | py::array::forcecast> b,
+    std::size_t threads)
 {
     auto buf_a = a.request();
     auto buf_b = b.request();
@@ -55,31 +177,1558 @@ double py_vector_dot_product(
     {
         throw std::runtime_error("Input arrays must have the same length");
     }
-    return vector_dot_product(
-        static_cast<double *>(buf_a.ptr),
-        static_cast<double *>(buf_b.ptr),
-        buf_a.shape[0]);
+    std::span<const T> vec1(static_cast<const T *>(buf_a.ptr), buf_a.shape[0]), vec2(static_cast<const T *>(buf_b.ptr), buf_b.shape[0]);
+    return py_nogil([&]
+                    { return core::simd_math::parallel::dot_product(vec1, vec2, threads); });
+}
+
+// Views a contiguous 1-D NumPy buffer without copying it
+template <typename T>
+std::span<const T> py_span(const py::array_t<T, py::array::c_style | py::array::forcecast> &arr)
+{
+    auto buf = arr.request();
+    if (buf.ndim != 1)
+    {
+        throw std::runtime_error("Input array must be 1-dimensional");
+    }
+    return std::span<const T>(static_cast<const T *>(buf.ptr), buf.shape[0]);
+}
+
+// Hands the vector's buffer to NumPy, the array owns it from now on (enums are exposed as their underlying type)
+template <typename T>
+auto py_as_array(std::vector<T> &&vec, std::vector<py::ssize_t> shape)
+{
+    using U = typename std::conditional_t<std::is_enum_v<T>, std::underlying_type<T>, std::type_identity<T>>::type;
+    auto *owner = new std::vector<T>(std::move(vec));
+    py::capsule free_when_done(owner, [](void *p)
+                               { delete static_cast<std::vector<T> *>(p); });
+    return py::array_t<U>(shape, reinterpret_cast<const U *>(owner->data()), free_when_done);
+}
+
+template <typename T>
+auto py_as_array(std::vector<T> &&vec)
+{
+    py::ssize_t len = vec.size();
+    return py_as_array(std::move(vec), {len});
+}
+
+py::array_t<double> py_WEIGHTS(const std::string &type, std::size_t n)
+{
+    return py_as_array(core::indicators::WEIGHTS(type.c_str(), n));
+}
+
+// Whether two buffers share any byte
+bool py_overlaps(const void *a, const std::size_t &a_bytes, const void *b, const std::size_t &b_bytes)
+{
+    const std::uintptr_t x = reinterpret_cast<std::uintptr_t>(a), y = reinterpret_cast<std::uintptr_t>(b);
+    return a_bytes != 0 && b_bytes != 0 && x < y + b_bytes && y < x + a_bytes;
+}
+
+// Caller-provided result buffer: a writable C-contiguous array of the input's dtype with `len` elements that
+// shares no memory with `inputs`, the kernels still read an input after writing the results before it
+template <typename T>
+std::span<T> py_out_span(py::object out, std::size_t len, std::initializer_list<std::span<const T>> inputs)
+{
+    if (!py::isinstance<py::array_t<T, py::array::c_style>>(out))
+    {
+        throw std::runtime_error("out must be a C-contiguous array of the input's dtype");
+    }
+    auto arr = out.cast<py::array_t<T, py::array::c_style>>();
+    if (!arr.writeable() || (std::size_t)arr.size() != len)
+    {
+        throw std::runtime_error("out must be writable and hold one element per result value");
+    }
+    for (const std::span<const T> &in : inputs)
+    {
+        if (py_overlaps(arr.data(), len * sizeof(T), in.data(), in.size_bytes()))
+        {
+            throw std::runtime_error("out must not share memory with an input");
+        }
+    }
+    return std::span<T>(arr.mutable_data(), len);
+}
+
+// `out` once a span form filled it, an empty array (like the vector forms) when the input was invalid
+template <typename T>
+py::object py_filled(const bool &ok, py::object out)
+{
+    if (ok)
+        return out;
+    return py::array_t<T>(0);
+}
+
+// Batch indicators for float64 and (C-contiguous) float32 arrays, the result has the dtype of the input. With
+// `out` the result is written into that array instead of a new one, so a caller can reuse its buffers. The
+// inputs are viewed first and the indicator runs with the GIL released
+template <typename T>
+py::object py_SMA(py::array_t<T, py::array::c_style | py::array::forcecast> prices, std::size_t n, py::object out)
+{
+    std::span<const T> p = py_span(prices);
+    if (out.is_none())
+        return py_as_array(py_nogil([&]
+                                    { return core::indicators::SMA(p, n); }));
+    std::span<T> o = py_out_span<T>(out, p.size(), {p});
+    return py_filled<T>(py_nogil([&]
+                                 { return core::indicators::SMA(p, n, o); }),
+                        out);
+}
+
+template <typename T>
+py::object py_EMA(py::array_t<T, py::array::c_style | py::array::forcecast> prices, std::size_t n, std::size_t threads, py::object out)
+{
+    std::span<const T> p = py_span(prices);
+    if (out.is_none())
+        return py_as_array(py_nogil([&]
+                                    { return core::indicators::scan::EMA(p, n, threads); }));
+    std::span<T> o = py_out_span<T>(out, p.size(), {p});
+    return py_filled<T>(py_nogil([&]
+                                 { return core::indicators::scan::EMA(p, n, o, threads); }),
+                        out);
+}
+
+template <typename T>
+py::object py_WMA(py::array_t<T, py::array::c_style | py::array::forcecast> prices, const std::string &weights, std::size_t n, py::object out)
+{
+    std::span<const T> p = py_span(prices);
+    if (out.is_none())
+        return py_as_array(py_nogil([&]
+                                    { return core::indicators::WMA(p, weights.c_str(), n); }));
+    std::span<T> o = py_out_span<T>(out, p.size(), {p});
+    return py_filled<T>(py_nogil([&]
+                                 { return core::indicators::WMA(p, weights.c_str(), n, o); }),
+                        out);
+}
+
+template <typename T>
+py::object py_VWMA(
+    py::array_t<T, py::array::c_style | py::array::forcecast> prices,
+    py::array_t<T, py::array::c_style | py::array::forcecast> volumes,
+    std::size_t n,
+    py::object out)
+{
+    std::span<const T> p = py_span(prices), v = py_span(volumes);
+    if (out.is_none())
+        return py_as_array(py_nogil([&]
+                                    { return core::indicators::VWMA(p, v, n); }));
+    std::span<T> o = py_out_span<T>(out, p.size(), {p, v});
+    return py_filled<T>(py_nogil([&]
+                                 { return core::indicators::VWMA(p, v, n, o); }),
+                        out);
+}
+
+template <typename T>
+py::object py_MACD(py::array_t<T, py::array::c_style | py::array::forcecast> prices, std::size_t fast, std::size_t slow, py::object out)
+{
+    std::span<const T> p = py_span(prices);
+    if (out.is_none())
+        return py_as_array(py_nogil([&]
+                                    { return core::indicators::MACD(p, fast, slow); }));
+    std::span<T> o = py_out_span<T>(out, p.size(), {p});
+    return py_filled<T>(py_nogil([&]
+                                 { return core::indicators::MACD(p, fast, slow, o); }),
+                        out);
+}
+
+template <typename T>
+py::object py_RSI(py::array_t<T, py::array::c_style | py::array::forcecast> prices, std::size_t n, std::size_t threads, py::object out)
+{
+    std::span<const T> p = py_span(prices);
+    if (out.is_none())
+        return py_as_array(py_nogil([&]
+                                    { return core::indicators::scan::RSI(p, n, threads); }));
+    std::span<T> o = py_out_span<T>(out, p.size(), {p});
+    return py_filled<T>(py_nogil([&]
+                                 { return core::indicators::scan::RSI(p, n, o, threads); }),
+                        out);
+}
+
+template <typename T>
+py::object py_BollingerBands(py::array_t<T, py::array::c_style | py::array::forcecast> prices, std::size_t n, double k, py::object out)
+{
+    std::span<const T> p = py_span(prices);
+    if (out.is_none())
+    {
+        std::vector<T> bb = py_nogil([&]
+                                     { return core::indicators::BollingerBands(p, n, k); });
+        py::ssize_t len = bb.size() / 3;
+        return py_as_array(std::move(bb), {3, len});
+    }
+    // rows middle, upper, lower of a 3 x N buffer
+    const std::size_t len = p.size();
+    std::span<T> rows = py_out_span<T>(out, 3 * len, {p});
+    return py_filled<T>(py_nogil([&]
+                                 { return core::indicators::BollingerBands(p, n, k, rows.first(len), rows.subspan(len, len), rows.last(len)); }),
+                        out);
+}
+
+template <typename T>
+py::object py_ATR(
+    py::array_t<T, py::array::c_style | py::array::forcecast> highs,
+    py::array_t<T, py::array::c_style | py::array::forcecast> lows,
+    py::array_t<T, py::array::c_style | py::array::forcecast> closes,
+    std::size_t n,
+    py::object out)
+{
+    std::span<const T> h = py_span(highs), l = py_span(lows), c = py_span(closes);
+    if (out.is_none())
+        return py_as_array(py_nogil([&]
+                                    { return core::indicators::ATR(h, l, c, n); }));
+    std::span<T> o = py_out_span<T>(out, h.size(), {h, l, c});
+    return py_filled<T>(py_nogil([&]
+                                 { return core::indicators::ATR(h, l, c, n, o); }),
+                        out);
+}
+
+template <typename T>
+py::object py_Momentum(py::array_t<T, py::array::c_style | py::array::forcecast> prices, std::size_t n, py::object out)
+{
+    std::span<const T> p = py_span(prices);
+    if (out.is_none())
+        return py_as_array(py_nogil([&]
+                                    { return core::indicators::Momentum(p, n); }));
+    std::span<T> o = py_out_span<T>(out, p.size(), {p});
+    return py_filled<T>(py_nogil([&]
+                                 { return core::indicators::Momentum(p, n, o); }),
+                        out);
+}
+
+template <typename T>
+py::object py_Donchian(
+    py::array_t<T, py::array::c_style | py::array::forcecast> highs,
+    py::array_t<T, py::array::c_style | py::array::forcecast> lows,
+    std::size_t n,
+    py::object out)
+{
+    std::span<const T> h = py_span(highs), l = py_span(lows);
+    if (out.is_none())
+    {
+        std::vector<T> dc = py_nogil([&]
+                                     { return core::indicators::Donchian(h, l, n); });
+        py::ssize_t len = dc.size() / 3;
+        return py_as_array(std::move(dc), {3, len});
+    }
+    // rows middle, upper, lower of a 3 x N buffer
+    const std::size_t len = h.size();
+    std::span<T> rows = py_out_span<T>(out, 3 * len, {h, l});
+    return py_filled<T>(py_nogil([&]
+                                 { return core::indicators::Donchian(h, l, n, rows.first(len), rows.subspan(len, len), rows.last(len)); }),
+                        out);
+}
+
+template <typename T>
+py::object py_Stochastic(
+    py::array_t<T, py::array::c_style | py::array::forcecast> highs,
+    py::array_t<T, py::array::c_style | py::array::forcecast> lows,
+    py::array_t<T, py::array::c_style | py::array::forcecast> closes,
+    std::size_t n,
+    std::size_t d,
+    py::object out)
+{
+    std::span<const T> h = py_span(highs), l = py_span(lows), c = py_span(closes);
+    if (out.is_none())
+    {
+        std::vector<T> kd = py_nogil([&]
+                                     { return core::indicators::Stochastic(h, l, c, n, d); });
+        py::ssize_t len = kd.size() / 2;
+        return py_as_array(std::move(kd), {2, len});
+    }
+    // rows %K, %D of a 2 x N buffer
+    const std::size_t len = h.size();
+    std::span<T> rows = py_out_span<T>(out, 2 * len, {h, l, c});
+    return py_filled<T>(py_nogil([&]
+                                 { return core::indicators::Stochastic(h, l, c, n, d, rows.first(len), rows.last(len)); }),
+                        out);
+}
+
+template <typename T>
+py::object py_WilliamsR(
+    py::array_t<T, py::array::c_style | py::array::forcecast> highs,
+    py::array_t<T, py::array::c_style | py::array::forcecast> lows,
+    py::array_t<T, py::array::c_style | py::array::forcecast> closes,
+    std::size_t n,
+    py::object out)
+{
+    std::span<const T> h = py_span(highs), l = py_span(lows), c = py_span(closes);
+    if (out.is_none())
+        return py_as_array(py_nogil([&]
+                                    { return core::indicators::WilliamsR(h, l, c, n); }));
+    std::span<T> o = py_out_span<T>(out, h.size(), {h, l, c});
+    return py_filled<T>(py_nogil([&]
+                                 { return core::indicators::WilliamsR(h, l, c, n, o); }),
+                        out);
+}
+
+template <typename T>
+py::object py_Aroon(
+    py::array_t<T, py::array::c_style | py::array::forcecast> highs,
+    py::array_t<T, py::array::c_style | py::array::forcecast> lows,
+    std::size_t n,
+    py::object out)
+{
+    std::span<const T> h = py_span(highs), l = py_span(lows);
+    if (out.is_none())
+    {
+        std::vector<T> ud = py_nogil([&]
+                                     { return core::indicators::Aroon(h, l, n); });
+        py::ssize_t len = ud.size() / 2;
+        return py_as_array(std::move(ud), {2, len});
+    }
+    // rows up, down of a 2 x N buffer
+    const std::size_t len = h.size();
+    std::span<T> rows = py_out_span<T>(out, 2 * len, {h, l});
+    return py_filled<T>(py_nogil([&]
+                                 { return core::indicators::Aroon(h, l, n, rows.first(len), rows.last(len)); }),
+                        out);
+}
+
+// Row-major periods x N matrix of a parameter sweep
+py::array_t<double> py_sweep_matrix(std::vector<double> &&res, const std::vector<std::size_t> &periods)
+{
+    py::ssize_t rows = periods.size();
+    py::ssize_t len = rows == 0 ? 0 : res.size() / rows;
+    return py_as_array(std::move(res), {rows, len});
+}
+
+py::array_t<double> py_SMA_multi(py::array_t<double, py::array::c_style | py::array::forcecast> prices, const std::vector<std::size_t> &periods)
+{
+    std::span<const double> p = py_span(prices);
+    return py_sweep_matrix(py_nogil([&]
+                                    { return core::indicators::SMA_multi(p, periods); }),
+                           periods);
+}
+
+py::array_t<double> py_EMA_multi(py::array_t<double, py::array::c_style | py::array::forcecast> prices, const std::vector<std::size_t> &periods)
+{
+    std::span<const double> p = py_span(prices);
+    return py_sweep_matrix(py_nogil([&]
+                                    { return core::indicators::EMA_multi(p, periods); }),
+                           periods);
+}
+
+py::array_t<double> py_RSI_multi(py::array_t<double, py::array::c_style | py::array::forcecast> prices, const std::vector<std::size_t> &periods)
+{
+    std::span<const double> p = py_span(prices);
+    return py_sweep_matrix(py_nogil([&]
+                                    { return core::indicators::RSI_multi(p, periods); }),
+                           periods);
+}
+
+core::strategy::dag py_build_dag(
+    py::dict dag_json,
+    py::dict indicator_columns,
+    std::vector<py::array_t<double, py::array::c_style | py::array::forcecast>> &arrays)
+{
+    core::strategy::dag graph;
+    std::unordered_map<std::string, std::size_t> ids;
+
+    for (py::handle h : dag_json["nodes"])
+    {
+        py::object id = h["id"];
+        py::dict data = h["data"];
+        std::string kind = data.contains("kind") && !data["kind"].is_none() ? py::str(data["kind"]).cast<std::string>() : "";
+        std::string label = data.contains("label") && !data["label"].is_none() ? py::str(data["label"]).cast<std::string>() : "";
+
+        core::strategy::node node;
+        if (kind == "indicator")
+        {
+            node.kind = core::strategy::node_kind::INDICATOR;
+            if (indicator_columns.contains(id))
+            {
+                arrays.emplace_back(indicator_columns[id].cast<py::array_t<double, py::array::c_style | py::array::forcecast>>());
+                node.column = arrays.size() - 1;
+            }
+        }
+        else if (kind == "operator")
+        {
+            node.kind = core::strategy::node_kind::OPERATOR;
+            node.op = core::strategy::resolve_operator(label);
+            if (data.contains("value") && !data["value"].is_none())
+            {
+                // same conversion as Python's float(), anything it rejects makes the comparison false
+                try
+                {
+                    node.threshold = py::float_(data["value"]).cast<double>();
+                    node.has_threshold = true;
+                }
+                catch (py::error_already_set &)
+                {
+                }
+            }
+        }
+        else if (kind == "logic")
+        {
+            node.kind = core::strategy::node_kind::LOGIC;
+            node.logic_valid = label == "TRUE" || label == "FALSE";
+            node.logic_value = label == "TRUE";
+        }
+        else if (kind == "action")
+        {
+            node.kind = core::strategy::node_kind::ACTION;
+            node.action = core::strategy::resolve_action(label);
+        }
+
+        if (graph.start < 0 && label == "Start")
+            graph.start = graph.nodes.size();
+        ids[py::str(id)] = graph.nodes.size();
+        graph.nodes.emplace_back(std::move(node));
+    }
+
+    for (py::handle e : dag_json["edges"])
+    {
+        auto src = ids.find(py::str(e["src"]));
+        auto dest = ids.find(py::str(e["dest"]));
+        if (src == ids.end() || dest == ids.end())
+        {
+            throw std::runtime_error("Edge references an unknown node");
+        }
+        graph.nodes[src->second].children.emplace_back(dest->second);
+    }
+
+    return graph;
+}
+
+// Compiles the strategy graph against its indicator columns, which are pinned in `arrays` and viewed in `columns`
+core::strategy::program py_compile_strategy(
+    py::dict dag_json,
+    py::dict indicator_columns,
+    std::size_t len,
+    std::vector<py::array_t<double, py::array::c_style | py::array::forcecast>> &arrays,
+    std::vector<std::span<const double>> &columns)
+{
+    core::strategy::dag graph = py_build_dag(dag_json, indicator_columns, arrays);
+
+    for (auto &a : arrays)
+    {
+        auto col = a.request();
+        if ((std::size_t)col.shape[0] != len)
+        {
+            throw std::runtime_error("Indicator columns must have the same length as the prices");
+        }
+        columns.emplace_back(static_cast<const double *>(col.ptr), len);
+    }
+
+    // compiled once, then evaluated column block by column block over every bar
+    core::strategy::program prog = core::strategy::compile(graph);
+    if (!prog.ok)
+    {
+        throw std::runtime_error("Strategy graph contains a cycle");
+    }
+    return prog;
+}
+
+std::vector<core::strategy::signal> py_strategy_signals(py::dict dag_json, py::dict indicator_columns, std::size_t len)
+{
+    std::vector<py::array_t<double, py::array::c_style | py::array::forcecast>> arrays;
+    std::vector<std::span<const double>> columns;
+    core::strategy::program prog = py_compile_strategy(dag_json, indicator_columns, len, arrays, columns);
+    return py_nogil([&]
+                    { return core::strategy::evaluate(prog, columns, len); });
+}
+
+py::array_t<std::int8_t> py_signals(py::dict dag_json, py::dict indicator_columns, std::size_t len)
+{
+    return py_as_array(py_strategy_signals(dag_json, indicator_columns, len));
+}
+
+// Equity curve and trade log of a run as arrays
+py::dict py_backtest_dict(core::backtest::result &&res)
+{
+    core::backtest::trade_log &t = res.trades;
+    py::dict trades;
+    trades["bar"] = py_as_array(std::move(t.bar));
+    trades["type"] = py_as_array(std::move(t.type));
+    trades["price"] = py_as_array(std::move(t.price));
+    trades["qty"] = py_as_array(std::move(t.qty));
+    trades["comm"] = py_as_array(std::move(t.comm));
+    trades["balance"] = py_as_array(std::move(t.balance));
+    trades["pnl"] = py_as_array(std::move(t.pnl));
+
+    py::dict out;
+    out["equity"] = py_as_array(std::move(res.equity));
+    out["trades"] = trades;
+    return out;
+}
+
+py::dict py_backtest(
+    py::array_t<double, py::array::c_style | py::array::forcecast> closes,
+    py::dict dag_json,
+    py::dict indicator_columns,
+    double initial_capital,
+    double allocation_fraction,
+    double commission)
+{
+    std::span<const double> c = py_span(closes);
+    std::vector<py::array_t<double, py::array::c_style | py::array::forcecast>> arrays;
+    std::vector<std::span<const double>> columns;
+    core::strategy::program prog = py_compile_strategy(dag_json, indicator_columns, c.size(), arrays, columns);
+
+    return py_backtest_dict(py_nogil([&]
+                                     { return core::backtest::run(c, core::strategy::evaluate(prog, columns, c.size()), initial_capital, allocation_fraction, commission); }));
+}
+
+// Same as py_backtest on the pool, the graph is checked before the call returns
+py_future py_backtest_async(
+    py::array_t<double, py::array::c_style | py::array::forcecast> closes,
+    py::dict dag_json,
+    py::dict indicator_columns,
+    double initial_capital,
+    double allocation_fraction,
+    double commission)
+{
+    std::span<const double> c = py_span(closes);
+    std::vector<py::array_t<double, py::array::c_style | py::array::forcecast>> arrays;
+    std::vector<std::span<const double>> columns;
+    core::strategy::program prog = py_compile_strategy(dag_json, indicator_columns, c.size(), arrays, columns);
+    py::list inputs;
+    inputs.append(closes);
+    for (auto &a : arrays)
+        inputs.append(a);
+
+    std::future<py_future::finisher> pending = core::thread_pool::shared().async(
+        [c, columns = std::move(columns), prog = std::move(prog), initial_capital, allocation_fraction, commission]() -> py_future::finisher
+        {
+            core::backtest::result res = core::backtest::run(c, core::strategy::evaluate(prog, columns, c.size()), initial_capital, allocation_fraction, commission);
+            return [res = std::move(res)]() mutable -> py::object
+            { return py_backtest_dict(std::move(res)); };
+        });
+    return py_future(std::move(pending), std::move(inputs));
+}
+
+// Metrics under the names of core::backtest::metrics
+py::dict py_metrics_dict(const core::backtest::metrics &m)
+{
+    py::dict out;
+    out["total_return"] = m.total_return;
+    out["sharpe"] = m.sharpe;
+    out["sortino"] = m.sortino;
+    out["max_drawdown"] = m.max_drawdown;
+    out["max_drawdown_duration"] = m.max_drawdown_duration;
+    out["win_rate"] = m.win_rate;
+    out["profit_factor"] = m.profit_factor;
+    out["final_equity"] = m.final_equity;
+    return out;
+}
+
+py::dict py_metrics(py::array_t<double, py::array::c_style | py::array::forcecast> equity, py::object pnl)
+{
+    std::span<const double> e = py_span(equity), trades;
+    py::array_t<double, py::array::c_style | py::array::forcecast> p;
+    if (!pnl.is_none())
+    {
+        p = pnl.cast<py::array_t<double, py::array::c_style | py::array::forcecast>>();
+        trades = py_span(p);
+    }
+    return py_metrics_dict(py_nogil([&]
+                                    { return core::backtest::summarize(e, trades); }));
+}
+
+py::dict py_equity_curves(py::array_t<double, py::array::c_style | py::array::forcecast> equity)
+{
+    std::span<const double> e = py_span(equity);
+    core::backtest::curves c = py_nogil([&]
+                                        { return core::backtest::equity_curves(e); });
+    py::dict out;
+    out["returns"] = py_as_array(std::move(c.returns));
+    out["peak"] = py_as_array(std::move(c.peak));
+    out["drawdown"] = py_as_array(std::move(c.drawdown));
+    return out;
+}
+
+py::dict py_rolling_metrics(py::array_t<double, py::array::c_style | py::array::forcecast> equity, std::size_t window)
+{
+    std::span<const double> e = py_span(equity);
+    core::backtest::rolling_metrics r = py_nogil([&]
+                                                 { return core::backtest::rolling(e, window); });
+    py::dict out;
+    out["sharpe"] = py_as_array(std::move(r.sharpe));
+    out["sortino"] = py_as_array(std::move(r.sortino));
+    out["volatility"] = py_as_array(std::move(r.volatility));
+    return out;
+}
+
+// Splits one column of every symbol out of a list of 1-D arrays (ragged), a 2-D matrix (one row per symbol)
+// or a flat 1-D array cut at `offsets` (symbol i is [offsets[i], offsets[i + 1])); None gives no columns
+std::vector<std::span<const double>> py_universe_columns(
+    py::object data,
+    py::object offsets,
+    std::vector<py::array_t<double, py::array::c_style | py::array::forcecast>> &arrays)
+{
+    std::vector<std::span<const double>> columns;
+    if (data.is_none())
+        return columns;
+
+    if (py::isinstance<py::list>(data) || py::isinstance<py::tuple>(data))
+    {
+        for (py::handle h : data)
+        {
+            arrays.emplace_back(py::cast<py::array_t<double, py::array::c_style | py::array::forcecast>>(h));
+            columns.emplace_back(py_span(arrays.back()));
+        }
+        return columns;
+    }
+
+    arrays.emplace_back(py::cast<py::array_t<double, py::array::c_style | py::array::forcecast>>(data));
+    auto buf = arrays.back().request();
+    const double *base = static_cast<const double *>(buf.ptr);
+    if (buf.ndim == 2)
+    {
+        for (py::ssize_t i = 0; i < buf.shape[0]; i++)
+            columns.emplace_back(base + i * buf.shape[1], buf.shape[1]);
+        return columns;
+    }
+    if (buf.ndim != 1 || offsets.is_none())
+    {
+        throw std::runtime_error("Series must be a list of 1-D arrays, a 2-D matrix or a 1-D array with offsets");
+    }
+
+    std::vector<std::size_t> cuts = offsets.cast<std::vector<std::size_t>>();
+    for (std::size_t i = 0; i + 1 < cuts.size(); i++)
+    {
+        if (cuts[i] > cuts[i + 1] || cuts[i + 1] > (std::size_t)buf.shape[0])
+        {
+            throw std::runtime_error("Offsets must be non-decreasing and within the array");
+        }
+        columns.emplace_back(base + cuts[i], cuts[i + 1] - cuts[i]);
+    }
+    return columns;
+}
+
+// {"indicator": "MACD", "fast": 12, "slow": 26}, {"indicator": "BollingerBands", "period": 20, "multiplier": 2}, ...
+core::indicators::universe::spec py_indicator_spec(py::dict d)
+{
+    core::indicators::universe::spec s;
+    if (!d.contains("indicator") || !core::indicators::universe::resolve_kind(py::str(d["indicator"]).cast<std::string>(), s.indicator))
+    {
+        throw std::runtime_error("Unknown indicator in spec");
+    }
+    if (d.contains("period"))
+        s.n = d["period"].cast<std::size_t>();
+    if (d.contains("fast"))
+        s.n = d["fast"].cast<std::size_t>();
+    if (d.contains("slow"))
+        s.slow = d["slow"].cast<std::size_t>();
+    if (d.contains("smoothing"))
+        s.slow = d["smoothing"].cast<std::size_t>();
+    if (d.contains("multiplier"))
+        s.k = d["multiplier"].cast<double>();
+    if (d.contains("weights"))
+        s.weights = py::str(d["weights"]).cast<std::string>();
+    // %D of Stochastic is the 3-bar SMA of %K unless given
+    if (s.indicator == core::indicators::universe::kind::STOCHASTIC && s.slow == 0)
+        s.slow = 3;
+    return s;
+}
+
+py::list py_universe(
+    py::object prices,
+    py::list specs,
+    py::object offsets,
+    py::object highs,
+    py::object lows,
+    py::object volumes)
+{
+    std::vector<py::array_t<double, py::array::c_style | py::array::forcecast>> arrays;
+    std::vector<std::span<const double>> p = py_universe_columns(prices, offsets, arrays);
+    std::vector<std::span<const double>> h = py_universe_columns(highs, offsets, arrays);
+    std::vector<std::span<const double>> l = py_universe_columns(lows, offsets, arrays);
+    std::vector<std::span<const double>> v = py_universe_columns(volumes, offsets, arrays);
+
+    std::vector<core::indicators::universe::series> symbols(p.size());
+    for (std::size_t i = 0; i < p.size(); i++)
+    {
+        symbols[i].prices = p[i];
+        symbols[i].highs = i < h.size() ? h[i] : std::span<const double>();
+        symbols[i].lows = i < l.size() ? l[i] : std::span<const double>();
+        symbols[i].volumes = i < v.size() ? v[i] : std::span<const double>();
+    }
+
+    std::vector<core::indicators::universe::spec> sp;
+    for (py::handle item : specs)
+        sp.emplace_back(py_indicator_spec(py::cast<py::dict>(item)));
+
+    // the NumPy buffers stay alive in `arrays`, nothing below touches a Python object
+    std::vector<std::vector<std::vector<double>>> res = py_nogil([&]
+                                                                 { return core::indicators::universe::compute(symbols, sp); });
+
+    py::list out;
+    for (std::vector<std::vector<double>> &symbol : res)
+    {
+        py::list row;
+        for (std::size_t k = 0; k < sp.size(); k++)
+        {
+            const py::ssize_t rows = core::indicators::universe::rows(sp[k].indicator);
+            if (rows > 1)
+            {
+                py::ssize_t len = symbol[k].size() / rows;
+                row.append(py_as_array(std::move(symbol[k]), {rows, len}));
+            }
+            else
+                row.append(py_as_array(std::move(symbol[k])));
+        }
+        out.append(row);
+    }
+    return out;
+}
+
+// Values of one optimizer parameter: {"values": [...]} or an inclusive {"min", "max", "step"} range
+std::vector<double> py_parameter_values(py::dict d)
+{
+    if (d.contains("values"))
+        return d["values"].cast<std::vector<double>>();
+    if (!d.contains("min") || !d.contains("max"))
+    {
+        throw std::runtime_error("Parameter needs \"values\" or a \"min\"/\"max\" range");
+    }
+    double lo = d["min"].cast<double>(), hi = d["max"].cast<double>();
+    double step = d.contains("step") ? d["step"].cast<double>() : 1.0;
+    if (!(step > 0))
+    {
+        throw std::runtime_error("Parameter step must be positive");
+    }
+    std::vector<double> values;
+    // counted rather than accumulated, so 0.1 steps do not drift past `max`
+    for (std::size_t i = 0; lo + i * step <= hi + step * 1e-9; i++)
+        values.emplace_back(lo + i * step);
+    return values;
+}
+
+// Indicator node of the editor graph with the parameters `_precalc_indicators` reads from its data
+struct py_dag_indicator
+{
+    std::size_t node;
+    core::indicators::universe::spec spec;
+    // lower-cased "Price" column, "close" by default
+    std::string price;
+    // row of the "Line" of a multi-row indicator, the first by default
+    std::size_t row = 0;
+};
+
+std::vector<py_dag_indicator> py_dag_indicators(py::dict dag_json)
+{
+    std::vector<py_dag_indicator> out;
+    std::size_t index = 0;
+    for (py::handle h : dag_json["nodes"])
+    {
+        py::dict d = h["data"];
+        core::indicators::universe::spec sp;
+        if (d.contains("kind") && py::str(d["kind"]).cast<std::string>() == "indicator" && d.contains("label") &&
+            core::indicators::universe::resolve_kind(py::str(d["label"]).cast<std::string>(), sp.indicator))
+        {
+            if (d.contains("Period"))
+                sp.n = py::int_(d["Period"]).cast<std::size_t>();
+            if (d.contains("Fast"))
+                sp.n = py::int_(d["Fast"]).cast<std::size_t>();
+            if (d.contains("Slow"))
+                sp.slow = py::int_(d["Slow"]).cast<std::size_t>();
+            if (d.contains("Smoothing"))
+                sp.slow = py::int_(d["Smoothing"]).cast<std::size_t>();
+            else if (sp.indicator == core::indicators::universe::kind::STOCHASTIC)
+                sp.slow = 3;
+            if (d.contains("Multiplier"))
+                sp.k = py::float_(d["Multiplier"]).cast<double>();
+            if (d.contains("Weights"))
+                sp.weights = py::str(d["Weights"].attr("lower")()).cast<std::string>();
+            std::string price = d.contains("Price") && !py::str(d["Price"]).cast<std::string>().empty() ? py::str(d["Price"].attr("lower")()).cast<std::string>() : "close";
+            std::string line = d.contains("Line") ? py::str(d["Line"].attr("lower")()).cast<std::string>() : "";
+            std::size_t row;
+            if (!core::indicators::universe::resolve_line(sp.indicator, line, row))
+            {
+                throw std::runtime_error("Unknown line \"" + line + "\" of " + py::str(d["label"]).cast<std::string>());
+            }
+            out.push_back({index, sp, price, row});
+        }
+        index++;
+    }
+    return out;
+}
+
+py::list py_optimize(
+    py::dict data,
+    py::dict dag_json,
+    py::list parameters,
+    double initial_capital,
+    double allocation_fraction,
+    double commission,
+    const std::string &method,
+    std::size_t samples,
+    std::uint64_t seed,
+    std::size_t top_k,
+    const std::string &rank)
+{
+    std::vector<py::array_t<double, py::array::c_style | py::array::forcecast>> arrays;
+    auto column = [&](const std::string &name) -> std::span<const double>
+    {
+        if (!data.contains(name))
+            return {};
+        arrays.emplace_back(data[name.c_str()].cast<py::array_t<double, py::array::c_style | py::array::forcecast>>());
+        return py_span(arrays.back());
+    };
+
+    core::optimizer::problem prob;
+    prob.graph = py_build_dag(dag_json, py::dict(), arrays);
+    prob.closes = column("close");
+    prob.initial_capital = initial_capital;
+    prob.allocation_fraction = allocation_fraction;
+    prob.commission = commission;
+    std::span<const double> highs = column("high"), lows = column("low"), volumes = column("volume");
+
+    for (py_dag_indicator &ind : py_dag_indicators(dag_json))
+        prob.indicators.push_back({ind.node, {column(ind.price), highs, lows, volumes}, ind.spec, ind.row});
+    std::unordered_map<std::string, std::size_t> ids;
+    std::size_t index = 0;
+    for (py::handle h : dag_json["nodes"])
+        ids[py::str(h["id"])] = index++;
+
+    // {"node": id, "param": "Period" | "Fast" | "Slow" | "Smoothing" | "Multiplier" | "value", ...} or {"param": "allocation", ...}
+    for (py::handle item : parameters)
+    {
+        py::dict d = py::cast<py::dict>(item);
+        core::optimizer::parameter param;
+        std::string name = d.contains("param") ? py::str(d["param"]).cast<std::string>() : "";
+        if (name == "Period" || name == "Fast")
+            param.what = core::optimizer::target::PERIOD;
+        else if (name == "Slow" || name == "Smoothing")
+            param.what = core::optimizer::target::SLOW;
+        else if (name == "Multiplier")
+            param.what = core::optimizer::target::MULTIPLIER;
+        else if (name == "value")
+            param.what = core::optimizer::target::THRESHOLD;
+        else if (name == "allocation")
+            param.what = core::optimizer::target::ALLOCATION;
+        else
+        {
+            throw std::runtime_error("Unknown optimizer parameter \"" + name + "\"");
+        }
+        if (param.what != core::optimizer::target::ALLOCATION)
+        {
+            auto it = d.contains("node") ? ids.find(py::str(d["node"])) : ids.end();
+            if (it == ids.end())
+            {
+                throw std::runtime_error("Optimizer parameter references an unknown node");
+            }
+            param.node = it->second;
+        }
+        param.values = py_parameter_values(d);
+        prob.parameters.emplace_back(std::move(param));
+    }
+
+    core::optimizer::options opts;
+    opts.method = method == "random" ? core::optimizer::search::RANDOM : core::optimizer::search::GRID;
+    opts.samples = samples;
+    opts.seed = seed;
+    opts.top_k = top_k;
+    opts.rank = rank == "return" ? core::optimizer::rank_by::TOTAL_RETURN : rank == "drawdown" ? core::optimizer::rank_by::MAX_DRAWDOWN
+                                                                        : rank == "win_rate"   ? core::optimizer::rank_by::WIN_RATE
+                                                                                               : core::optimizer::rank_by::SHARPE;
+    if (opts.method == core::optimizer::search::GRID && core::optimizer::grid_size(prob.parameters) == 0)
+    {
+        throw std::runtime_error("Parameter grid is empty or too large");
+    }
+    const std::size_t candidates = opts.method == core::optimizer::search::GRID ? core::optimizer::grid_size(prob.parameters) : opts.samples;
+    if (candidates > core::optimizer::MAX_CANDIDATES)
+    {
+        throw std::runtime_error("Search has " + std::to_string(candidates) + " candidates, at most " + std::to_string(core::optimizer::MAX_CANDIDATES) +
+                                 " are supported; narrow the parameter ranges or draw fewer random samples");
+    }
+
+    std::vector<core::optimizer::candidate> top = py_nogil([&]
+                                                           { return core::optimizer::optimize(prob, opts); });
+
+    py::list out;
+    for (core::optimizer::candidate &c : top)
+    {
+        py::dict res;
+        res["values"] = py_as_array(std::move(c.values));
+        res["metrics"] = py_metrics_dict(c.metrics);
+        out.append(res);
+    }
+    return out;
+}
+
+// Read-only view of a mapped column, the array keeps the Store (and so the mapping) alive
+template <typename T>
+py::array_t<T> py_store_column(py::object store, std::span<const T> col)
+{
+    py::array_t<T> arr({(py::ssize_t)col.size()}, {(py::ssize_t)sizeof(T)}, col.data(), store);
+    arr.attr("setflags")(py::arg("write") = false);
+    return arr;
+}
+
+void py_store_write(
+    const std::string &path,
+    const std::string &symbol,
+    py::array_t<std::int64_t, py::array::c_style | py::array::forcecast> dates,
+    py::object open,
+    py::object high,
+    py::object low,
+    py::object close,
+    py::object volume)
+{
+    std::vector<py::array_t<double, py::array::c_style | py::array::forcecast>> arrays;
+    core::store::columns cols;
+    auto d = dates.request();
+    if (d.ndim != 1)
+    {
+        throw std::runtime_error("Dates must be 1-dimensional");
+    }
+    cols.date = std::span<const std::int64_t>(static_cast<const std::int64_t *>(d.ptr), d.shape[0]);
+
+    py::object fields[core::store::FIELDS] = {open, high, low, close, volume};
+    for (std::size_t f = 0; f < core::store::FIELDS; f++)
+    {
+        if (fields[f].is_none())
+            continue;
+        arrays.emplace_back(fields[f].cast<py::array_t<double, py::array::c_style | py::array::forcecast>>());
+        cols.fields[f] = py_span(arrays.back());
+    }
+
+    bool ok = py_nogil([&]
+                       { return core::store::write(path, symbol, cols); });
+    if (!ok)
+    {
+        throw std::runtime_error("Could not write store file " + path + " (columns of different lengths or I/O error)");
+    }
+}
+
+// Recognized columns in file order, dates as datetime64[D] (NaT where unparseable)
+py::dict py_ingest_columns(core::ingest::table &&t)
+{
+    static const char *names[core::store::FIELDS] = {"open", "high", "low", "close", "volume"};
+    py::dict out;
+    for (const int &c : t.order)
+    {
+        if (c == -1)
+            out["date"] = py_as_array(std::move(t.date)).attr("view")("datetime64[D]");
+        else
+            out[names[c]] = py_as_array(std::move(t.fields[c]));
+    }
+    return out;
+}
+
+py::dict py_read_csv(py::object data, bool reverse)
+{
+    std::string_view text;
+    if (py::isinstance<py::bytes>(data))
+    {
+        char *buf;
+        py::ssize_t len;
+        PyBytes_AsStringAndSize(data.ptr(), &buf, &len);
+        text = std::string_view(buf, len);
+    }
+    else if (py::isinstance<py::str>(data))
+    {
+        py::ssize_t len;
+        const char *buf = PyUnicode_AsUTF8AndSize(data.ptr(), &len);
+        if (!buf)
+            throw py::error_already_set();
+        text = std::string_view(buf, len);
+    }
+    else
+    {
+        throw std::runtime_error("CSV data must be bytes or str");
+    }
+
+    // `data` holds the buffer, it is not touched by Python while the chunks are parsed
+    core::ingest::table t = py_nogil([&]
+                                     { return core::ingest::parse(text, reverse); });
+    if (!t.ok)
+    {
+        throw std::runtime_error("CSV has no header line");
+    }
+    return py_ingest_columns(std::move(t));
+}
+
+py::dict py_read_csv_file(const std::string &path, bool reverse)
+{
+    core::ingest::table t = py_nogil([&]
+                                     { return core::ingest::parse_file(path, reverse); });
+    if (!t.ok)
+    {
+        throw std::runtime_error("Could not read CSV file " + path);
+    }
+    return py_ingest_columns(std::move(t));
+}
+
+core::bars::rule py_bar_rule(const std::string &by)
+{
+    core::bars::rule r;
+    if (!core::bars::resolve_rule(by, r))
+    {
+        throw std::runtime_error("Unknown bar rule " + by + " (time, tick, volume or dollar)");
+    }
+    return r;
+}
+
+// A positive TIME interval under one timestamp unit would be cut to 0, i.e. one bar per timestamp
+void py_check_bar_interval(const core::bars::rule &r, const double &threshold)
+{
+    if (r == core::bars::rule::TIME && threshold > 0 && threshold < 1)
+    {
+        throw std::runtime_error("Time bar intervals must be at least one timestamp unit (1 ns)");
+    }
+    // NaN and lengths past the int64 timestamps (2^63 units) are not intervals either
+    if (r == core::bars::rule::TIME && !(threshold < 9.2e18))
+    {
+        throw std::runtime_error("Time bar intervals must be a number of timestamp units below 9.2e18 (about 292 years in ns)");
+    }
+}
+
+// Bar columns, handed to NumPy without a copy
+py::dict py_bar_columns(core::bars::table &&t)
+{
+    py::dict out;
+    out["time"] = py_as_array(std::move(t.time));
+    out["open"] = py_as_array(std::move(t.open));
+    out["high"] = py_as_array(std::move(t.high));
+    out["low"] = py_as_array(std::move(t.low));
+    out["close"] = py_as_array(std::move(t.close));
+    out["volume"] = py_as_array(std::move(t.volume));
+    out["vwap"] = py_as_array(std::move(t.vwap));
+    out["ticks"] = py_as_array(std::move(t.ticks));
+    return out;
+}
+
+py::dict py_bar(const core::bars::bar &b)
+{
+    py::dict out;
+    out["time"] = b.time;
+    out["open"] = b.open;
+    out["high"] = b.high;
+    out["low"] = b.low;
+    out["close"] = b.close;
+    out["volume"] = b.volume;
+    out["vwap"] = b.volume != 0 ? b.dollars / b.volume : b.close;
+    out["ticks"] = b.ticks;
+    return out;
+}
+
+py::dict py_aggregate_ticks(
+    py::array_t<std::int64_t, py::array::c_style | py::array::forcecast> times,
+    py::array_t<double, py::array::c_style | py::array::forcecast> prices,
+    py::array_t<double, py::array::c_style | py::array::forcecast> sizes,
+    const std::string &by,
+    double threshold,
+    bool flush)
+{
+    const core::bars::rule r = py_bar_rule(by);
+    py_check_bar_interval(r, threshold);
+    std::span<const std::int64_t> t = py_span(times);
+    std::span<const double> p = py_span(prices), v = py_span(sizes);
+    if (t.size() != p.size() || t.size() != v.size())
+    {
+        throw std::runtime_error("Times, prices and sizes must have the same length");
+    }
+    core::bars::table bars = py_nogil([&]
+                                      { return core::bars::aggregate(t, p, v, r, threshold, flush); });
+    return py_bar_columns(std::move(bars));
+}
+
+// Replays a store file or CSV (a path) or rows already in memory (a dict with "time" in nanoseconds and any of
+// "open", "high", "low", "close", "volume"; ticks use "close" for the price and "volume" for the size) through
+// the live engine. TIME bar thresholds are in seconds, like AggregateTicks on second timestamps.
+py::dict py_live_replay(
+    py::object source,
+    py::dict dag_json,
+    double speed,
+    std::size_t capacity,
+    bool ticks,
+    const std::string &by,
+    double threshold)
+{
+    std::vector<py::array_t<double, py::array::c_style | py::array::forcecast>> arrays;
+    core::strategy::dag graph = py_build_dag(dag_json, py::dict(), arrays);
+
+    std::vector<core::live::indicator_node> nodes;
+    for (py_dag_indicator &ind : py_dag_indicators(dag_json))
+    {
+        int col;
+        if (!core::ingest::resolve_column(ind.price, col) || col < 0)
+        {
+            throw std::runtime_error("Unknown price column \"" + ind.price + "\"");
+        }
+        nodes.push_back({ind.node, ind.spec, (core::store::field)col, ind.row});
+    }
+
+    core::live::options opts;
+    opts.capacity = capacity;
+    opts.ticks = ticks;
+    opts.by = py_bar_rule(by);
+    opts.threshold = opts.by == core::bars::rule::TIME ? threshold * 1e9 : threshold;
+    py_check_bar_interval(opts.by, opts.threshold);
+
+    core::live::engine live(std::move(graph), nodes, opts);
+    if (!live.ok())
+    {
+        throw std::runtime_error("Strategy graph contains a cycle");
+    }
+
+    std::unique_ptr<core::live::replay> replay;
+    py::array_t<std::int64_t, py::array::c_style | py::array::forcecast> times;
+    if (py::isinstance<py::str>(source))
+    {
+        std::string path = source.cast<std::string>();
+        replay = std::make_unique<core::live::replay>(path);
+        if (!replay->ok())
+        {
+            throw std::runtime_error("Could not read \"" + path + "\"");
+        }
+    }
+    else
+    {
+        py::dict d = source.cast<py::dict>();
+        if (!d.contains("time"))
+        {
+            throw std::runtime_error("Replay rows need a \"time\" column");
+        }
+        times = d["time"].cast<py::array_t<std::int64_t, py::array::c_style | py::array::forcecast>>();
+        core::store::columns data;
+        data.date = py_span(times);
+        static constexpr const char *names[] = {"open", "high", "low", "close", "volume"};
+        arrays.reserve(arrays.size() + core::store::FIELDS);
+        for (std::size_t f = 0; f < core::store::FIELDS; f++)
+        {
+            if (!d.contains(names[f]))
+                continue;
+            arrays.emplace_back(d[names[f]].cast<py::array_t<double, py::array::c_style | py::array::forcecast>>());
+            data.fields[f] = py_span(arrays.back());
+            if (data.fields[f].size() != data.date.size())
+            {
+                throw std::runtime_error("Replay columns must have the same length as \"time\"");
+            }
+        }
+        replay = std::make_unique<core::live::replay>(data, 1);
+    }
+
+    // the producer and consumer threads only touch the buffers kept alive above
+    core::live::report rep = py_nogil([&]
+                                      { return core::live::run(live, *replay, speed); });
+
+    py::dict latency;
+    latency["p50"] = rep.p50;
+    latency["p90"] = rep.p90;
+    latency["p99"] = rep.p99;
+    latency["p999"] = rep.p999;
+    latency["max"] = rep.max;
+
+    py::dict res;
+    res["events"] = rep.events;
+    res["bars"] = rep.bars;
+    res["buys"] = rep.buys;
+    res["sells"] = rep.sells;
+    res["stalls"] = rep.stalls;
+    res["seconds"] = rep.seconds;
+    res["events_per_second"] = rep.seconds > 0 ? rep.events / rep.seconds : 0.0;
+    res["latency_ns"] = latency;
+    res["signals"] = py_as_array(std::move(rep.signals));
+    return res;
+}
+
+// One symbol's columns, the optional ones (None) stay empty; converted buffers are kept alive in `arrays`
+core::indicators::universe::series py_series(
+    const py::array_t<double, py::array::c_style | py::array::forcecast> &prices,
+    py::object highs,
+    py::object lows,
+    py::object volumes,
+    std::vector<py::array_t<double, py::array::c_style | py::array::forcecast>> &arrays)
+{
+    core::indicators::universe::series data;
+    data.prices = py_span(prices);
+    py::object optional[3] = {highs, lows, volumes};
+    std::span<const double> *columns[3] = {&data.highs, &data.lows, &data.volumes};
+    arrays.reserve(arrays.size() + 3);
+    for (std::size_t i = 0; i < 3; i++)
+    {
+        if (optional[i].is_none())
+            continue;
+        arrays.emplace_back(optional[i].cast<py::array_t<double, py::array::c_style | py::array::forcecast>>());
+        *columns[i] = py_span(arrays.back());
+    }
+    return data;
+}
+
+// One indicator computed on the pool, the call returns right away
+py_future py_indicator_async(
+    py::array_t<double, py::array::c_style | py::array::forcecast> prices,
+    py::dict spec,
+    py::object highs,
+    py::object lows,
+    py::object volumes)
+{
+    const core::indicators::universe::spec sp = py_indicator_spec(spec);
+    std::vector<py::array_t<double, py::array::c_style | py::array::forcecast>> arrays;
+    const core::indicators::universe::series data = py_series(prices, highs, lows, volumes, arrays);
+    py::list inputs;
+    inputs.append(prices);
+    for (auto &a : arrays)
+        inputs.append(a);
+
+    std::future<py_future::finisher> pending = core::thread_pool::shared().async(
+        [data, sp]() -> py_future::finisher
+        {
+            std::vector<double> res = core::indicators::universe::compute(data, sp);
+            const py::ssize_t rows = core::indicators::universe::rows(sp.indicator);
+            return [res = std::move(res), rows]() mutable -> py::object
+            {
+                if (rows == 1)
+                    return py_as_array(std::move(res));
+                py::ssize_t len = res.size() / rows;
+                return py_as_array(std::move(res), {rows, len});
+            };
+        });
+    return py_future(std::move(pending), std::move(inputs));
+}
+
+py::object py_pipeline(
+    py::array_t<double, py::array::c_style | py::array::forcecast> prices,
+    py::list specs,
+    py::object highs,
+    py::object lows,
+    py::object volumes,
+    py::object out)
+{
+    std::vector<py::array_t<double, py::array::c_style | py::array::forcecast>> arrays;
+    core::indicators::universe::series data = py_series(prices, highs, lows, volumes, arrays);
+
+    std::vector<core::indicators::universe::spec> sp;
+    for (py::handle item : specs)
+        sp.emplace_back(py_indicator_spec(py::cast<py::dict>(item)));
+    const core::indicators::pipeline::plan plan(sp);
+    const std::size_t len = data.prices.size();
+
+    std::vector<std::vector<double>> owned;
+    std::vector<std::span<double>> columns;
+    if (out.is_none())
+    {
+        owned.resize(sp.size());
+        for (std::size_t i = 0; i < sp.size(); i++)
+        {
+            owned[i].assign(plan.output_size(i, len), std::numeric_limits<double>::quiet_NaN());
+            columns.emplace_back(owned[i]);
+        }
+    }
+    else
+    {
+        // written in place, so a conversion (which would copy) is an error rather than a silent no-op
+        py::list targets = py::cast<py::list>(out);
+        if (targets.size() != sp.size())
+            throw std::runtime_error("`out` must have one array per spec");
+        for (std::size_t i = 0; i < sp.size(); i++)
+        {
+            py::array arr = py::cast<py::array>(targets[i]);
+            if (!arr.dtype().is(py::dtype::of<double>()) || !(arr.flags() & py::array::c_style) || !arr.writeable())
+                throw std::runtime_error("`out` arrays must be writeable C-contiguous float64");
+            if ((std::size_t)arr.size() != plan.output_size(i, len))
+                throw std::runtime_error("`out` array " + std::to_string(i) + " must have " + std::to_string(plan.output_size(i, len)) + " elements");
+            for (const std::span<const double> &in : {data.prices, data.highs, data.lows, data.volumes})
+            {
+                if (py_overlaps(arr.data(), arr.nbytes(), in.data(), in.size_bytes()))
+                    throw std::runtime_error("`out` array " + std::to_string(i) + " must not share memory with an input");
+            }
+            columns.emplace_back(static_cast<double *>(arr.mutable_data()), arr.size());
+        }
+    }
+
+    std::vector<bool> done = py_nogil([&]
+                                      { return plan.run(data, columns); });
+
+    py::list res;
+    for (std::size_t i = 0; i < sp.size(); i++)
+    {
+        if (!out.is_none())
+            res.append(py::bool_(done[i]));
+        else if (!done[i])
+            res.append(py::array_t<double>(0));
+        else if (core::indicators::universe::rows(sp[i].indicator) > 1)
+            res.append(py_as_array(std::move(owned[i]), {(py::ssize_t)core::indicators::universe::rows(sp[i].indicator), (py::ssize_t)len}));
+        else
+            res.append(py_as_array(std::move(owned[i])));
+    }
+    return res;
+}
+
+py::array_t<double> py_cache_get(
+    core::indicators::result_cache &cache,
+    const std::string &dataset,
+    std::uint64_t version,
+    py::dict spec,
+    const std::string &source,
+    py::array_t<double, py::array::c_style | py::array::forcecast> prices,
+    py::object highs,
+    py::object lows,
+    py::object volumes)
+{
+    core::indicators::universe::spec sp = py_indicator_spec(spec);
+    std::vector<py::array_t<double, py::array::c_style | py::array::forcecast>> arrays;
+    core::indicators::universe::series data = py_series(prices, highs, lows, volumes, arrays);
+
+    std::shared_ptr<const std::vector<double>> res = py_nogil([&]
+                                                              { return cache.get(dataset, version, sp, source, data); });
+
+    // the array shares the cached vector, it stays valid after an eviction; read-only as other lookups see it too
+    auto *owner = new std::shared_ptr<const std::vector<double>>(res);
+    py::capsule free_when_done(owner, [](void *p)
+                               { delete static_cast<std::shared_ptr<const std::vector<double>> *>(p); });
+    std::vector<py::ssize_t> shape{(py::ssize_t)res->size()};
+    const py::ssize_t rows = core::indicators::universe::rows(sp.indicator);
+    if (rows > 1)
+        shape = {rows, (py::ssize_t)res->size() / rows};
+    py::array_t<double> arr(shape, res->data(), free_when_done);
+    arr.attr("setflags")(py::arg("write") = false);
+    return arr;
+}
+
+// Stream objects are stateful and unsynchronized, so their methods (`seed` included) keep the GIL: calls on one
+// object from several Python threads never overlap
+template <typename T>
+py::class_<T> py_bind_stream(py::module_ &m, const char *name, const char *doc)
+{
+    return py::class_<T>(m, name, doc)
+        .def("value", &T::value, "Latest value, NaN while warming up")
+        .def("ready", &T::ready, "Whether the warm-up period is over");
+}
+
+template <typename T>
+void py_bind_price_stream(py::class_<T> &cls)
+{
+    cls.def("update", &T::update, "Consume one bar and return the latest value")
+        .def("seed", [](T &self, py::array_t<double, py::array::c_style | py::array::forcecast> prices)
+             {
+                 std::span<const double> p = py_span(prices);
+                 self.seed(p); }, "Replay a price history");
 }
 
 PYBIND11_MODULE(quantzlib, m)
 {
     m.doc() = "Quantlib bindings (SIMD + indicators)";
 
-    m.def("WEIGHTS", &core::indicators::WEIGHTS, "Weights Array");
-    m.def("SMA", &core::indicators::SMA, "Simple Moving Average");
-    m.def("EMA", &core::indicators::EMA, "Exponential Moving Average");
-    m.def("WMA", &core::indicators::WMA, "Weighted Moving Average");
-    m.def("VWMA", &core::indicators::VWMA, "Volume-Weighted Moving Average");
-    m.def("MACD", &core::indicators::MACD, "Moving Average Convergence/Divergence");
-    m.def("RSI", &core::indicators::RSI, "Relative Strength Index");
-    m.def("BollingerBands", &core::indicators::BollingerBands, "Bollinger Bands");
-    m.def("ATR", &core::indicators::ATR, "Average True Range");
-    m.def("Momentum", &core::indicators::Momentum, "Momentum");
-
-    m.def("SIMD_SUM", &py_vector_sum, "SIMD Summation");
-    m.def("SIMD_MEAN", &py_vector_mean, "SIMD Mean");
-    m.def("SIMD_MULTIPLY", &py_vector_multiply, "SIMD Multiplication");
-    m.def("SIMD_VARIANCE", &py_vector_variance, "SIMD Variance");
-    m.def("SIMD_STD_DEVIATION", &py_vector_std_deviation, "SIMD Standard Deviation");
-    m.def("SIMD_DOT_PRODUCT", &py_vector_dot_product, "SIMD Dot Product");
+    m.def("WEIGHTS", &py_WEIGHTS, "Weights Array");
+    m.def("SMA", &py_SMA<double>, "Simple Moving Average", py::arg("prices"), py::arg("n"), py::arg("out") = py::none());
+    m.def("SMA", &py_SMA<float>, "Simple Moving Average", py::arg("prices"), py::arg("n"), py::arg("out") = py::none());
+    m.def("EMA", &py_EMA<double>, "Exponential Moving Average, threads != 1 runs it as a parallel scan", py::arg("prices"), py::arg("n"), py::arg("threads") = 1, py::arg("out") = py::none());
+    m.def("EMA", &py_EMA<float>, "Exponential Moving Average, threads != 1 runs it as a parallel scan", py::arg("prices"), py::arg("n"), py::arg("threads") = 1, py::arg("out") = py::none());
+    m.def("WMA", &py_WMA<double>, "Weighted Moving Average", py::arg("prices"), py::arg("weights"), py::arg("n"), py::arg("out") = py::none());
+    m.def("WMA", &py_WMA<float>, "Weighted Moving Average", py::arg("prices"), py::arg("weights"), py::arg("n"), py::arg("out") = py::none());
+    m.def("VWMA", &py_VWMA<double>, "Volume-Weighted Moving Average", py::arg("prices"), py::arg("volumes"), py::arg("n"), py::arg("out") = py::none());
+    m.def("VWMA", &py_VWMA<float>, "Volume-Weighted Moving Average", py::arg("prices"), py::arg("volumes"), py::arg("n"), py::arg("out") = py::none());
+    m.def("MACD", &py_MACD<double>, "Moving Average Convergence/Divergence", py::arg("prices"), py::arg("fast"), py::arg("slow"), py::arg("out") = py::none());
+    m.def("MACD", &py_MACD<float>, "Moving Average Convergence/Divergence", py::arg("prices"), py::arg("fast"), py::arg("slow"), py::arg("out") = py::none());
+    m.def("RSI", &py_RSI<double>, "Relative Strength Index, threads != 1 runs it as a parallel scan", py::arg("prices"), py::arg("n"), py::arg("threads") = 1, py::arg("out") = py::none());
+    m.def("RSI", &py_RSI<float>, "Relative Strength Index, threads != 1 runs it as a parallel scan", py::arg("prices"), py::arg("n"), py::arg("threads") = 1, py::arg("out") = py::none());
+    m.def("BollingerBands", &py_BollingerBands<double>, "Bollinger Bands (3 x N: middle, upper, lower)", py::arg("prices"), py::arg("n"), py::arg("k"), py::arg("out") = py::none());
+    m.def("BollingerBands", &py_BollingerBands<float>, "Bollinger Bands (3 x N: middle, upper, lower)", py::arg("prices"), py::arg("n"), py::arg("k"), py::arg("out") = py::none());
+    m.def("ATR", &py_ATR<double>, "Average True Range", py::arg("highs"), py::arg("lows"), py::arg("closes"), py::arg("n"), py::arg("out") = py::none());
+    m.def("ATR", &py_ATR<float>, "Average True Range", py::arg("highs"), py::arg("lows"), py::arg("closes"), py::arg("n"), py::arg("out") = py::none());
+    m.def("Momentum", &py_Momentum<double>, "Momentum", py::arg("prices"), py::arg("n"), py::arg("out") = py::none());
+    m.def("Momentum", &py_Momentum<float>, "Momentum", py::arg("prices"), py::arg("n"), py::arg("out") = py::none());
+    m.def("Donchian", &py_Donchian<double>, "Donchian Channels (3 x N: middle, upper, lower)", py::arg("highs"), py::arg("lows"), py::arg("n"), py::arg("out") = py::none());
+    m.def("Donchian", &py_Donchian<float>, "Donchian Channels (3 x N: middle, upper, lower)", py::arg("highs"), py::arg("lows"), py::arg("n"), py::arg("out") = py::none());
+    m.def("Stochastic", &py_Stochastic<double>, "Stochastic Oscillator (2 x N: %K, %D)", py::arg("highs"), py::arg("lows"), py::arg("closes"), py::arg("n"), py::arg("d") = 3, py::arg("out") = py::none());
+    m.def("Stochastic", &py_Stochastic<float>, "Stochastic Oscillator (2 x N: %K, %D)", py::arg("highs"), py::arg("lows"), py::arg("closes"), py::arg("n"), py::arg("d") = 3, py::arg("out") = py::none());
+    m.def("WilliamsR", &py_WilliamsR<double>, "Williams %R", py::arg("highs"), py::arg("lows"), py::arg("closes"), py::arg("n"), py::arg("out") = py::none());
+    m.def("WilliamsR", &py_WilliamsR<float>, "Williams %R", py::arg("highs"), py::arg("lows"), py::arg("closes"), py::arg("n"), py::arg("out") = py::none());
+    m.def("Aroon", &py_Aroon<double>, "Aroon (2 x N: up, down)", py::arg("highs"), py::arg("lows"), py::arg("n"), py::arg("out") = py::none());
+    m.def("Aroon", &py_Aroon<float>, "Aroon (2 x N: up, down)", py::arg("highs"), py::arg("lows"), py::arg("n"), py::arg("out") = py::none());
+    m.def("SMA_multi", &py_SMA_multi, "Simple Moving Average for many periods (periods x N)");
+    m.def("EMA_multi", &py_EMA_multi, "Exponential Moving Average for many periods (periods x N)");
+    m.def("RSI_multi", &py_RSI_multi, "Relative Strength Index for many periods (periods x N)");
+    m.def("Universe", &py_universe, "Indicator specs for many symbols on all cores, returns [symbol][spec] arrays",
+          py::arg("prices"), py::arg("specs"), py::arg("offsets") = py::none(),
+          py::arg("highs") = py::none(), py::arg("lows") = py::none(), py::arg("volumes") = py::none());
+
+    m.def("Pipeline", &py_pipeline, "Indicator specs of one symbol in one pass sharing their common sub-computations, written into `out` when given",
+          py::arg("prices"), py::arg("specs"), py::arg("highs") = py::none(), py::arg("lows") = py::none(),
+          py::arg("volumes") = py::none(), py::arg("out") = py::none());
+
+    py::class_<py_future>(m, "Future", "Result of a task running on the native pool")
+        .def("done", &py_future::done, "Whether the task has finished")
+        .def("wait", &py_future::wait, "Wait (without the GIL) until the task finishes or `timeout` seconds pass, returns done()",
+             py::arg("timeout") = py::none())
+        .def("result", &py_future::result, "Wait for the task and return its result, or raise its error");
+    m.def("IndicatorAsync", &py_indicator_async, "One indicator spec computed on the native pool, returns a Future of its array",
+          py::arg("prices"), py::arg("spec"), py::arg("highs") = py::none(), py::arg("lows") = py::none(),
+          py::arg("volumes") = py::none());
+
+    m.def("SIMD_SUM", &py_vector_sum<double>, "SIMD Summation", py::arg("arr"), py::arg("threads") = 0);
+    m.def("SIMD_SUM", &py_vector_sum<float>, "SIMD Summation", py::arg("arr"), py::arg("threads") = 0);
+    m.def("SIMD_MEAN", &py_vector_mean<double>, "SIMD Mean", py::arg("arr"), py::arg("threads") = 0);
+    m.def("SIMD_MEAN", &py_vector_mean<float>, "SIMD Mean", py::arg("arr"), py::arg("threads") = 0);
+    m.def("SIMD_MULTIPLY", &py_vector_multiply<double>, "SIMD Multiplication", py::arg("arr"), py::arg("threads") = 0);
+    m.def("SIMD_MULTIPLY", &py_vector_multiply<float>, "SIMD Multiplication", py::arg("arr"), py::arg("threads") = 0);
+    m.def("SIMD_VARIANCE", &py_vector_variance<double>, "SIMD Variance", py::arg("arr"), py::arg("threads") = 0);
+    m.def("SIMD_VARIANCE", &py_vector_variance<float>, "SIMD Variance", py::arg("arr"), py::arg("threads") = 0);
+    m.def("SIMD_STD_DEVIATION", &py_vector_std_deviation<double>, "SIMD Standard Deviation", py::arg("arr"), py::arg("threads") = 0);
+    m.def("SIMD_STD_DEVIATION", &py_vector_std_deviation<float>, "SIMD Standard Deviation", py::arg("arr"), py::arg("threads") = 0);
+    m.def("SIMD_DOT_PRODUCT", &py_vector_dot_product<double>, "SIMD Dot Product", py::arg("a"), py::arg("b"), py::arg("threads") = 0);
+    m.def("SIMD_DOT_PRODUCT", &py_vector_dot_product<float>, "SIMD Dot Product", py::arg("a"), py::arg("b"), py::arg("threads") = 0);
+    m.def("SIMD_MODE", &simd_mode, "Vector width (\"512\", \"256\" or \"128\") of the kernels selected at load time");
+
+    namespace stream = core::indicators::stream;
+    py::module_ sm = m.def_submodule("stream", "Incremental indicators for live data, equal to the batch functions on the same bars");
+
+    auto sma = py_bind_stream<stream::SMA>(sm, "SMA", "Simple Moving Average").def(py::init<std::size_t>(), py::arg("n"));
+    py_bind_price_stream(sma);
+    auto ema = py_bind_stream<stream::EMA>(sm, "EMA", "Exponential Moving Average").def(py::init<std::size_t>(), py::arg("n"));
+    py_bind_price_stream(ema);
+    auto macd = py_bind_stream<stream::MACD>(sm, "MACD", "Moving Average Convergence/Divergence").def(py::init<std::size_t, std::size_t>(), py::arg("fast"), py::arg("slow"));
+    py_bind_price_stream(macd);
+    auto rsi = py_bind_stream<stream::RSI>(sm, "RSI", "Relative Strength Index").def(py::init<std::size_t>(), py::arg("n"));
+    py_bind_price_stream(rsi);
+    auto momentum = py_bind_stream<stream::Momentum>(sm, "Momentum", "Momentum").def(py::init<std::size_t>(), py::arg("n"));
+    py_bind_price_stream(momentum);
+    auto bb = py_bind_stream<stream::BollingerBands>(sm, "BollingerBands", "Bollinger Bands, value() is the middle band")
+                  .def(py::init<std::size_t, double>(), py::arg("n"), py::arg("k"))
+                  .def("upper", &stream::BollingerBands::upper, "Upper band")
+                  .def("lower", &stream::BollingerBands::lower, "Lower band");
+    py_bind_price_stream(bb);
+
+    py_bind_stream<stream::VWMA>(sm, "VWMA", "Volume-Weighted Moving Average")
+        .def(py::init<std::size_t>(), py::arg("n"))
+        .def("update", &stream::VWMA::update, py::arg("price"), py::arg("volume"), "Consume one bar and return the latest value")
+        .def("seed", [](stream::VWMA &self, py::array_t<double, py::array::c_style | py::array::forcecast> prices, py::array_t<double, py::array::c_style | py::array::forcecast> volumes)
+             {
+                 std::span<const double> p = py_span(prices), v = py_span(volumes);
+                 self.seed(p, v); }, "Replay a price/volume history");
+
+    py_bind_stream<stream::ATR>(sm, "ATR", "Average True Range")
+        .def(py::init<std::size_t>(), py::arg("n"))
+        .def("update", &stream::ATR::update, py::arg("high"), py::arg("low"), py::arg("close"), "Consume one bar and return the latest value")
+        .def("seed", [](stream::ATR &self, py::array_t<double, py::array::c_style | py::array::forcecast> highs, py::array_t<double, py::array::c_style | py::array::forcecast> lows, py::array_t<double, py::array::c_style | py::array::forcecast> closes)
+             {
+                 std::span<const double> h = py_span(highs), l = py_span(lows), c = py_span(closes);
+                 self.seed(h, l, c); }, "Replay a high/low/close history");
+
+    py_bind_stream<stream::Donchian>(sm, "Donchian", "Donchian Channels, value() is the middle line")
+        .def(py::init<std::size_t>(), py::arg("n"))
+        .def("upper", &stream::Donchian::upper, "Highest high")
+        .def("lower", &stream::Donchian::lower, "Lowest low")
+        .def("update", &stream::Donchian::update, py::arg("high"), py::arg("low"), "Consume one bar and return the latest value")
+        .def("seed", [](stream::Donchian &self, py::array_t<double, py::array::c_style | py::array::forcecast> highs, py::array_t<double, py::array::c_style | py::array::forcecast> lows)
+             {
+                 std::span<const double> h = py_span(highs), l = py_span(lows);
+                 self.seed(h, l); }, "Replay a high/low history");
+
+    py_bind_stream<stream::Stochastic>(sm, "Stochastic", "Stochastic Oscillator, value() is %K")
+        .def(py::init<std::size_t, std::size_t>(), py::arg("n"), py::arg("d") = 3)
+        .def("d", &stream::Stochastic::d, "%D, the SMA of %K")
+        .def("update", &stream::Stochastic::update, py::arg("high"), py::arg("low"), py::arg("close"), "Consume one bar and return the latest value")
+        .def("seed", [](stream::Stochastic &self, py::array_t<double, py::array::c_style | py::array::forcecast> highs, py::array_t<double, py::array::c_style | py::array::forcecast> lows, py::array_t<double, py::array::c_style | py::array::forcecast> closes)
+             {
+                 std::span<const double> h = py_span(highs), l = py_span(lows), c = py_span(closes);
+                 self.seed(h, l, c); }, "Replay a high/low/close history");
+
+    py_bind_stream<stream::WilliamsR>(sm, "WilliamsR", "Williams %R")
+        .def(py::init<std::size_t>(), py::arg("n"))
+        .def("update", &stream::WilliamsR::update, py::arg("high"), py::arg("low"), py::arg("close"), "Consume one bar and return the latest value")
+        .def("seed", [](stream::WilliamsR &self, py::array_t<double, py::array::c_style | py::array::forcecast> highs, py::array_t<double, py::array::c_style | py::array::forcecast> lows, py::array_t<double, py::array::c_style | py::array::forcecast> closes)
+             {
+                 std::span<const double> h = py_span(highs), l = py_span(lows), c = py_span(closes);
+                 self.seed(h, l, c); }, "Replay a high/low/close history");
+
+    py_bind_stream<stream::Aroon>(sm, "Aroon", "Aroon, value() is Aroon up")
+        .def(py::init<std::size_t>(), py::arg("n"))
+        .def("down", &stream::Aroon::down, "Aroon down")
+        .def("update", &stream::Aroon::update, py::arg("high"), py::arg("low"), "Consume one bar and return the latest value")
+        .def("seed", [](stream::Aroon &self, py::array_t<double, py::array::c_style | py::array::forcecast> highs, py::array_t<double, py::array::c_style | py::array::forcecast> lows)
+             {
+                 std::span<const double> h = py_span(highs), l = py_span(lows);
+                 self.seed(h, l); }, "Replay a high/low history");
+
+    py::class_<core::indicators::result_cache>(m, "IndicatorCache", "Indicator results keyed by (dataset, version, spec, source) with an LRU memory budget")
+        .def(py::init<std::size_t>(), py::arg("budget_bytes"))
+        .def("get", &py_cache_get, "Cached indicator of the data (read-only array), computed or extended when needed",
+             py::arg("dataset"), py::arg("version"), py::arg("spec"), py::arg("source"), py::arg("prices"),
+             py::arg("highs") = py::none(), py::arg("lows") = py::none(), py::arg("volumes") = py::none())
+        .def("appended", &core::indicators::result_cache::appended, "Declare that version `to` only appends bars to version `from`",
+             py::arg("dataset"), py::arg("from"), py::arg("to"))
+        .def("set_budget", &core::indicators::result_cache::set_budget, py::arg("budget_bytes"))
+        .def("clear", &core::indicators::result_cache::clear)
+        .def("stats", [](const core::indicators::result_cache &c)
+             {
+                 core::indicators::result_cache::stats st = c.statistics();
+                 py::dict d;
+                 d["hits"] = st.hits;
+                 d["misses"] = st.misses;
+                 d["extensions"] = st.extensions;
+                 d["evictions"] = st.evictions;
+                 d["entries"] = st.entries;
+                 d["bytes"] = st.bytes;
+                 return d; });
+
+    m.def("ReadCSV", &py_read_csv, "Parse a broker CSV export (bytes or str) in parallel, returns its recognized columns",
+          py::arg("data"), py::arg("reverse") = true);
+    m.def("ReadCSVFile", &py_read_csv_file, "Map and parse a broker CSV export file in parallel, returns its recognized columns",
+          py::arg("path"), py::arg("reverse") = true);
+    using core::store::field;
+    m.def("StoreWrite", &py_store_write, "Write OHLCV columns (dates as days since 1970-01-01) to a columnar store file",
+          py::arg("path"), py::arg("symbol"), py::arg("dates"),
+          py::arg("open") = py::none(), py::arg("high") = py::none(), py::arg("low") = py::none(),
+          py::arg("close") = py::none(), py::arg("volume") = py::none());
+    py::class_<core::store::mapped>(m, "Store", "Memory-mapped columnar store file, columns are zero-copy read-only arrays")
+        .def(py::init([](const std::string &path)
+                      {
+                          auto s = std::make_unique<core::store::mapped>(path);
+                          if (!s->ok())
+                          {
+                              throw std::runtime_error("Not a QuantZ store file: " + path);
+                          }
+                          return s; }),
+             py::arg("path"))
+        .def_property_readonly("rows", &core::store::mapped::rows)
+        .def_property_readonly("symbol", [](const core::store::mapped &s)
+                               { return std::string(s.symbol()); })
+        .def_property_readonly("date", [](py::object self)
+                               { return py_store_column(self, self.cast<const core::store::mapped &>().view().date).attr("view")("datetime64[D]"); })
+        .def_property_readonly("open", [](py::object self)
+                               { return py_store_column(self, self.cast<const core::store::mapped &>().view()[field::OPEN]); })
+        .def_property_readonly("high", [](py::object self)
+                               { return py_store_column(self, self.cast<const core::store::mapped &>().view()[field::HIGH]); })
+        .def_property_readonly("low", [](py::object self)
+                               { return py_store_column(self, self.cast<const core::store::mapped &>().view()[field::LOW]); })
+        .def_property_readonly("close", [](py::object self)
+                               { return py_store_column(self, self.cast<const core::store::mapped &>().view()[field::CLOSE]); })
+        .def_property_readonly("volume", [](py::object self)
+                               { return py_store_column(self, self.cast<const core::store::mapped &>().view()[field::VOLUME]); });
+
+    m.def("AggregateTicks", &py_aggregate_ticks, "Aggregate (time, price, size) ticks into time, tick, volume or dollar bars, returns their columns",
+          py::arg("times"), py::arg("prices"), py::arg("sizes"), py::arg("by") = "time", py::arg("threshold") = 60.0, py::arg("flush") = true);
+    py::class_<core::bars::aggregator>(m, "BarAggregator", "Incremental tick-to-bar aggregation, closed bars are pushed to the subscribers")
+        .def(py::init([](const std::string &by, double threshold)
+                      {
+                          const core::bars::rule r = py_bar_rule(by);
+                          py_check_bar_interval(r, threshold);
+                          return std::make_unique<core::bars::aggregator>(r, threshold); }),
+             py::arg("by"), py::arg("threshold"))
+        .def("update", py::overload_cast<const std::int64_t &, const double &, const double &>(&core::bars::aggregator::update),
+             py::arg("time"), py::arg("price"), py::arg("size"), "Add one tick, returns whether a bar was closed")
+        .def("update_many", [](core::bars::aggregator &self, py::array_t<std::int64_t, py::array::c_style | py::array::forcecast> times, py::array_t<double, py::array::c_style | py::array::forcecast> prices, py::array_t<double, py::array::c_style | py::array::forcecast> sizes)
+             { return self.update(py_span(times), py_span(prices), py_span(sizes)); }, py::arg("times"), py::arg("prices"), py::arg("sizes"), "Add many ticks, returns the number of bars closed")
+        .def("flush", &core::bars::aggregator::flush, "Close the bar in progress")
+        .def("subscribe", [](core::bars::aggregator &self, py::function consumer)
+             { self.subscribe([consumer](const core::bars::bar &b)
+                              { consumer(py_bar(b)); }); }, py::arg("consumer"), "Call `consumer(bar)` with every bar closed from now on")
+        .def_property_readonly("partial", [](const core::bars::aggregator &self)
+                               { return self.partial().ticks ? py::object(py_bar(self.partial())) : py::object(py::none()); })
+        .def_property_readonly("rows", [](const core::bars::aggregator &self)
+                               { return self.bars().size(); })
+        .def("take", [](core::bars::aggregator &self)
+             { return py_bar_columns(self.take()); }, "Hand the closed bars over as columns and start a new table");
+
+    m.def("Signals", &py_signals, "Compile the strategy DAG and evaluate it over every bar (1 = Buy, -1 = Sell, 0 = None)");
+    m.def("Backtest", &py_backtest, "Run the strategy DAG and position state machine over every bar");
+    m.def("BacktestAsync", &py_backtest_async, "Backtest on the native pool, returns a Future of its result",
+          py::arg("closes"), py::arg("dag_json"), py::arg("indicator_columns"), py::arg("initial_capital"),
+          py::arg("allocation_fraction"), py::arg("commission"));
+    m.def("Metrics", &py_metrics, "Total return, Sharpe, Sortino, max drawdown and its duration, win rate and profit factor of an equity curve and its trade PnL, in one pass",
+          py::arg("equity"), py::arg("pnl") = py::none());
+    m.def("EquityCurves", &py_equity_curves, "Bar returns, running peak and drawdown of an equity curve", py::arg("equity"));
+    m.def("RollingMetrics", &py_rolling_metrics, "Sharpe, Sortino and annualized volatility over a trailing window of bar returns",
+          py::arg("equity"), py::arg("window") = 252);
+    m.def("Optimize", &py_optimize, "Grid or random search over strategy parameters on all cores, returns the top-k candidates",
+          py::arg("data"), py::arg("dag_json"), py::arg("parameters"),
+          py::arg("initial_capital"), py::arg("allocation_fraction"), py::arg("commission"),
+          py::arg("method") = "grid", py::arg("samples") = 1000, py::arg("seed") = 0,
+          py::arg("top_k") = 10, py::arg("rank") = "sharpe");
+    m.def("LiveReplay", &py_live_replay, "Replay recorded bars or ticks through the live pipeline (ring, streaming indicators, strategy) at a given speed, returns signals and latency percentiles",
+          py::arg("source"), py::arg("dag_json"), py::arg("speed") = 0.0, py::arg("capacity") = 65536,
+          py::arg("ticks") = false, py::arg("by") = "time", py::arg("threshold") = 60.0);
 }
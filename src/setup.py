@@ -13,7 +13,21 @@ ext_modules = [
         [
             "./setup.cc",
             "./core/simd_math/simd_math.c",
+            "./core/simd_math/parallel.cc",
             "./core/indicators/indicators.cc",
+            "./core/indicators/stream.cc",
+            "./core/indicators/universe.cc",
+            "./core/indicators/cache.cc",
+            "./core/indicators/pipeline.cc",
+            "./core/indicators/scan.cc",
+            "./core/thread_pool/thread_pool.cc",
+            "./core/strategy/strategy.cc",
+            "./core/backtest/backtest.cc",
+            "./core/optimizer/optimizer.cc",
+            "./core/store/store.cc",
+            "./core/ingest/ingest.cc",
+            "./core/bars/bars.cc",
+            "./core/live/live.cc",
         ],
         include_dirs=[
             pybind11.get_include(),
@@ -21,9 +35,19 @@ ext_modules = [
             sysconfig.get_paths()["include"],
             "./core/simd_math",
             "./core/indicators",
+            "./core/strategy",
+            "./core/backtest",
+            "./core/thread_pool",
+            "./core/optimizer",
+            "./core/store",
+            "./core/ingest",
+            "./core/bars",
+            "./core/live",
         ],
         language="c++",
-        extra_compile_args=["-std=c++20", "-mfma"],
+        # no -m ISA flags: simd_math picks AVX-512/AVX2/SSE2 kernels at load time
+        extra_compile_args=["-std=c++20", "-pthread"],
+        extra_link_args=["-pthread"],
     )
 ]
 
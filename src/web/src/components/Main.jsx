@@ -17,7 +17,11 @@ const INDICATORS = {
     "RSI": { "Price": "Select", "Period": "number" },
     "BollingerBands": { "Price": "Select", "Period": "number", "Multiplier": "float" },
     "ATR": { "Price": "Select", "Period": "number" },
-    "Momentum": { "Price": "Select", "Period": "number" }
+    "Momentum": { "Price": "Select", "Period": "number" },
+    "Donchian": { "Period": "number", "Line": "Select" },
+    "Stochastic": { "Price": "Select", "Period": "number", "Smoothing": "number" },
+    "WilliamsR": { "Price": "Select", "Period": "number" },
+    "Aroon": { "Period": "number", "Line": "Select" }
 };
 const INDICATORS_SELECT_OPTIONS = {
     "SMA": { "Price": ["Open", "Low", "High", "Close"] },
@@ -28,7 +32,11 @@ const INDICATORS_SELECT_OPTIONS = {
     "RSI": { "Price": ["Open", "Low", "High", "Close"] },
     "BollingerBands": { "Price": ["Open", "Low", "High", "Close"] },
     "ATR": { "Price": ["Open", "Low", "High", "Close"] },
-    "Momentum": { "Price": ["Open", "Low", "High", "Close"] }
+    "Momentum": { "Price": ["Open", "Low", "High", "Close"] },
+    "Donchian": { "Line": ["Middle", "Upper", "Lower"] },
+    "Stochastic": { "Price": ["Open", "Low", "High", "Close"] },
+    "WilliamsR": { "Price": ["Open", "Low", "High", "Close"] },
+    "Aroon": { "Line": ["Up", "Down"] }
 }
 const OPERATORS = ["Equals To (=)", "Not Equals To (≠)", "Less Than (<)", "More Than (>)", "Less Than or Equals To (≤)", "More Than or Equals To (≥)"];
 const LOGIC = ["TRUE", "FALSE"]